@@ -0,0 +1,575 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+/*
+ *	An accuracy-versus-cost harness of the parallel Monte Carlo engine. For each
+ *	sampling strategy and number of iterations, it runs the conversion with several
+ *	seeds, and writes the median time of a run and the 1-Wasserstein distance of
+ *	its output samples to a reference distribution, so that the cheapest `-M` that
+ *	meets an error budget can be read off the curves. The reference is the exact
+ *	output distribution, or the samples of a single long run (`-R`). The application
+ *	is included as a whole, as in the micro-benchmarks, to reuse its kernel.
+ */
+#include <errno.h>
+#include <unistd.h>
+#define main	tmcsApplicationMain
+#include "main.c"
+#undef main
+
+typedef enum
+{
+	kAccuracyBenchmarkConstantDefaultReplicates	= 11,
+	kAccuracyBenchmarkConstantDefaultThreads	= 1,
+	kAccuracyBenchmarkConstantMaxIterationCounts	= 32,
+} AccuracyBenchmarkConstant;
+
+/*
+ *	The sampling strategies, named after the values of the `-m` and `-r` options
+ *	of the application.
+ */
+typedef struct
+{
+	const char *		name;
+	SamplingMethod		samplingMethod;
+	RandomGenerator		randomGenerator;
+} AccuracyBenchmarkStrategy;
+
+static const AccuracyBenchmarkStrategy	kAccuracyBenchmarkStrategies[] =
+					{
+						{ "random", kSamplingMethodPseudoRandom, kRandomGeneratorXoshiro },
+						{ "philox", kSamplingMethodPseudoRandom, kRandomGeneratorPhilox },
+						{ "sobol", kSamplingMethodSobol, kRandomGeneratorXoshiro },
+						{ "lhs", kSamplingMethodLatinHypercube, kRandomGeneratorXoshiro },
+					};
+
+enum
+{
+	kAccuracyBenchmarkConstantNumberOfStrategies	= sizeof(kAccuracyBenchmarkStrategies) / sizeof(kAccuracyBenchmarkStrategies[0]),
+};
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *)a;
+	double	y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ *	@brief	Run `iterations` iterations of the conversion with a sampling strategy, as the
+ *		application does with `-t`, `-m` and `-r`.
+ *
+ *	@param	pool		: The thread pool to run on.
+ *	@param	blockContext	: The kernel context, with its kernels, sensor variant and error model set.
+ *	@param	strategy	: The sampling strategy.
+ *	@param	iterations	: The number of iterations.
+ *	@param	seed		: The seed of the run.
+ *	@param	samples		: Where to write the `iterations` output samples.
+ *	@param	nanoseconds	: Where to write the time of the run, including the set-up of its point set.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+runConversion(
+	ThreadPool *				pool,
+	MonteCarloBlockContext *		blockContext,
+	const AccuracyBenchmarkStrategy *	strategy,
+	size_t					iterations,
+	uint64_t				seed,
+	double *				samples,
+	uint64_t *				nanoseconds)
+{
+	QuasiRandomSequence	quasiRandomSequence;
+	PhiloxKey		philoxKey;
+	uint64_t		start = readMonotonicNanoseconds();
+	MonteCarloRun		run =
+				{
+					.numberOfIterations = iterations,
+					.firstIteration = 0,
+					.seed = seed,
+					.kernel = evaluateMonteCarloBlock,
+					.kernelContext = blockContext,
+					.outputSamples = samples,
+					.summary = NULL,
+					.sliceStatistics = NULL,
+				};
+
+	blockContext->quasiRandomSequence = NULL;
+	blockContext->philoxKey = NULL;
+	if (strategy->samplingMethod != kSamplingMethodPseudoRandom)
+	{
+		if (initializeQuasiRandomSequence(&quasiRandomSequence, strategy->samplingMethod, iterations, seed) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+		blockContext->quasiRandomSequence = &quasiRandomSequence;
+	}
+	if (strategy->randomGenerator == kRandomGeneratorPhilox)
+	{
+		seedPhiloxKey(&philoxKey, seed);
+		blockContext->philoxKey = &philoxKey;
+	}
+
+	run.isRandomStreamUnused = isMonteCarloBlockRandomStreamUnused(blockContext);
+	runParallelMonteCarlo(pool, &run);
+	*nanoseconds = readMonotonicNanoseconds() - start;
+
+	blockContext->quasiRandomSequence = NULL;
+	blockContext->philoxKey = NULL;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief	Calculate the 1-Wasserstein distance of a sample set to an exact distribution,
+ *		the integral of |Q_n(u) - Q(u)| over [0, 1], where the quantile function Q_n of
+ *		the samples is `sortedSamples[i]` over [i / n, (i + 1) / n). Each interval is
+ *		integrated exactly, splitting it where Q(u) crosses the sample.
+ *
+ *	@param	distribution	: The exact distribution.
+ *	@param	sortedSamples	: The samples, in ascending order.
+ *	@param	numberOfSamples	: The number of samples.
+ *	@return			: The distance, in the unit of the samples.
+ */
+static double
+calculateWassersteinDistanceToTrapezoid(const TrapezoidalDistribution *  distribution, const double *  sortedSamples, size_t numberOfSamples)
+{
+	double	distance = 0.0;
+	double	integralToLow = 0.0;
+
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		double	x = sortedSamples[i];
+		double	low = (double)i / (double)numberOfSamples;
+		double	high = (double)(i + 1) / (double)numberOfSamples;
+		double	crossing = fmin(fmax(trapezoidalDistributionCDF(distribution, x), low), high);
+		double	integralToCrossing = trapezoidalDistributionQuantileIntegral(distribution, crossing);
+		double	integralToHigh = trapezoidalDistributionQuantileIntegral(distribution, high);
+
+		distance += x * (crossing - low) - (integralToCrossing - integralToLow) +
+				(integralToHigh - integralToCrossing) - x * (high - crossing);
+		integralToLow = integralToHigh;
+	}
+
+	return distance;
+}
+
+/**
+ *	@brief	Calculate the 1-Wasserstein distance of two sample sets, the integral of the
+ *		absolute difference of their empirical CDFs, by merging them.
+ *
+ *	@param	sortedSamples		: The samples, in ascending order.
+ *	@param	numberOfSamples		: The number of samples.
+ *	@param	sortedReference		: The reference samples, in ascending order.
+ *	@param	numberOfReferenceSamples: The number of reference samples.
+ *	@return				: The distance, in the unit of the samples.
+ */
+static double
+calculateWassersteinDistanceToSamples(
+	const double *	sortedSamples,
+	size_t		numberOfSamples,
+	const double *	sortedReference,
+	size_t		numberOfReferenceSamples)
+{
+	double	distance = 0.0;
+	double	current = fmin(sortedSamples[0], sortedReference[0]);
+	size_t	i = 0;
+	size_t	j = 0;
+
+	while ((i < numberOfSamples) || (j < numberOfReferenceSamples))
+	{
+		bool	isSampleNext = (j == numberOfReferenceSamples) || ((i < numberOfSamples) && (sortedSamples[i] <= sortedReference[j]));
+		double	next = isSampleNext ? sortedSamples[i] : sortedReference[j];
+
+		distance += fabs((double)i / (double)numberOfSamples - (double)j / (double)numberOfReferenceSamples) * (next - current);
+		current = next;
+		if (isSampleNext)
+		{
+			i++;
+		}
+		else
+		{
+			j++;
+		}
+	}
+
+	return distance;
+}
+
+/**
+ *	@brief	Parse a comma-separated list of positive integers.
+ *
+ *	@param	list		: The list.
+ *	@param	values		: Where to write the values, with room for `maxValues`.
+ *	@param	maxValues	: The maximum number of values.
+ *	@param	numberOfValues	: Where to write the number of values.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseIterationCounts(const char *  list, size_t *  values, size_t maxValues, size_t *  numberOfValues)
+{
+	const char *	current = list;
+
+	*numberOfValues = 0;
+	for (;;)
+	{
+		char *			end;
+		unsigned long long	value;
+
+		errno = 0;
+		value = strtoull(current, &end, 0);
+		if ((end == current) || (errno != 0) || (value == 0) || (value > kQuasiRandomSequenceMaxPoints) ||
+			(*numberOfValues == maxValues) || ((*end != ',') && (*end != '\0')))
+		{
+			fprintf(stderr, "Error: The iteration counts (-M option) should be at most %zu positive integers, separated by `,`: Provided %s.\n", maxValues, list);
+
+			return kCommonConstantReturnTypeError;
+		}
+		values[(*numberOfValues)++] = (size_t)value;
+		if (*end == '\0')
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+		current = end + 1;
+	}
+}
+
+/**
+ *	@brief	Parse a comma-separated list of sampling strategies.
+ *
+ *	@param	list		: The list.
+ *	@param	isSelected	: Where to mark each strategy of `kAccuracyBenchmarkStrategies` in the list.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+static CommonConstantReturnType
+parseStrategies(const char *  list, bool *  isSelected)
+{
+	const char *	current = list;
+
+	memset(isSelected, 0, kAccuracyBenchmarkConstantNumberOfStrategies * sizeof(bool));
+	for (;;)
+	{
+		size_t	length = strcspn(current, ",");
+		size_t	s;
+
+		for (s = 0; s < kAccuracyBenchmarkConstantNumberOfStrategies; s++)
+		{
+			if ((strlen(kAccuracyBenchmarkStrategies[s].name) == length) &&
+				(strncmp(kAccuracyBenchmarkStrategies[s].name, current, length) == 0))
+			{
+				isSelected[s] = true;
+				break;
+			}
+		}
+		if (s == kAccuracyBenchmarkConstantNumberOfStrategies)
+		{
+			fprintf(stderr, "Error: The sampling strategies (-m option) should be among `random`, `philox`, `sobol` and `lhs`: Provided %s.\n", list);
+
+			return kCommonConstantReturnTypeError;
+		}
+		if (current[length] == '\0')
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+		current += length + 1;
+	}
+}
+
+static void
+printAccuracyBenchmarkUsage(const char *  name)
+{
+	fprintf(
+		stderr,
+		"Usage: %s [-M <iterations,...>] [-m <strategy,...>] [-r <replicates>] [-t <threads>] [-d <variant>] [-s <seed>]\n"
+		"\t[-e <lowest temperature>,<highest temperature>] [-R <reference iterations>] [-b <error budget>] [-o <output CSV>]\n",
+		name);
+
+	return;
+}
+
+int
+main(int argc, char *  argv[])
+{
+	size_t				iterationCounts[kAccuracyBenchmarkConstantMaxIterationCounts] =
+					{
+						1 << 8, 1 << 10, 1 << 12, 1 << 14, 1 << 16, 1 << 18, 1 << 20,
+					};
+	size_t				numberOfIterationCounts = 7;
+	bool				isStrategySelected[kAccuracyBenchmarkConstantNumberOfStrategies] = { true, true, true, true };
+	size_t				numberOfReplicates = kAccuracyBenchmarkConstantDefaultReplicates;
+	size_t				numberOfThreads = kAccuracyBenchmarkConstantDefaultThreads;
+	const SensorVariant *		sensorVariant = &kSensorVariants[kSensorVariantIndexTMCS1123x3A];
+	uint64_t			seed = kDefaultMonteCarloSeed;
+	const char *			errorModelTemperatures = NULL;
+	SensorErrorModel		errorModel;
+	size_t				numberOfReferenceSamples = 0;
+	double				errorBudget = 0.0;
+	FILE *				outputFile = stdout;
+	size_t				maxIterations = 0;
+	TrapezoidalDistribution		exactDistribution;
+	MonteCarloBlockContext		blockContext = {0};
+	ThreadPool *			pool;
+	double *			samples;
+	double *			referenceSamples = NULL;
+	double *			distances;
+	double *			microseconds;
+	int				option;
+	int				returnValue = kCommonConstantReturnTypeSuccess;
+
+	while ((option = getopt(argc, argv, "M:m:r:t:d:s:e:R:b:o:")) != -1)
+	{
+		switch (option)
+		{
+			case 'M':
+				if (parseIterationCounts(optarg, iterationCounts, kAccuracyBenchmarkConstantMaxIterationCounts, &numberOfIterationCounts) != kCommonConstantReturnTypeSuccess)
+				{
+					return kCommonConstantReturnTypeError;
+				}
+				break;
+			case 'm':
+				if (parseStrategies(optarg, isStrategySelected) != kCommonConstantReturnTypeSuccess)
+				{
+					return kCommonConstantReturnTypeError;
+				}
+				break;
+			case 'r':
+				numberOfReplicates = strtoull(optarg, NULL, 0);
+				break;
+			case 't':
+				numberOfThreads = strtoull(optarg, NULL, 0);
+				break;
+			case 'd':
+				sensorVariant = findSensorVariant(optarg);
+				if (sensorVariant == NULL)
+				{
+					fprintf(stderr, "Error: Unknown sensor variant %s.\n", optarg);
+
+					return kCommonConstantReturnTypeError;
+				}
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 0);
+				break;
+			case 'e':
+				errorModelTemperatures = optarg;
+				break;
+			case 'R':
+				numberOfReferenceSamples = strtoull(optarg, NULL, 0);
+				break;
+			case 'b':
+				errorBudget = strtod(optarg, NULL);
+				break;
+			case 'o':
+				if (outputFile != stdout)
+				{
+					fclose(outputFile);
+				}
+				outputFile = fopen(optarg, "w");
+				if (outputFile == NULL)
+				{
+					fprintf(stderr, "Error: Could not open %s for writing.\n", optarg);
+
+					return kCommonConstantReturnTypeError;
+				}
+				break;
+			default:
+				printAccuracyBenchmarkUsage(argv[0]);
+
+				return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if ((optind != argc) || (numberOfReplicates == 0) || (numberOfThreads == 0) || !(errorBudget >= 0.0))
+	{
+		printAccuracyBenchmarkUsage(argv[0]);
+		fprintf(stderr, "The number of replicates and of threads should be positive, and the error budget non-negative.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	As in the application, the error terms of the extended error model are drawn
+	 *	from the pseudo-random lane streams, and the exact distribution only covers
+	 *	the Vout and Vref inputs.
+	 */
+	if (errorModelTemperatures != NULL)
+	{
+		double	temperatureLow;
+		double	temperatureHigh;
+		bool	isOnlyRandomSelected = isStrategySelected[0];
+
+		if ((sscanf(errorModelTemperatures, "%lf,%lf", &temperatureLow, &temperatureHigh) != 2) || !(temperatureHigh >= temperatureLow))
+		{
+			fprintf(stderr, "Error: The error model (-e option) should be the lowest ambient temperature, followed by `,` and the highest, in °C.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+		for (size_t s = 1; s < kAccuracyBenchmarkConstantNumberOfStrategies; s++)
+		{
+			isOnlyRandomSelected = isOnlyRandomSelected && !isStrategySelected[s];
+		}
+		if (!isOnlyRandomSelected || (numberOfReferenceSamples == 0))
+		{
+			fprintf(stderr, "Error: The error model (-e option) requires the `random` strategy alone (-m random) and a sampled reference (-R).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+		initializeSensorErrorModel(&errorModel, sensorVariant, temperatureLow, temperatureHigh);
+		blockContext.errorModel = &errorModel;
+	}
+
+	blockContext.kernels = selectConversionKernels(kConversionKernelIsaAutomatic);
+	blockContext.sensorVariant = sensorVariant;
+	exactDistribution = makeCalibratedOutputDistribution(
+				kDefaultInputDistributionVoutUniformDistLow,
+				kDefaultInputDistributionVoutUniformDistHigh,
+				kDefaultInputDistributionVrefUniformDistLow,
+				kDefaultInputDistributionVrefUniformDistHigh,
+				sensorVariant->sensitivity);
+
+	if (createThreadPool(numberOfThreads, &pool) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t k = 0; k < numberOfIterationCounts; k++)
+	{
+		maxIterations = (iterationCounts[k] > maxIterations) ? iterationCounts[k] : maxIterations;
+	}
+
+	/*
+	 *	Touch the sample array before the timed runs, so that they do not pay for its page faults.
+	 */
+	samples = checkedMalloc(maxIterations * sizeof(double), __FILE__, __LINE__);
+	memset(samples, 0, maxIterations * sizeof(double));
+	distances = checkedMalloc(numberOfReplicates * sizeof(double), __FILE__, __LINE__);
+	microseconds = checkedMalloc(numberOfReplicates * sizeof(double), __FILE__, __LINE__);
+
+	/*
+	 *	The reference run draws pseudo-random samples from the seed itself, and the
+	 *	replicates from the seeds that follow it, so that they are independent.
+	 */
+	if (numberOfReferenceSamples > 0)
+	{
+		uint64_t	nanoseconds;
+
+		referenceSamples = checkedMalloc(numberOfReferenceSamples * sizeof(double), __FILE__, __LINE__);
+		runConversion(pool, &blockContext, &kAccuracyBenchmarkStrategies[0], numberOfReferenceSamples, seed, referenceSamples, &nanoseconds);
+		qsort(referenceSamples, numberOfReferenceSamples, sizeof(double), compareDoubles);
+	}
+
+	fprintf(outputFile, "strategy,iterations,replicates,medianMicroseconds,meanWassersteinDistance,p95WassersteinDistance\n");
+	for (size_t s = 0; (s < kAccuracyBenchmarkConstantNumberOfStrategies) && (returnValue == kCommonConstantReturnTypeSuccess); s++)
+	{
+		bool	isBudgetMet = false;
+
+		if (!isStrategySelected[s])
+		{
+			continue;
+		}
+
+		for (size_t k = 0; k < numberOfIterationCounts; k++)
+		{
+			double	meanDistance = 0.0;
+			double	medianMicroseconds;
+			double	p95Distance;
+
+			for (size_t r = 0; r < numberOfReplicates; r++)
+			{
+				uint64_t	nanoseconds;
+
+				if (runConversion(pool, &blockContext, &kAccuracyBenchmarkStrategies[s], iterationCounts[k], seed + 1 + r, samples, &nanoseconds) != kCommonConstantReturnTypeSuccess)
+				{
+					returnValue = kCommonConstantReturnTypeError;
+					break;
+				}
+				microseconds[r] = (double)nanoseconds / 1e3;
+
+				qsort(samples, iterationCounts[k], sizeof(double), compareDoubles);
+				distances[r] = (referenceSamples != NULL) ?
+						calculateWassersteinDistanceToSamples(samples, iterationCounts[k], referenceSamples, numberOfReferenceSamples) :
+						calculateWassersteinDistanceToTrapezoid(&exactDistribution, samples, iterationCounts[k]);
+				meanDistance += distances[r] / (double)numberOfReplicates;
+			}
+			if (returnValue != kCommonConstantReturnTypeSuccess)
+			{
+				break;
+			}
+
+			qsort(microseconds, numberOfReplicates, sizeof(double), compareDoubles);
+			qsort(distances, numberOfReplicates, sizeof(double), compareDoubles);
+			medianMicroseconds = microseconds[(numberOfReplicates - 1) / 2];
+			p95Distance = distances[(numberOfReplicates * 95 + 99) / 100 - 1];
+
+			fprintf(
+				outputFile,
+				"%s,%zu,%zu,%.3lf,%.6e,%.6e\n",
+				kAccuracyBenchmarkStrategies[s].name,
+				iterationCounts[k],
+				numberOfReplicates,
+				medianMicroseconds,
+				meanDistance,
+				p95Distance);
+
+			/*
+			 *	The iteration counts are swept in the order given, so the first one within
+			 *	the budget is the cheapest when they are given in increasing order.
+			 */
+			if ((errorBudget > 0.0) && !isBudgetMet && (p95Distance <= errorBudget))
+			{
+				fprintf(
+					stderr,
+					"%s: -M %zu is within the error budget (95th percentile distance %.3e A, median %.3lf us).\n",
+					kAccuracyBenchmarkStrategies[s].name,
+					iterationCounts[k],
+					p95Distance,
+					medianMicroseconds);
+				isBudgetMet = true;
+			}
+		}
+
+		if ((errorBudget > 0.0) && !isBudgetMet && (returnValue == kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(stderr, "%s: No iteration count is within the error budget.\n", kAccuracyBenchmarkStrategies[s].name);
+		}
+	}
+
+	if (returnValue != kCommonConstantReturnTypeSuccess)
+	{
+		fprintf(stderr, "Error: Could not initialize the point set of a sampling strategy.\n");
+	}
+
+	free(samples);
+	free(referenceSamples);
+	free(distances);
+	free(microseconds);
+	destroyThreadPool(pool);
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+	}
+
+	return returnValue;
+}
@@ -0,0 +1,96 @@
+#!/bin/sh
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+#
+#	Checks that the replies of the server mode do not depend on its number of
+#	threads: starts one server per thread count, sends the same requests to each,
+#	and compares every reply, byte for byte, with that of the first server.
+#
+#	Usage: check-server-replies.sh [-e <native-exe>] [-c <conversion-client>]
+#				       [-t "<threads> ..."] [-M "<iterations> ..."]
+#
+
+set -eu
+
+executable="../src/native-exe"
+client="../src/conversion-client"
+threadCounts="1 2 5 64"
+iterationCounts="1 256 4096 100000 1000003"
+
+while getopts "e:c:t:M:" option
+do
+	case "$option" in
+		e) executable="$OPTARG" ;;
+		c) client="$OPTARG" ;;
+		t) threadCounts="$OPTARG" ;;
+		M) iterationCounts="$OPTARG" ;;
+		*) sed -n 's/^#	Usage: //p' "$0" >&2; exit 1 ;;
+	esac
+done
+
+for program in "$executable" "$client"
+do
+	if [ ! -x "$program" ]
+	then
+		echo "Error: Cannot execute $program (see -e and -c options)." >&2
+		exit 1
+	fi
+done
+
+workingDirectory="$(mktemp -d)"
+serverProcesses=""
+trap 'kill $serverProcesses 2> /dev/null; rm -rf "$workingDirectory"' EXIT
+
+for threads in $threadCounts
+do
+	"$executable" -u "$workingDirectory/$threads.sock" -t "$threads" &
+	serverProcesses="$serverProcesses $!"
+done
+for threads in $threadCounts
+do
+	while [ ! -S "$workingDirectory/$threads.sock" ]
+	do
+		sleep 0.1
+	done
+done
+
+referenceThreads="${threadCounts%% *}"
+numberOfFailures=0
+for iterations in $iterationCounts
+do
+	for threads in $threadCounts
+	do
+		if ! "$client" "$workingDirectory/$referenceThreads.sock" -M "$iterations" -q 9,10.5,12 \
+			-x "$workingDirectory/$threads.sock" > /dev/null
+		then
+			numberOfFailures=$((numberOfFailures + 1))
+		fi
+	done
+done
+
+if [ "$numberOfFailures" -gt 0 ]
+then
+	echo "$numberOfFailures replies differ from those of the server with $referenceThreads thread(s)." >&2
+	exit 1
+fi
+echo "The replies of the servers with $threadCounts thread(s) are identical."
@@ -0,0 +1,325 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+/*
+ *	A client and load generator for the server mode of the application (`-u`).
+ *	With a single request (the default), it prints the summary of the reply.
+ *	With `-n`, it sends that many copies of the request over `-c` concurrent
+ *	connections and prints the throughput and latency percentiles as CSV.
+ *	With `-x`, it also sends the request to a second server, and fails unless
+ *	both reply with the same bytes.
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "conversion-server.h"
+#include "phase-timing.h"
+#include "sample-query.h"
+#include "sensor-variants.h"
+
+typedef enum
+{
+	kConversionClientConstantDefaultIterations	= 4096,
+	kConversionClientConstantMaxConnections		= kConversionServerConstantMaxClients,
+} ConversionClientConstant;
+
+typedef struct
+{
+	const char *			socketPath;
+	const ConversionRequest *	request;
+	size_t				numberOfRequests;
+	uint64_t *			latencyNanoseconds;
+	bool				hasFailed;
+} ConversionClientWorker;
+
+static void *
+runConversionClientWorker(void *  argument)
+{
+	ConversionClientWorker *	worker = argument;
+	ConversionResponse		response;
+	int				connection;
+
+	if (connectConversionServer(worker->socketPath, &connection) != kCommonConstantReturnTypeSuccess)
+	{
+		worker->hasFailed = true;
+
+		return NULL;
+	}
+
+	for (size_t i = 0; i < worker->numberOfRequests; i++)
+	{
+		uint64_t	start = readMonotonicNanoseconds();
+
+		if ((requestConversion(connection, worker->request, &response) != kCommonConstantReturnTypeSuccess) ||
+			(response.status != kConversionServerStatusSuccess))
+		{
+			worker->hasFailed = true;
+
+			break;
+		}
+		worker->latencyNanoseconds[i] = readMonotonicNanoseconds() - start;
+	}
+
+	disconnectConversionServer(connection);
+
+	return NULL;
+}
+
+static int
+compareLatencies(const void *  a, const void *  b)
+{
+	uint64_t	x = *(const uint64_t *)a;
+	uint64_t	y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void
+printConversionResponse(const ConversionRequest *  request, const ConversionResponse *  response)
+{
+	printf("Samples: %" PRIu64 "\n", response->numberOfSamples);
+	printf("Mean: %lf A, standard deviation: %lf A\n", response->mean, sqrt(response->variance));
+	printf("Minimum: %lf A, maximum: %lf A\n", response->minimum, response->maximum);
+	for (size_t i = 0; i < kDistributionSummaryConstantNumberOfQuantiles; i++)
+	{
+		printf("Quantile at %.2lf: %lf A\n", kDistributionSummaryQuantileProbabilities[i], response->quantiles[i]);
+	}
+	for (uint32_t k = 0; k < response->numberOfThresholds; k++)
+	{
+		printf("P(output <= %lf) = %lf\n", request->thresholds[k], response->thresholdProbabilities[k]);
+	}
+
+	return;
+}
+
+/*
+ *	Send one request on a new connection, and check the status of the reply.
+ */
+static CommonConstantReturnType
+requestConversionFromServer(const char *  socketPath, const ConversionRequest *  request, ConversionResponse *  response)
+{
+	int				connection;
+	CommonConstantReturnType	returnValue;
+
+	if (connectConversionServer(socketPath, &connection) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	returnValue = requestConversion(connection, request, response);
+	if ((returnValue == kCommonConstantReturnTypeSuccess) && (response->status != kConversionServerStatusSuccess))
+	{
+		fprintf(stderr, "Error: The server at %s rejected the request.\n", socketPath);
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	disconnectConversionServer(connection);
+
+	return returnValue;
+}
+
+static int
+runConversionLoad(const char *  socketPath, const ConversionRequest *  request, size_t numberOfRequests, size_t numberOfConnections)
+{
+	pthread_t			threads[kConversionClientConstantMaxConnections];
+	ConversionClientWorker		workers[kConversionClientConstantMaxConnections];
+	uint64_t *			latencyNanoseconds = checkedMalloc(numberOfRequests * sizeof(uint64_t), __FILE__, __LINE__);
+	size_t				numberOfStartedThreads = 0;
+	bool				hasFailed = false;
+	uint64_t			start = readMonotonicNanoseconds();
+	double				seconds;
+
+	for (size_t c = 0; c < numberOfConnections; c++)
+	{
+		size_t	begin = (numberOfRequests * c) / numberOfConnections;
+		size_t	end = (numberOfRequests * (c + 1)) / numberOfConnections;
+
+		workers[c] = (ConversionClientWorker)
+		{
+			.socketPath = socketPath,
+			.request = request,
+			.numberOfRequests = end - begin,
+			.latencyNanoseconds = &latencyNanoseconds[begin],
+			.hasFailed = false,
+		};
+		if (pthread_create(&threads[c], NULL, runConversionClientWorker, &workers[c]) != 0)
+		{
+			fprintf(stderr, "Error: Could not start client thread %zu.\n", c);
+			hasFailed = true;
+
+			break;
+		}
+		numberOfStartedThreads++;
+	}
+
+	for (size_t c = 0; c < numberOfStartedThreads; c++)
+	{
+		pthread_join(threads[c], NULL);
+		hasFailed = hasFailed || workers[c].hasFailed;
+	}
+	seconds = (double)(readMonotonicNanoseconds() - start) * 1e-9;
+
+	if (hasFailed)
+	{
+		free(latencyNanoseconds);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	qsort(latencyNanoseconds, numberOfRequests, sizeof(uint64_t), compareLatencies);
+	printf("requests,connections,iterationsPerRequest,seconds,requestsPerSecond,medianMicroseconds,p95Microseconds,p99Microseconds\n");
+	printf(
+		"%zu,%zu,%" PRIu32 ",%.6lf,%.1lf,%.3lf,%.3lf,%.3lf\n",
+		numberOfRequests,
+		numberOfConnections,
+		request->numberOfIterations,
+		seconds,
+		(double)numberOfRequests / seconds,
+		(double)latencyNanoseconds[numberOfRequests / 2] * 1e-3,
+		(double)latencyNanoseconds[(numberOfRequests * 95) / 100] * 1e-3,
+		(double)latencyNanoseconds[(numberOfRequests * 99) / 100] * 1e-3);
+
+	free(latencyNanoseconds);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static void
+printConversionClientUsage(const char *  name)
+{
+	fprintf(
+		stderr,
+		"Usage: %s <Path to socket> [-M <iterations>] [-d <variant>] [-s <seed>] [-q <x1,x2,...>] [-n <requests> [-c <connections>] | -x <Path to second socket>]\n",
+		name);
+
+	return;
+}
+
+int
+main(int argc, char *  argv[])
+{
+	ConversionRequest	request;
+	ConversionResponse	response;
+	ConversionResponse	comparedResponse;
+	SampleQueryList		thresholds = {0};
+	size_t			numberOfRequests = 1;
+	size_t			numberOfConnections = 1;
+	const char *		comparedSocketPath = NULL;
+	const SensorVariant *	sensorVariant;
+	int			option;
+	int			returnValue;
+
+	initializeConversionRequest(&request, kConversionClientConstantDefaultIterations);
+
+	while ((option = getopt(argc, argv, "M:d:s:q:n:c:x:")) != -1)
+	{
+		switch (option)
+		{
+			case 'M':
+				request.numberOfIterations = (uint32_t)strtoul(optarg, NULL, 0);
+				break;
+			case 'd':
+				sensorVariant = findSensorVariant(optarg);
+				if (sensorVariant == NULL)
+				{
+					fprintf(stderr, "Error: Unknown sensor variant %s.\n", optarg);
+
+					return kCommonConstantReturnTypeError;
+				}
+				request.sensorVariantIndex = (uint32_t)(sensorVariant - kSensorVariants);
+				break;
+			case 's':
+				request.seed = strtoull(optarg, NULL, 0);
+				break;
+			case 'q':
+				if (appendSampleQueries(&thresholds, kSampleQueryKindLessOrEqual, optarg) != kCommonConstantReturnTypeSuccess)
+				{
+					return kCommonConstantReturnTypeError;
+				}
+				break;
+			case 'n':
+				numberOfRequests = strtoull(optarg, NULL, 0);
+				break;
+			case 'c':
+				numberOfConnections = strtoull(optarg, NULL, 0);
+				break;
+			case 'x':
+				comparedSocketPath = optarg;
+				break;
+			default:
+				printConversionClientUsage(argv[0]);
+
+				return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if ((optind != argc - 1) ||
+		(numberOfRequests == 0) ||
+		(numberOfConnections == 0) ||
+		(numberOfConnections > kConversionClientConstantMaxConnections) ||
+		(numberOfConnections > numberOfRequests) ||
+		((comparedSocketPath != NULL) && (numberOfRequests > 1)) ||
+		(thresholds.numberOfQueries > kConversionServerConstantMaxThresholds))
+	{
+		printConversionClientUsage(argv[0]);
+		fprintf(
+			stderr,
+			"At most %d connections, no more than the requests, at most %d thresholds, and -x only with a single request.\n",
+			kConversionClientConstantMaxConnections,
+			kConversionServerConstantMaxThresholds);
+		freeSampleQueryList(&thresholds);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	request.numberOfThresholds = (uint32_t)thresholds.numberOfQueries;
+	for (size_t k = 0; k < thresholds.numberOfQueries; k++)
+	{
+		request.thresholds[k] = thresholds.queries[k].value;
+	}
+	freeSampleQueryList(&thresholds);
+
+	if (numberOfRequests > 1)
+	{
+		return runConversionLoad(argv[optind], &request, numberOfRequests, numberOfConnections);
+	}
+
+	returnValue = requestConversionFromServer(argv[optind], &request, &response);
+	if ((returnValue == kCommonConstantReturnTypeSuccess) && (comparedSocketPath != NULL))
+	{
+		returnValue = requestConversionFromServer(comparedSocketPath, &request, &comparedResponse);
+		if ((returnValue == kCommonConstantReturnTypeSuccess) && (memcmp(&response, &comparedResponse, sizeof(response)) != 0))
+		{
+			fprintf(stderr, "Error: The servers at %s and %s replied with different bytes.\n", argv[optind], comparedSocketPath);
+			returnValue = kCommonConstantReturnTypeError;
+		}
+	}
+	if (returnValue == kCommonConstantReturnTypeSuccess)
+	{
+		printConversionResponse(&request, &response);
+	}
+
+	return returnValue;
+}
@@ -0,0 +1,450 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+/*
+ *	Micro-benchmarks of the hot functions of the application. The application
+ *	is included as a whole, with its `main()` renamed, so that its static
+ *	functions can be benchmarked as they are, without exporting them.
+ */
+#define main	tmcsApplicationMain
+#include "main.c"
+#undef main
+#include "sensor-array.h"
+
+typedef enum
+{
+	kMicroBenchmarkConstantDefaultIterations	= 1000000,
+	kMicroBenchmarkConstantDefaultTrials		= 15,
+	kMicroBenchmarkConstantSensorArrayChannels	= 256,
+	kMicroBenchmarkConstantPhiloxCheckDraws		= 37,
+} MicroBenchmarkConstant;
+
+/*
+ *	The known-answer vectors of Philox4x32-10 of Random123 (`kat_vectors`):
+ *	counter, key and output, least significant word first.
+ */
+typedef struct
+{
+	uint32_t	counter[4];
+	uint32_t	key[2];
+	uint32_t	output[4];
+} PhiloxKnownAnswer;
+
+static const PhiloxKnownAnswer	kPhiloxKnownAnswers[] =
+{
+	{
+		{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+		{0x00000000, 0x00000000},
+		{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+	},
+	{
+		{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+		{0xffffffff, 0xffffffff},
+		{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+	},
+	{
+		{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+		{0xa4093822, 0x299f31d0},
+		{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1},
+	},
+};
+
+/*
+ *	Runs `iterations` iterations of a benchmarked function, writing to or reading from `data`.
+ */
+typedef void	(*MicroBenchmarkFunction)(double *  data, size_t iterations);
+
+typedef struct
+{
+	const char *		name;
+	MicroBenchmarkFunction	function;
+} MicroBenchmark;
+
+/*
+ *	Written by the benchmarks, so that the compiler cannot drop their results.
+ */
+static volatile double	microBenchmarkSink;
+
+static void
+benchmarkSampling(double *  data, size_t iterations)
+{
+	for (size_t i = 0; i < iterations; i++)
+	{
+		setInputDistributionsViaUxHwCall(&data[2 * i]);
+	}
+
+	return;
+}
+
+static void
+benchmarkBatchedSampling(double *  data, size_t iterations)
+{
+	const ConversionKernels *	kernels = selectConversionKernels(kConversionKernelIsaAutomatic);
+	RandomLaneStream		randomStream;
+
+	seedRandomLaneStream(&randomStream, kDefaultMonteCarloSeed, 0);
+	kernels->fillUniformBlock(
+			&randomStream,
+			data,
+			iterations,
+			kDefaultInputDistributionVoutUniformDistLow,
+			kDefaultInputDistributionVoutUniformDistHigh);
+	kernels->fillUniformBlock(
+			&randomStream,
+			&data[iterations],
+			iterations,
+			kDefaultInputDistributionVrefUniformDistLow,
+			kDefaultInputDistributionVrefUniformDistHigh);
+
+	return;
+}
+
+static void
+benchmarkPhiloxSampling(double *  data, size_t iterations)
+{
+	const ConversionKernels *	kernels = selectConversionKernels(kConversionKernelIsaAutomatic);
+	PhiloxKey			key;
+
+	seedPhiloxKey(&key, kDefaultMonteCarloSeed);
+	kernels->fillPhiloxUnitBlock(&key, 0, data, &data[iterations], iterations);
+
+	return;
+}
+
+static void
+benchmarkCalculateSensorOutput(double *  data, size_t iterations)
+{
+	double	outputDistributions[kOutputDistributionIndexMax];
+	double	sum = 0.0;
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		sum += calculateSensorOutput(&data[2 * i], outputDistributions, calculateCalibratedCurrentTMCS1123x3A);
+	}
+	microBenchmarkSink = sum;
+
+	return;
+}
+
+static void
+benchmarkBatchedConversion(double *  data, size_t iterations)
+{
+	const ConversionKernels *	kernels = selectConversionKernels(kConversionKernelIsaAutomatic);
+
+	kernels->convertSensorOutputBlock(
+			data,
+			&data[iterations],
+			&data[2 * iterations],
+			iterations,
+			kSensorVariants[kSensorVariantIndexTMCS1123x3A].sensitivityReciprocal);
+
+	return;
+}
+
+/*
+ *	The batched conversion under the extended error model (`-e` option), which
+ *	also draws the six error terms of every sample, at an ambient temperature
+ *	over [0, 70] °C.
+ */
+static void
+benchmarkBatchedConversionWithErrors(double *  data, size_t iterations)
+{
+	const ConversionKernels *	kernels = selectConversionKernels(kConversionKernelIsaAutomatic);
+	RandomLaneStream		randomStream;
+	SensorErrorModel		errorModel;
+
+	initializeSensorErrorModel(&errorModel, &kSensorVariants[kSensorVariantIndexTMCS1123x3A], 0.0, 70.0);
+	seedRandomLaneStream(&randomStream, kDefaultMonteCarloSeed, 0);
+	kernels->convertSensorOutputWithErrorsBlock(
+			&randomStream,
+			data,
+			&data[iterations],
+			&data[2 * iterations],
+			iterations,
+			&errorModel);
+
+	return;
+}
+
+/*
+ *	Converts the iterations as frames of a `kMicroBenchmarkConstantSensorArrayChannels`-channel
+ *	array of mixed TMCS1123 variants.
+ */
+static void
+benchmarkSensorArrayFrames(double *  data, size_t iterations)
+{
+	double		sensitivities[kMicroBenchmarkConstantSensorArrayChannels];
+	SensorArray *	array;
+
+	for (size_t c = 0; c < kMicroBenchmarkConstantSensorArrayChannels; c++)
+	{
+		sensitivities[c] = kSensorVariants[kSensorVariantIndexTMCS1123x1A + c % 5].sensitivity;
+	}
+
+	if (createSensorArray(kMicroBenchmarkConstantSensorArrayChannels, sensitivities, NULL, NULL, kConversionKernelIsaAutomatic, &array) != kCommonConstantReturnTypeSuccess)
+	{
+		return;
+	}
+
+	convertSensorArrayFrames(
+		array,
+		data,
+		&data[iterations],
+		&data[2 * iterations],
+		iterations / kMicroBenchmarkConstantSensorArrayChannels);
+	destroySensorArray(array);
+
+	return;
+}
+
+static void
+benchmarkMeanAndVariance(double *  data, size_t iterations)
+{
+	MeanAndVariance	meanAndVariance = calculateMeanAndVarianceOfDoubleSamples(data, iterations);
+
+	microBenchmarkSink = meanAndVariance.mean;
+
+	return;
+}
+
+static void
+benchmarkSampleReduction(double *  data, size_t iterations)
+{
+	SampleMoments	moments;
+
+	reduceSampleMoments(NULL, selectConversionKernels(kConversionKernelIsaAutomatic), data, iterations, &moments);
+	microBenchmarkSink = moments.mean;
+
+	return;
+}
+
+static void
+benchmarkSaveDataDotOut(double *  data, size_t iterations)
+{
+	saveMonteCarloDoubleDataToDataDotOutFile(data, 0, iterations);
+
+	return;
+}
+
+/*
+ *	The sample over [0, 1) of `fillPhiloxUnitBlock` for a pair of Philox output words.
+ */
+static double
+getPhiloxUnit(uint32_t low, uint32_t high)
+{
+	return ldexp((double)((((uint64_t)high << 32) | low) >> 12), -52);
+}
+
+/*
+ *	Checks `philox4x32()` against the known-answer vectors, and the `fillPhiloxUnitBlock`
+ *	kernel of each instruction set the CPU supports against `philox4x32()`, with the
+ *	key of each vector, over a block of draws that covers both the vector loop and the
+ *	scalar tail of the kernels. The kernels only set the low 64 bits of the counter, so
+ *	the first vector, whose counter is zero, is also checked through them directly.
+ */
+static CommonConstantReturnType
+checkPhiloxKnownAnswers(void)
+{
+	static const ConversionKernelIsa	isas[] = {kConversionKernelIsaScalar, kConversionKernelIsaAVX2, kConversionKernelIsaAVX512};
+	static const char *			isaNames[] = {"scalar", "avx2", "avx512"};
+
+	for (size_t v = 0; v < sizeof(kPhiloxKnownAnswers) / sizeof(kPhiloxKnownAnswers[0]); v++)
+	{
+		const PhiloxKnownAnswer *	answer = &kPhiloxKnownAnswers[v];
+		PhiloxKey			key = { .key = {answer->key[0], answer->key[1]} };
+		uint64_t			firstIndex = ((uint64_t)answer->counter[1] << 32) | answer->counter[0];
+		uint32_t			output[4];
+
+		philox4x32(&key, answer->counter, output);
+		if (memcmp(output, answer->output, sizeof(output)) != 0)
+		{
+			fprintf(stderr, "Error: philox4x32() does not match known-answer vector %zu.\n", v);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		for (size_t k = 0; k < sizeof(isas) / sizeof(isas[0]); k++)
+		{
+			const ConversionKernels *	kernels = selectConversionKernels(isas[k]);
+			double				first[kMicroBenchmarkConstantPhiloxCheckDraws];
+			double				second[kMicroBenchmarkConstantPhiloxCheckDraws];
+
+			if (kernels == NULL)
+			{
+				continue;
+			}
+
+			kernels->fillPhiloxUnitBlock(&key, firstIndex, first, second, kMicroBenchmarkConstantPhiloxCheckDraws);
+			for (size_t i = 0; i < kMicroBenchmarkConstantPhiloxCheckDraws; i++)
+			{
+				uint64_t	index = firstIndex + i;
+				uint32_t	counter[4] = {(uint32_t)index, (uint32_t)(index >> 32), 0, 0};
+
+				philox4x32(&key, counter, output);
+				if ((first[i] != getPhiloxUnit(output[0], output[1])) || (second[i] != getPhiloxUnit(output[2], output[3])))
+				{
+					fprintf(stderr, "Error: The %s Philox kernel does not match philox4x32() at draw %" PRIu64 " of the key of vector %zu.\n", isaNames[k], index, v);
+
+					return kCommonConstantReturnTypeError;
+				}
+			}
+
+			if ((answer->counter[2] == 0) && (answer->counter[3] == 0) &&
+				((first[0] != getPhiloxUnit(answer->output[0], answer->output[1])) ||
+				(second[0] != getPhiloxUnit(answer->output[2], answer->output[3]))))
+			{
+				fprintf(stderr, "Error: The %s Philox kernel does not match known-answer vector %zu.\n", isaNames[k], v);
+
+				return kCommonConstantReturnTypeError;
+			}
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *)a;
+	double	y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+int
+main(int argc, char *  argv[])
+{
+	static const MicroBenchmark	benchmarks[] =
+					{
+						{ "sampling", benchmarkSampling },
+						{ "batchedSampling", benchmarkBatchedSampling },
+						{ "philoxSampling", benchmarkPhiloxSampling },
+						{ "calculateSensorOutput", benchmarkCalculateSensorOutput },
+						{ "batchedConversion", benchmarkBatchedConversion },
+						{ "batchedConversionWithErrors", benchmarkBatchedConversionWithErrors },
+						{ "sensorArrayFrames", benchmarkSensorArrayFrames },
+						{ "calculateMeanAndVarianceOfDoubleSamples", benchmarkMeanAndVariance },
+						{ "sampleReduction", benchmarkSampleReduction },
+						{ "saveMonteCarloDoubleDataToDataDotOutFile", benchmarkSaveDataDotOut },
+					};
+	size_t				iterations = kMicroBenchmarkConstantDefaultIterations;
+	size_t				numberOfTrials = kMicroBenchmarkConstantDefaultTrials;
+	FILE *				outputFile = stdout;
+	double *			data;
+	double *			trialNanosecondsPerIteration;
+
+	if (argc > 4)
+	{
+		fprintf(stderr, "Usage: %s [<iterations> [<trials> [<output CSV>]]]\n", argv[0]);
+
+		return kCommonConstantReturnTypeError;
+	}
+	if (argc > 1)
+	{
+		iterations = strtoull(argv[1], NULL, 0);
+	}
+	if (argc > 2)
+	{
+		numberOfTrials = strtoull(argv[2], NULL, 0);
+	}
+	if ((iterations == 0) || (numberOfTrials == 0))
+	{
+		fprintf(stderr, "Error: The number of iterations and of trials should be positive.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+	if (argc > 3)
+	{
+		outputFile = fopen(argv[3], "w");
+		if (outputFile == NULL)
+		{
+			fprintf(stderr, "Error: Could not open %s for writing.\n", argv[3]);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	/*
+	 *	Timing a wrong kernel is pointless, so the Philox kernels are checked first.
+	 */
+	if (checkPhiloxKnownAnswers() != kCommonConstantReturnTypeSuccess)
+	{
+		if (outputFile != stdout)
+		{
+			fclose(outputFile);
+		}
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Room for interleaved (Vout, Vref) pairs, or for Vout, Vref and output arrays.
+	 */
+	data = checkedMalloc(3 * iterations * sizeof(double), __FILE__, __LINE__);
+	trialNanosecondsPerIteration = checkedMalloc(numberOfTrials * sizeof(double), __FILE__, __LINE__);
+
+	fprintf(outputFile, "benchmark,iterations,trials,medianNanosecondsPerIteration,p95NanosecondsPerIteration,iterationsPerSecond\n");
+	for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+	{
+		double	median;
+		double	p95;
+
+		/*
+		 *	Every benchmark starts from valid samples: untimed, fill `data` with
+		 *	(Vout, Vref) pairs, followed by their calibrated outputs.
+		 */
+		benchmarkSampling(data, iterations);
+		benchmarkBatchedConversion(data, iterations);
+
+		for (size_t t = 0; t < numberOfTrials; t++)
+		{
+			uint64_t	start = readMonotonicNanoseconds();
+
+			benchmarks[b].function(data, iterations);
+			trialNanosecondsPerIteration[t] = (double)(readMonotonicNanoseconds() - start) / (double)iterations;
+		}
+
+		qsort(trialNanosecondsPerIteration, numberOfTrials, sizeof(double), compareDoubles);
+		median = trialNanosecondsPerIteration[(numberOfTrials - 1) / 2];
+		p95 = trialNanosecondsPerIteration[(numberOfTrials * 95 + 99) / 100 - 1];
+
+		fprintf(
+			outputFile,
+			"%s,%zu,%zu,%.3lf,%.3lf,%.0lf\n",
+			benchmarks[b].name,
+			iterations,
+			numberOfTrials,
+			median,
+			p95,
+			1e9 / median);
+	}
+
+	free(data);
+	free(trialNanosecondsPerIteration);
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,130 @@
+#!/bin/sh
+#
+#	Copyright (c) 2024, Signaloid.
+#
+#	Permission is hereby granted, free of charge, to any person obtaining a copy
+#	of this software and associated documentation files (the "Software"), to deal
+#	in the Software without restriction, including without limitation the rights
+#	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#	copies of the Software, and to permit persons to whom the Software is
+#	furnished to do so, subject to the following conditions:
+#
+#	The above copyright notice and this permission notice shall be included in all
+#	copies or substantial portions of the Software.
+#
+#	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#	SOFTWARE.
+#
+
+#
+#	Sweeps the number of Monte Carlo iterations, the number of threads and the
+#	output mode of the application, and writes the median and 95th percentile
+#	of the wall-clock time of repeated trials, and the median throughput, to a
+#	CSV file. The time of a trial is the total of the phases reported by `-T`,
+#	so it does not include process start-up.
+#
+#	Usage: run-benchmarks.sh [-e <native-exe>] [-o <output CSV>] [-r <trials>]
+#				 [-M "<iterations> ..."] [-t "<threads> ..."] [-m "<modes> ..."]
+#
+#	Threads of 0 select the serial UxHw loop; others, the parallel engine (`-t`).
+#	Output modes are `none` (`-n`), `text` (`data.out`), `json` (`-j`) and `binary` (`-B`).
+#
+
+set -eu
+
+executable="../src/native-exe"
+outputFile="benchmarks.csv"
+numberOfTrials=11
+iterationCounts="10000 100000 1000000 10000000"
+threadCounts="0 1 2 4 8"
+outputModes="none text json binary"
+
+while getopts "e:o:r:M:t:m:" option
+do
+	case "$option" in
+		e) executable="$OPTARG" ;;
+		o) outputFile="$OPTARG" ;;
+		r) numberOfTrials="$OPTARG" ;;
+		M) iterationCounts="$OPTARG" ;;
+		t) threadCounts="$OPTARG" ;;
+		m) outputModes="$OPTARG" ;;
+		*) sed -n 's/^#	Usage: //p' "$0" >&2; exit 1 ;;
+	esac
+done
+
+case "$executable" in
+	/*) ;;
+	*) executable="$(pwd)/$executable" ;;
+esac
+if [ ! -x "$executable" ]
+then
+	echo "Error: Cannot execute $executable (see -e option)." >&2
+	exit 1
+fi
+
+#
+#	The application writes `data.out` and `data.bin` to its working directory.
+#
+workingDirectory="$(mktemp -d)"
+trap 'rm -rf "$workingDirectory"' EXIT
+
+echo "iterations,threads,outputMode,trials,medianSeconds,p95Seconds,samplesPerSecond" > "$outputFile"
+
+for iterations in $iterationCounts
+do
+	for threads in $threadCounts
+	do
+		for mode in $outputModes
+		do
+			set -- -M "$iterations" -T
+			if [ "$threads" -gt 0 ]
+			then
+				set -- "$@" -t "$threads"
+			fi
+			case "$mode" in
+				none) set -- "$@" -n ;;
+				text) ;;
+				json) set -- "$@" -j ;;
+				binary) set -- "$@" -B ;;
+				*) echo "Error: Unknown output mode $mode." >&2; exit 1 ;;
+			esac
+
+			trial=0
+			: > "$workingDirectory/times"
+			while [ "$trial" -lt "$numberOfTrials" ]
+			do
+				#
+				#	Text output ends with a `total <seconds> seconds` line, JSON output
+				#	with a timing object whose `wallNanoseconds` add up to the total.
+				#
+				(cd "$workingDirectory" && "$executable" "$@") | awk '
+					/^\ttotal / { total = $2 }
+					/"timing"/ {
+						line = $0
+						total = 0
+						while (match(line, /"wallNanoseconds":[0-9]+/))
+						{
+							total += substr(line, RSTART + 18, RLENGTH - 18) * 1e-9
+							line = substr(line, RSTART + RLENGTH)
+						}
+					}
+					END { if (total == "") exit 1; printf "%.9f\n", total }' >> "$workingDirectory/times"
+				trial=$((trial + 1))
+			done
+
+			sort -g "$workingDirectory/times" | awk -v iterations="$iterations" -v threads="$threads" -v mode="$mode" '
+				{ times[NR] = $1 }
+				END {
+					median = times[int((NR + 1) / 2)]
+					p95 = times[(NR * 95 % 100 == 0) ? NR * 95 / 100 : int(NR * 95 / 100) + 1]
+					printf "%s,%s,%s,%d,%.9f,%.9f,%.0f\n", iterations, threads, mode, NR, median, p95, (median > 0) ? iterations / median : 0
+				}' >> "$outputFile"
+			tail -n 1 "$outputFile"
+		done
+	done
+done
@@ -0,0 +1,380 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "adc-codes.h"
+#include "analytic.h"
+
+struct AdcCodeStream
+{
+	RecordStreamFormat	format;
+	FILE *			file;
+	uint32_t		maximumCode;
+	size_t			lineNumber;
+	bool			isHeaderCandidate;
+	bool			hasFailed;
+	AdcCodeReading *	block;
+	unsigned char *		binaryReadBuffer;
+};
+
+CommonConstantReturnType
+createAdcCodeTable(uint32_t resolution, double referenceVoltage, double sensitivity, AdcCodeTable **  table)
+{
+	AdcCodeTable *	newTable;
+	double		halfLeastSignificantBit;
+
+	if ((resolution < kAdcCodesConstantMinResolution) || (resolution > kAdcCodesConstantMaxResolution) ||
+		!isfinite(referenceVoltage) || (referenceVoltage <= 0) || (sensitivity == 0))
+	{
+		fprintf(stderr, "Error: Invalid ADC parameters for the code table.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newTable = calloc(1, sizeof(AdcCodeTable));
+	if (newTable == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate ADC code table.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newTable->resolution = resolution;
+	newTable->maximumCode = (UINT32_C(1) << resolution) - 1;
+	newTable->referenceVoltage = referenceVoltage;
+	newTable->leastSignificantBit = ldexp(referenceVoltage, -(int)resolution);
+	newTable->numberOfEntries = 2 * (size_t)newTable->maximumCode + 1;
+	newTable->entries = malloc(newTable->numberOfEntries * sizeof(DistributionSummary));
+	if (newTable->entries == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate ADC code table.\n");
+		free(newTable);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Vout - Vref is the code difference in LSBs plus the difference of the two
+	 *	quantization errors, so each entry is the exact distribution of the
+	 *	difference of a uniform around the code difference and a uniform around zero.
+	 */
+	halfLeastSignificantBit = 0.5 * newTable->leastSignificantBit;
+	for (size_t i = 0; i < newTable->numberOfEntries; i++)
+	{
+		double			codeDifferenceVoltage = ((double)i - (double)newTable->maximumCode) * newTable->leastSignificantBit;
+		TrapezoidalDistribution	distribution;
+
+		distribution = makeCalibratedOutputDistribution(
+					codeDifferenceVoltage - halfLeastSignificantBit,
+					codeDifferenceVoltage + halfLeastSignificantBit,
+					-halfLeastSignificantBit,
+					halfLeastSignificantBit,
+					sensitivity);
+		summarizeTrapezoidalDistribution(&distribution, &newTable->entries[i]);
+	}
+
+	*table = newTable;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+destroyAdcCodeTable(AdcCodeTable *  table)
+{
+	if (table == NULL)
+	{
+		return;
+	}
+
+	free(table->entries);
+	free(table);
+
+	return;
+}
+
+static RecordStreamFormat
+detectAdcCodeStreamFormat(const char *  path)
+{
+	size_t	length = strlen(path);
+
+	if ((length >= 4) && (strcmp(&path[length - 4], ".bin") == 0))
+	{
+		return kRecordStreamFormatBinary;
+	}
+
+	return kRecordStreamFormatCSV;
+}
+
+/*
+ *	Parses one CSV line into `reading`. Returns 1 for a reading, 0 for a line that
+ *	should be skipped, and -1 for a malformed line.
+ */
+static int
+parseCSVCodeLine(AdcCodeStream *  stream, char *  line, AdcCodeReading *  reading)
+{
+	unsigned long	codes[kAdcCodesConstantCodesPerReading];
+	char *		cursor = line;
+	char *		end;
+	bool		isHeaderCandidate = stream->isHeaderCandidate;
+
+	stream->isHeaderCandidate = false;
+
+	while ((*cursor == ' ') || (*cursor == '\t'))
+	{
+		cursor++;
+	}
+
+	if ((*cursor == '\0') || (*cursor == '\n') || (*cursor == '\r') || (*cursor == '#'))
+	{
+		stream->isHeaderCandidate = isHeaderCandidate;
+
+		return 0;
+	}
+
+	for (int i = 0; i < kAdcCodesConstantCodesPerReading; i++)
+	{
+		if ((*cursor < '0') || (*cursor > '9'))
+		{
+			/*
+			 *	A non-numeric first line is taken to be a column header.
+			 */
+			return ((i == 0) && isHeaderCandidate) ? 0 : -1;
+		}
+
+		errno = 0;
+		codes[i] = strtoul(cursor, &end, 10);
+		if ((errno == ERANGE) || (codes[i] > stream->maximumCode))
+		{
+			return -1;
+		}
+
+		cursor = end;
+		while ((*cursor == ' ') || (*cursor == '\t'))
+		{
+			cursor++;
+		}
+
+		if (i < kAdcCodesConstantCodesPerReading - 1)
+		{
+			if (*cursor != ',')
+			{
+				return -1;
+			}
+			cursor++;
+			while ((*cursor == ' ') || (*cursor == '\t'))
+			{
+				cursor++;
+			}
+		}
+	}
+
+	if ((*cursor != '\0') && (*cursor != '\n') && (*cursor != '\r'))
+	{
+		return -1;
+	}
+
+	*reading = (AdcCodeReading)
+	{
+		.voutCode	= (uint32_t)codes[0],
+		.vrefCode	= (uint32_t)codes[1],
+	};
+
+	return 1;
+}
+
+static size_t
+fillCSVCodeBlock(AdcCodeStream *  stream)
+{
+	char	line[kCommonConstantMaxCharsPerLine];
+	size_t	count = 0;
+
+	while ((count < kAdcCodesConstantBlockSize) && (fgets(line, sizeof(line), stream->file) != NULL))
+	{
+		int	result;
+
+		stream->lineNumber++;
+		result = parseCSVCodeLine(stream, line, &stream->block[count]);
+		if (result == 0)
+		{
+			continue;
+		}
+
+		if (result < 0)
+		{
+			fprintf(
+				stderr,
+				"Error: Malformed reading on line %zu of input file. Codes should be integers in [0, %" PRIu32 "].\n",
+				stream->lineNumber,
+				stream->maximumCode);
+			stream->hasFailed = true;
+
+			return 0;
+		}
+
+		count++;
+	}
+
+	if (ferror(stream->file))
+	{
+		fprintf(stderr, "Error: Could not read input file.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	return count;
+}
+
+static size_t
+fillBinaryCodeBlock(AdcCodeStream *  stream)
+{
+	const size_t	readingSize = kAdcCodesConstantCodesPerReading * kAdcCodesConstantBinaryBytesPerCode;
+	size_t		count;
+
+	count = fread(stream->binaryReadBuffer, 1, kAdcCodesConstantBlockSize * readingSize, stream->file);
+	if (ferror(stream->file))
+	{
+		fprintf(stderr, "Error: Could not read input file.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	if ((count % readingSize) != 0)
+	{
+		fprintf(stderr, "Error: Binary input file ends with a truncated reading.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	count /= readingSize;
+	for (size_t i = 0; i < count; i++)
+	{
+		const unsigned char *	readingBytes = &stream->binaryReadBuffer[i * readingSize];
+
+		stream->block[i] = (AdcCodeReading)
+		{
+			.voutCode	= (uint32_t)readingBytes[0] | ((uint32_t)readingBytes[1] << 8),
+			.vrefCode	= (uint32_t)readingBytes[2] | ((uint32_t)readingBytes[3] << 8),
+		};
+
+		if ((stream->block[i].voutCode > stream->maximumCode) || (stream->block[i].vrefCode > stream->maximumCode))
+		{
+			fprintf(
+				stderr,
+				"Error: Reading %zu of binary input file has a code above %" PRIu32 ".\n",
+				stream->lineNumber + i,
+				stream->maximumCode);
+			stream->hasFailed = true;
+
+			return 0;
+		}
+	}
+	stream->lineNumber += count;
+
+	return count;
+}
+
+CommonConstantReturnType
+openAdcCodeStream(const char *  path, RecordStreamFormat format, uint32_t maximumCode, AdcCodeStream **  stream)
+{
+	AdcCodeStream *	newStream;
+
+	newStream = calloc(1, sizeof(AdcCodeStream));
+	if (newStream == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate ADC code stream.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newStream->format = (format == kRecordStreamFormatAutomatic) ? detectAdcCodeStreamFormat(path) : format;
+	newStream->maximumCode = maximumCode;
+	newStream->isHeaderCandidate = true;
+	newStream->file = fopen(path, (newStream->format == kRecordStreamFormatBinary) ? "rb" : "r");
+	if (newStream->file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open input file \"%s\".\n", path);
+		free(newStream);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newStream->block = malloc(kAdcCodesConstantBlockSize * sizeof(AdcCodeReading));
+	newStream->binaryReadBuffer = malloc(kAdcCodesConstantBlockSize * kAdcCodesConstantCodesPerReading * kAdcCodesConstantBinaryBytesPerCode);
+	if ((newStream->block == NULL) || (newStream->binaryReadBuffer == NULL))
+	{
+		fprintf(stderr, "Error: Could not allocate ADC code stream buffers.\n");
+		closeAdcCodeStream(newStream);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	*stream = newStream;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+size_t
+readAdcCodeStreamBlock(AdcCodeStream *  stream, const AdcCodeReading **  readings)
+{
+	if (stream->hasFailed)
+	{
+		return 0;
+	}
+
+	*readings = stream->block;
+
+	return (stream->format == kRecordStreamFormatBinary) ? fillBinaryCodeBlock(stream) : fillCSVCodeBlock(stream);
+}
+
+bool
+hasAdcCodeStreamFailed(const AdcCodeStream *  stream)
+{
+	return stream->hasFailed;
+}
+
+void
+closeAdcCodeStream(AdcCodeStream *  stream)
+{
+	if (stream == NULL)
+	{
+		return;
+	}
+
+	if (stream->file != NULL)
+	{
+		fclose(stream->file);
+	}
+
+	free(stream->block);
+	free(stream->binaryReadBuffer);
+	free(stream);
+
+	return;
+}
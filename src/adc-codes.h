@@ -0,0 +1,150 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "distribution-summary.h"
+#include "record-stream.h"
+
+/*
+ *	Readings of raw ADC codes are handed to the caller in blocks of
+ *	`kAdcCodesConstantBlockSize` readings. Binary code files hold the codes as
+ *	packed little-endian uint16 values, so resolutions above 16 bits are not
+ *	supported.
+ */
+typedef enum
+{
+	kAdcCodesConstantMinResolution		= 1,
+	kAdcCodesConstantMaxResolution		= 16,
+	kAdcCodesConstantBlockSize		= 8192,
+	kAdcCodesConstantCodesPerReading	= 2,
+	kAdcCodesConstantBinaryBytesPerCode	= 2,
+} AdcCodesConstant;
+
+/*
+ *	A single reading of the sensor through an ADC: the codes of Vout and Vref.
+ */
+typedef struct
+{
+	uint32_t	voutCode;
+	uint32_t	vrefCode;
+} AdcCodeReading;
+
+/*
+ *	Output-distribution summaries of every pair of ADC codes. An ideal ADC with
+ *	a least significant bit (LSB) of `referenceVoltage / 2^resolution` reports
+ *	code `c` for voltages within ±1/2 LSB of `c` LSB. The quantization errors of
+ *	Vout and Vref are independent uniforms over ±1/2 LSB, so the distribution of
+ *	(Vout - Vref) / S only depends on the difference of the two codes: entry
+ *	`d + maximumCode` summarizes a code difference of `d`, from `-maximumCode`
+ *	to `maximumCode`.
+ */
+typedef struct
+{
+	uint32_t		resolution;
+	uint32_t		maximumCode;
+	double			referenceVoltage;
+	double			leastSignificantBit;
+	size_t			numberOfEntries;
+	DistributionSummary *	entries;
+} AdcCodeTable;
+
+typedef struct AdcCodeStream	AdcCodeStream;
+
+/**
+ *	@brief	Precompute the exact output-distribution summaries of every code difference.
+ *
+ *	@param	resolution		: Resolution of the ADC (in bits), in [kAdcCodesConstantMinResolution, kAdcCodesConstantMaxResolution].
+ *	@param	referenceVoltage	: Reference voltage of the ADC (in Volt), the full-scale voltage.
+ *	@param	sensitivity		: Sensitivity of the sensor (in Volt per Ampere). Must be non-zero.
+ *	@param	table			: Set to the table on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createAdcCodeTable(uint32_t resolution, double referenceVoltage, double sensitivity, AdcCodeTable **  table);
+
+/**
+ *	@brief	Look up the output-distribution summary of a reading. The codes must not
+ *		exceed the table's `maximumCode`, as checked by the code stream.
+ *
+ *	@param	table		: The table.
+ *	@param	reading		: The reading.
+ *	@return			: The summary of the calibrated sensor output (in Ampere).
+ */
+static inline const DistributionSummary *
+lookupAdcCodeTable(const AdcCodeTable *  table, const AdcCodeReading *  reading)
+{
+	return &table->entries[(size_t)reading->voutCode + table->maximumCode - reading->vrefCode];
+}
+
+/**
+ *	@brief	Release the table.
+ *
+ *	@param	table		: The table. May be `NULL`.
+ */
+void	destroyAdcCodeTable(AdcCodeTable *  table);
+
+/**
+ *	@brief	Open a file of ADC code readings for block-wise streaming. CSV files hold one
+ *		`VoutCode,VrefCode` reading per line, skipping blank lines, lines starting with
+ *		`#` and a leading non-numeric header line. Binary files hold packed pairs of
+ *		little-endian uint16 codes, in the same order, without a header.
+ *
+ *	@param	path		: Path to the code file.
+ *	@param	format		: Format of the file. `kRecordStreamFormatAutomatic` selects
+ *				  the binary format for files ending in `.bin` and CSV otherwise.
+ *	@param	maximumCode	: The largest valid code. Larger codes are reported as errors.
+ *	@param	stream		: Set to the opened stream on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	openAdcCodeStream(const char *  path, RecordStreamFormat format, uint32_t maximumCode, AdcCodeStream **  stream);
+
+/**
+ *	@brief	Get the next block of readings. The returned block stays valid until the
+ *		next call to `readAdcCodeStreamBlock()` or `closeAdcCodeStream()`.
+ *
+ *	@param	stream		: The code stream.
+ *	@param	readings	: Set to point to the first reading of the block.
+ *	@return			: The number of readings in the block. Zero at the end of the
+ *				  stream or on error (see `hasAdcCodeStreamFailed()`).
+ */
+size_t	readAdcCodeStreamBlock(AdcCodeStream *  stream, const AdcCodeReading **  readings);
+
+/**
+ *	@brief	Check whether the stream stopped because of a read or parse error.
+ *
+ *	@param	stream		: The code stream.
+ *	@return			: `true` if the stream encountered an error.
+ */
+bool	hasAdcCodeStreamFailed(const AdcCodeStream *  stream);
+
+/**
+ *	@brief	Close the stream and release its buffers.
+ *
+ *	@param	stream		: The code stream. May be `NULL`.
+ */
+void	closeAdcCodeStream(AdcCodeStream *  stream);
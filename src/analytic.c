@@ -0,0 +1,202 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include "analytic.h"
+
+TrapezoidalDistribution
+makeCalibratedOutputDistribution(double voutLow, double voutHigh, double vrefLow, double vrefHigh, double sensitivity)
+{
+	/*
+	 *	Vout - Vref is the sum of uniforms over [voutLow, voutHigh] and [-vrefHigh, -vrefLow].
+	 *	Dividing by the sensitivity scales both widths by 1 / |S| and, for a negative
+	 *	sensitivity, swaps which end of the support is the lower bound.
+	 */
+	double	voutWidth = (voutHigh - voutLow) / fabs(sensitivity);
+	double	vrefWidth = (vrefHigh - vrefLow) / fabs(sensitivity);
+	double	lowerBound = (sensitivity > 0) ? (voutLow - vrefHigh) / sensitivity : (voutHigh - vrefLow) / sensitivity;
+
+	return (TrapezoidalDistribution)
+	{
+		.lowerBound	= lowerBound,
+		.smallerWidth	= fmin(voutWidth, vrefWidth),
+		.largerWidth	= fmax(voutWidth, vrefWidth),
+	};
+}
+
+double
+trapezoidalDistributionPDF(const TrapezoidalDistribution *  distribution, double x)
+{
+	double	u = distribution->smallerWidth;
+	double	v = distribution->largerWidth;
+	double	t = x - distribution->lowerBound;
+
+	if ((t < 0) || (t > u + v))
+	{
+		return 0.0;
+	}
+
+	if (v == 0)
+	{
+		return INFINITY;
+	}
+
+	if (t < u)
+	{
+		return t / (u * v);
+	}
+
+	if (t <= v)
+	{
+		return 1.0 / v;
+	}
+
+	return (u + v - t) / (u * v);
+}
+
+double
+trapezoidalDistributionCDF(const TrapezoidalDistribution *  distribution, double x)
+{
+	double	u = distribution->smallerWidth;
+	double	v = distribution->largerWidth;
+	double	t = x - distribution->lowerBound;
+
+	if (t < 0)
+	{
+		return 0.0;
+	}
+
+	if (t >= u + v)
+	{
+		return 1.0;
+	}
+
+	/*
+	 *	Rising edge, plateau and falling edge of the trapezoid. When the smaller
+	 *	width is zero, only the plateau remains (a uniform distribution).
+	 */
+	if (t < u)
+	{
+		return (t * t) / (2 * u * v);
+	}
+
+	if (t <= v)
+	{
+		return (t - u / 2) / v;
+	}
+
+	return 1.0 - ((u + v - t) * (u + v - t)) / (2 * u * v);
+}
+
+double
+trapezoidalDistributionQuantile(const TrapezoidalDistribution *  distribution, double probability)
+{
+	double	u = distribution->smallerWidth;
+	double	v = distribution->largerWidth;
+	double	p = fmin(fmax(probability, 0.0), 1.0);
+	double	t;
+
+	if (v == 0)
+	{
+		t = 0;
+	}
+	else if (p < u / (2 * v))
+	{
+		t = sqrt(2 * u * v * p);
+	}
+	else if (p <= 1 - u / (2 * v))
+	{
+		t = p * v + u / 2;
+	}
+	else
+	{
+		t = u + v - sqrt(2 * u * v * (1 - p));
+	}
+
+	return distribution->lowerBound + t;
+}
+
+double
+trapezoidalDistributionQuantileIntegral(const TrapezoidalDistribution *  distribution, double probability)
+{
+	double	u = distribution->smallerWidth;
+	double	v = distribution->largerWidth;
+	double	p = fmin(fmax(probability, 0.0), 1.0);
+	double	p1 = (v == 0) ? 0 : u / (2 * v);
+	double	integral;
+
+	/*
+	 *	Integrates each part of trapezoidalDistributionQuantile() in turn, relative
+	 *	to the lower bound. On the falling edge, the integral is that over [0, 1],
+	 *	(u + v) / 2, less that over [p, 1].
+	 */
+	if (v == 0)
+	{
+		integral = 0;
+	}
+	else if (p < p1)
+	{
+		integral = 2 * p * sqrt(2 * u * v * p) / 3;
+	}
+	else if (p <= 1 - p1)
+	{
+		integral = (u * u) / (3 * v) + v * (p * p - p1 * p1) / 2 + u * (p - p1) / 2;
+	}
+	else
+	{
+		integral = (u + v) / 2 - (u + v) * (1 - p) + 2 * (1 - p) * sqrt(2 * u * v * (1 - p)) / 3;
+	}
+
+	return p * distribution->lowerBound + integral;
+}
+
+double
+trapezoidalDistributionMean(const TrapezoidalDistribution *  distribution)
+{
+	return distribution->lowerBound + (distribution->smallerWidth + distribution->largerWidth) / 2;
+}
+
+double
+trapezoidalDistributionVariance(const TrapezoidalDistribution *  distribution)
+{
+	double	u = distribution->smallerWidth;
+	double	v = distribution->largerWidth;
+
+	return (u * u + v * v) / 12;
+}
+
+void
+summarizeTrapezoidalDistribution(const TrapezoidalDistribution *  distribution, DistributionSummary *  summary)
+{
+	summary->numberOfSamples = 0;
+	summary->mean = trapezoidalDistributionMean(distribution);
+	summary->variance = trapezoidalDistributionVariance(distribution);
+	summary->minimum = distribution->lowerBound;
+	summary->maximum = distribution->lowerBound + distribution->smallerWidth + distribution->largerWidth;
+
+	for (size_t i = 0; i < kDistributionSummaryConstantNumberOfQuantiles; i++)
+	{
+		summary->quantiles[i] = trapezoidalDistributionQuantile(distribution, kDistributionSummaryQuantileProbabilities[i]);
+	}
+
+	return;
+}
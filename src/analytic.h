@@ -0,0 +1,118 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include "distribution-summary.h"
+
+/*
+ *	The distribution of the sum of two independent uniform random variables,
+ *	over [lowerBound, lowerBound + smallerWidth] and [0, largerWidth]. Its PDF
+ *	is a trapezoid (a triangle when both widths are equal) with support
+ *	[lowerBound, lowerBound + smallerWidth + largerWidth].
+ *
+ *	The calibrated sensor output (Vout - Vref) / S, for uniform Vout and Vref,
+ *	has this distribution.
+ */
+typedef struct
+{
+	double	lowerBound;
+	double	smallerWidth;
+	double	largerWidth;
+} TrapezoidalDistribution;
+
+/**
+ *	@brief	Get the exact distribution of (Vout - Vref) / sensitivity, for Vout uniform
+ *		over [voutLow, voutHigh] and Vref uniform over [vrefLow, vrefHigh].
+ *
+ *	@param	voutLow		: Lower bound of Vout (in Volt).
+ *	@param	voutHigh	: Upper bound of Vout (in Volt).
+ *	@param	vrefLow		: Lower bound of Vref (in Volt).
+ *	@param	vrefHigh	: Upper bound of Vref (in Volt).
+ *	@param	sensitivity	: Sensitivity of the sensor (in Volt per Ampere). Must be non-zero.
+ *	@return			: The distribution of the calibrated sensor output (in Ampere).
+ */
+TrapezoidalDistribution	makeCalibratedOutputDistribution(double voutLow, double voutHigh, double vrefLow, double vrefHigh, double sensitivity);
+
+/**
+ *	@brief	Evaluate the probability density function.
+ *
+ *	@param	distribution	: The distribution.
+ *	@param	x		: The point to evaluate at.
+ *	@return			: The probability density at `x`. Infinite at the point of a
+ *				  distribution with zero widths.
+ */
+double	trapezoidalDistributionPDF(const TrapezoidalDistribution *  distribution, double x);
+
+/**
+ *	@brief	Evaluate the cumulative distribution function, P(X <= x).
+ *
+ *	@param	distribution	: The distribution.
+ *	@param	x		: The point to evaluate at.
+ *	@return			: The probability that the random variable is at most `x`.
+ */
+double	trapezoidalDistributionCDF(const TrapezoidalDistribution *  distribution, double x);
+
+/**
+ *	@brief	Evaluate the quantile function (inverse CDF).
+ *
+ *	@param	distribution	: The distribution.
+ *	@param	probability	: The probability, in [0, 1].
+ *	@return			: The smallest `x` with P(X <= x) >= `probability`.
+ */
+double	trapezoidalDistributionQuantile(const TrapezoidalDistribution *  distribution, double probability);
+
+/**
+ *	@brief	Integrate the quantile function from 0 to `probability`. This is the mean of the
+ *		lowest `probability` fraction of the distribution, times `probability`, and
+ *		gives the exact Wasserstein distance of a sample set to the distribution.
+ *
+ *	@param	distribution	: The distribution.
+ *	@param	probability	: The upper limit of the integral, in [0, 1].
+ *	@return			: The integral of the quantile function over [0, `probability`].
+ */
+double	trapezoidalDistributionQuantileIntegral(const TrapezoidalDistribution *  distribution, double probability);
+
+/**
+ *	@brief	Get the mean of the distribution.
+ *
+ *	@param	distribution	: The distribution.
+ *	@return			: The mean.
+ */
+double	trapezoidalDistributionMean(const TrapezoidalDistribution *  distribution);
+
+/**
+ *	@brief	Get the variance of the distribution.
+ *
+ *	@param	distribution	: The distribution.
+ *	@return			: The variance.
+ */
+double	trapezoidalDistributionVariance(const TrapezoidalDistribution *  distribution);
+
+/**
+ *	@brief	Fill a distribution summary with exact values. The summary's `numberOfSamples`
+ *		is zero, marking it as exact rather than estimated from samples.
+ *
+ *	@param	distribution	: The distribution.
+ *	@param	summary		: Where to write the summary.
+ */
+void	summarizeTrapezoidalDistribution(const TrapezoidalDistribution *  distribution, DistributionSummary *  summary);
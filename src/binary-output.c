@@ -0,0 +1,145 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binary-output.h"
+
+static const char	kBinaryOutputMagic[8] = {'T', 'M', 'C', 'S', 'S', 'M', 'P', '\0'};
+
+static bool
+isHostLittleEndian(void)
+{
+	const uint16_t	probe = 1;
+	uint8_t		firstByte;
+
+	memcpy(&firstByte, &probe, 1);
+
+	return firstByte == 1;
+}
+
+static void
+encodeLittleEndianUint64(unsigned char *  bytes, uint64_t value)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	return;
+}
+
+static void
+encodeLittleEndianUint32(unsigned char *  bytes, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		bytes[i] = (unsigned char)(value >> (8 * i));
+	}
+
+	return;
+}
+
+/*
+ *	Writes the samples from a big-endian host, one byte-swapped chunk at a time.
+ */
+static bool
+writeSamplesByteSwapped(FILE *  file, const double *  samples, uint64_t numberOfSamples)
+{
+	unsigned char *	chunk = checkedMalloc(kBinaryOutputConstantChunkSize * sizeof(double), __FILE__, __LINE__);
+	bool		isWritten = true;
+
+	for (uint64_t i = 0; i < numberOfSamples; i += kBinaryOutputConstantChunkSize)
+	{
+		uint64_t	count = numberOfSamples - i;
+
+		count = (count < kBinaryOutputConstantChunkSize) ? count : kBinaryOutputConstantChunkSize;
+		for (uint64_t j = 0; j < count; j++)
+		{
+			uint64_t	bits;
+
+			memcpy(&bits, &samples[i + j], sizeof(bits));
+			encodeLittleEndianUint64(&chunk[j * sizeof(double)], bits);
+		}
+
+		if (fwrite(chunk, sizeof(double), (size_t)count, file) != count)
+		{
+			isWritten = false;
+			break;
+		}
+	}
+	free(chunk);
+
+	return isWritten;
+}
+
+CommonConstantReturnType
+saveMonteCarloDoubleDataToDataDotBinFile(
+	const double *	samples,
+	uint64_t	cpuTimeMicroseconds,
+	uint64_t	numberOfSamples,
+	uint64_t	seed,
+	bool		isSeedValid)
+{
+	unsigned char	header[kBinaryOutputConstantHeaderSize];
+	FILE *		file;
+	bool		isWritten;
+
+	file = fopen(kBinaryOutputFilePath, "wb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open \"%s\" for writing.\n", kBinaryOutputFilePath);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	The samples are already in one contiguous buffer, so stdio buffering
+	 *	would only add a copy.
+	 */
+	setvbuf(file, NULL, _IONBF, 0);
+
+	memcpy(&header[0], kBinaryOutputMagic, sizeof(kBinaryOutputMagic));
+	encodeLittleEndianUint32(&header[8], kBinaryOutputConstantVersion);
+	encodeLittleEndianUint32(&header[12], isSeedValid ? kBinaryOutputConstantFlagSeedIsValid : 0);
+	encodeLittleEndianUint64(&header[16], cpuTimeMicroseconds);
+	encodeLittleEndianUint64(&header[24], numberOfSamples);
+	encodeLittleEndianUint64(&header[32], isSeedValid ? seed : 0);
+
+	isWritten = (fwrite(header, 1, sizeof(header), file) == sizeof(header));
+	if (isWritten)
+	{
+		isWritten = isHostLittleEndian() ?
+				(fwrite(samples, sizeof(double), (size_t)numberOfSamples, file) == numberOfSamples) :
+				writeSamplesByteSwapped(file, samples, numberOfSamples);
+	}
+
+	if ((fclose(file) != 0) || !isWritten)
+	{
+		fprintf(stderr, "Error: Could not write \"%s\".\n", kBinaryOutputFilePath);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
@@ -0,0 +1,69 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "common.h"
+
+/*
+ *	Layout of `data.bin`. All fields are little-endian.
+ *
+ *		Offset	Size	Field
+ *		0	8	Magic `TMCSSMP\0`
+ *		8	4	Format version (`uint32`, currently 1)
+ *		12	4	Flags (`uint32`, bit 0 set if the seed field is valid)
+ *		16	8	Time taken by the Monte Carlo evaluation, in microseconds (`uint64`)
+ *		24	8	Number of samples (`uint64`)
+ *		32	8	Seed of the random streams (`uint64`)
+ *		40	8 * N	The samples (IEEE-754 `double`)
+ */
+typedef enum
+{
+	kBinaryOutputConstantHeaderSize		= 40,
+	kBinaryOutputConstantVersion		= 1,
+	kBinaryOutputConstantFlagSeedIsValid	= 1 << 0,
+	kBinaryOutputConstantChunkSize		= 1 << 17,
+} BinaryOutputConstant;
+
+#define kBinaryOutputFilePath	"data.bin"
+
+/**
+ *	@brief	Save the Monte Carlo samples to `data.bin`, the binary counterpart of
+ *		`saveMonteCarloDoubleDataToDataDotOutFile()`. On little-endian hosts, the
+ *		samples are written straight from `samples` in large unbuffered writes.
+ *
+ *	@param	samples			: The samples.
+ *	@param	cpuTimeMicroseconds	: Time taken by the Monte Carlo evaluation, in microseconds.
+ *	@param	numberOfSamples		: The number of samples.
+ *	@param	seed			: The seed of the random streams that generated the samples.
+ *	@param	isSeedValid		: `false` if the samples did not come from a seeded generator.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	saveMonteCarloDoubleDataToDataDotBinFile(
+					const double *	samples,
+					uint64_t	cpuTimeMicroseconds,
+					uint64_t	numberOfSamples,
+					uint64_t	seed,
+					bool		isSeedValid);
@@ -0,0 +1,156 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compact-distribution.h"
+
+void
+buildCompactDistribution(const double *  samples, size_t numberOfSamples, CompactDistributionBuilder *  builder)
+{
+	StreamingHistogram *	histogram = checkedMalloc(sizeof(StreamingHistogram), __FILE__, __LINE__);
+
+	builder->histogram = histogram;
+	builder->binSums = checkedMalloc(kCompactDistributionConstantFineBins * sizeof(double), __FILE__, __LINE__);
+	memset(builder->binSums, 0, kCompactDistributionConstantFineBins * sizeof(double));
+
+	/*
+	 *	All the samples are known, so the range of the histogram is set once,
+	 *	and the sums are accumulated in a second pass over the final bins.
+	 */
+	initializeStreamingHistogram(histogram);
+	updateStreamingHistogramBlock(histogram, samples, numberOfSamples);
+	for (size_t i = 0; i < numberOfSamples; i++)
+	{
+		if (isfinite(samples[i]))
+		{
+			builder->binSums[getStreamingHistogramBin(histogram, samples[i])] += samples[i];
+		}
+	}
+
+	return;
+}
+
+void
+freeCompactDistribution(CompactDistributionBuilder *  builder)
+{
+	free(builder->histogram);
+	free(builder->binSums);
+	builder->histogram = NULL;
+	builder->binSums = NULL;
+
+	return;
+}
+
+void
+getCompactHistogram(const CompactDistributionBuilder *  builder, size_t numberOfBins, double *  binEdges, uint64_t *  binCounts)
+{
+	const StreamingHistogram *	histogram = builder->histogram;
+	double				width = (histogram->maximum - histogram->minimum) / (double)numberOfBins;
+
+	for (size_t i = 0; i <= numberOfBins; i++)
+	{
+		binEdges[i] = histogram->minimum + (double)i * width;
+	}
+	binEdges[numberOfBins] = histogram->maximum;
+	memset(binCounts, 0, numberOfBins * sizeof(uint64_t));
+
+	/*
+	 *	Each fine bin goes to the output bin that contains the mean of its samples.
+	 */
+	for (size_t i = 0; i < kCompactDistributionConstantFineBins; i++)
+	{
+		double	mean;
+		size_t	bin;
+
+		if (histogram->binCounts[i] == 0)
+		{
+			continue;
+		}
+
+		mean = builder->binSums[i] / (double)histogram->binCounts[i];
+		bin = (width > 0) ? (size_t)((mean - histogram->minimum) / width) : 0;
+		bin = (bin < numberOfBins) ? bin : numberOfBins - 1;
+		binCounts[bin] += histogram->binCounts[i];
+	}
+
+	return;
+}
+
+void
+getCompactQuantiles(const CompactDistributionBuilder *  builder, size_t numberOfQuantiles, double *  probabilities, double *  quantiles)
+{
+	for (size_t q = 0; q < numberOfQuantiles; q++)
+	{
+		probabilities[q] = (double)q / (double)(numberOfQuantiles - 1);
+	}
+	getStreamingHistogramQuantiles(builder->histogram, numberOfQuantiles, probabilities, quantiles);
+
+	quantiles[0] = builder->histogram->minimum;
+	quantiles[numberOfQuantiles - 1] = builder->histogram->maximum;
+
+	return;
+}
+
+size_t
+getCompactParticles(const CompactDistributionBuilder *  builder, size_t maxParticles, double *  positions, double *  weights)
+{
+	const StreamingHistogram *	histogram = builder->histogram;
+	size_t				numberOfParticles = 0;
+	uint64_t			groupCount = 0;
+	uint64_t			cumulativeCount = 0;
+	double				groupSum = 0.0;
+
+	for (size_t i = 0; i < kCompactDistributionConstantFineBins; i++)
+	{
+		if (histogram->binCounts[i] == 0)
+		{
+			continue;
+		}
+
+		groupCount += histogram->binCounts[i];
+		groupSum += builder->binSums[i];
+		cumulativeCount += histogram->binCounts[i];
+
+		/*
+		 *	Close the group once it reaches the next multiple of N / maxParticles.
+		 */
+		if ((double)cumulativeCount * (double)maxParticles >= (double)(numberOfParticles + 1) * (double)histogram->count)
+		{
+			positions[numberOfParticles] = groupSum / (double)groupCount;
+			weights[numberOfParticles] = (double)groupCount / (double)histogram->count;
+			numberOfParticles++;
+			groupCount = 0;
+			groupSum = 0.0;
+		}
+	}
+
+	if (groupCount > 0)
+	{
+		positions[numberOfParticles] = groupSum / (double)groupCount;
+		weights[numberOfParticles] = (double)groupCount / (double)histogram->count;
+		numberOfParticles++;
+	}
+
+	return numberOfParticles;
+}
@@ -0,0 +1,118 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "streaming-statistics.h"
+
+/*
+ *	The builder bins the samples into the lattice histogram of the streaming
+ *	statistics (`StreamingHistogram`), whose bin width is the smallest power of
+ *	two for which the range of the samples fits in its bins, and also keeps the
+ *	sum of the samples of each bin. The compact representations are derived
+ *	from these fine bins, so that the quantiles of `-J quantiles` are those the
+ *	summary of `-n` gives for the same samples.
+ */
+typedef enum
+{
+	kCompactDistributionConstantFineBins		= kStreamingStatisticsConstantNumberOfBins,
+	kCompactDistributionConstantDefaultSize		= 64,
+	kCompactDistributionConstantMaxSize		= 1024,
+} CompactDistributionConstant;
+
+/*
+ *	Compact representations:
+ *		kCompactRepresentationHistogram	: Equal-width bins over [minimum, maximum] and their sample counts.
+ *		kCompactRepresentationQuantiles	: Quantiles at equally-spaced probabilities in [0, 1].
+ *		kCompactRepresentationParticles	: Weighted particles (Dirac deltas) of roughly equal
+ *						  probability mass, each at the mean of the samples it represents.
+ */
+typedef enum
+{
+	kCompactRepresentationNone		= 0,
+	kCompactRepresentationHistogram		= 1,
+	kCompactRepresentationQuantiles		= 2,
+	kCompactRepresentationParticles		= 3,
+} CompactRepresentationKind;
+
+typedef struct
+{
+	/*
+	 *	The fine bins: their counts, and the sums of their samples, indexed alike.
+	 *	Only finite samples are binned.
+	 */
+	StreamingHistogram *	histogram;
+	double *		binSums;
+} CompactDistributionBuilder;
+
+/**
+ *	@brief	Build the fine histogram of a set of samples.
+ *
+ *	@param	samples		: The samples.
+ *	@param	numberOfSamples	: The number of samples. At least one must be finite.
+ *	@param	builder		: Where to write the fine histogram.
+ */
+void	buildCompactDistribution(const double *  samples, size_t numberOfSamples, CompactDistributionBuilder *  builder);
+
+/**
+ *	@brief	Release the memory of a builder.
+ *
+ *	@param	builder		: The builder.
+ */
+void	freeCompactDistribution(CompactDistributionBuilder *  builder);
+
+/**
+ *	@brief	Get a histogram of `numberOfBins` equal-width bins over [minimum, maximum].
+ *
+ *	@param	builder		: The builder.
+ *	@param	numberOfBins	: The number of bins.
+ *	@param	binEdges	: Where to write the `numberOfBins + 1` bin edges.
+ *	@param	binCounts	: Where to write the `numberOfBins` sample counts.
+ */
+void	getCompactHistogram(const CompactDistributionBuilder *  builder, size_t numberOfBins, double *  binEdges, uint64_t *  binCounts);
+
+/**
+ *	@brief	Get quantiles at the probabilities i / (numberOfQuantiles - 1), for i in
+ *		[0, numberOfQuantiles), interpolating linearly within fine bins.
+ *
+ *	@param	builder			: The builder.
+ *	@param	numberOfQuantiles	: The number of quantiles, at least 2.
+ *	@param	probabilities		: Where to write the probabilities.
+ *	@param	quantiles		: Where to write the quantiles.
+ */
+void	getCompactQuantiles(const CompactDistributionBuilder *  builder, size_t numberOfQuantiles, double *  probabilities, double *  quantiles);
+
+/**
+ *	@brief	Get at most `maxParticles` weighted particles. Fine bins are grouped into
+ *		particles of roughly equal probability mass; fewer particles are returned
+ *		when there are fewer non-empty fine bins.
+ *
+ *	@param	builder		: The builder.
+ *	@param	maxParticles	: The maximum number of particles.
+ *	@param	positions	: Where to write the particle positions.
+ *	@param	weights		: Where to write the particle weights, which sum to 1.
+ *	@return			: The number of particles written.
+ */
+size_t	getCompactParticles(const CompactDistributionBuilder *  builder, size_t maxParticles, double *  positions, double *  weights);
@@ -1,4 +1,26 @@
 SOURCES =\
 	main.c\
 	common.c\
-	utilities.c
+	utilities.c\
+	record-stream.c\
+	random.c\
+	thread-pool.c\
+	monte-carlo.c\
+	conversion-kernels.c\
+	streaming-statistics.c\
+	analytic.c\
+	sample-query.c\
+	binary-output.c\
+	compact-distribution.c\
+	phase-timing.c\
+	sensor-variants.c\
+	sensor-array.c\
+	quasi-random.c\
+	convergence.c\
+	conversion-server.c\
+	result-cache.c\
+	adc-codes.c\
+	latency-histogram.c\
+	overcurrent-detector.c\
+	sample-reduction.c\
+	sliding-window.c
@@ -0,0 +1,117 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "convergence.h"
+
+bool
+checkConvergence(
+	const double *			samples,
+	size_t				numberOfSamples,
+	const ConvergenceTarget *	target,
+	const SampleQueryList *		queries,
+	ConvergenceReport *		report)
+{
+	MeanAndVariance		meanAndVariance = calculateMeanAndVarianceOfDoubleSamples((double *)samples, numberOfSamples);
+	double			n = (double)numberOfSamples;
+	SampleQueryIndex	index;
+	bool			isIndexBuilt = false;
+
+	report->numberOfIterations = numberOfSamples;
+	report->meanWidth = 2 * kConvergenceNormalQuantile975 * sqrt(meanAndVariance.variance / n);
+	report->maximumQuantileWidth = 0.0;
+	report->maximumProbabilityWidth = 0.0;
+
+	for (size_t i = 0; i < queries->numberOfQueries; i++)
+	{
+		const SampleQuery *	query = &queries->queries[i];
+
+		if (!isIndexBuilt)
+		{
+			buildSampleQueryIndex(samples, numberOfSamples, &index);
+			isIndexBuilt = true;
+		}
+
+		if (query->kind == kSampleQueryKindQuantile)
+		{
+			double	p = query->value;
+			double	rankSpread = kConvergenceNormalQuantile975 * sqrt(n * p * (1 - p));
+			double	lower = sampleQueryIndexQuantile(&index, fmax(p - rankSpread / n, 0.0));
+			double	upper = sampleQueryIndexQuantile(&index, fmin(p + rankSpread / n, 1.0));
+
+			report->maximumQuantileWidth = fmax(report->maximumQuantileWidth, upper - lower);
+		}
+		else
+		{
+			/*
+			 *	The Wald interval, with the probability kept away from 0 and 1 by
+			 *	one sample, so that a threshold no sample has crossed yet does
+			 *	not look converged.
+			 */
+			double	p = fmin(fmax(sampleQueryIndexCDF(&index, query->value), 1 / n), 1 - 1 / n);
+
+			report->maximumProbabilityWidth = fmax(
+								report->maximumProbabilityWidth,
+								2 * kConvergenceNormalQuantile975 * sqrt(p * (1 - p) / n));
+		}
+	}
+
+	if (isIndexBuilt)
+	{
+		freeSampleQueryIndex(&index);
+	}
+
+	report->hasConverged = (report->meanWidth <= target->width) &&
+				(report->maximumQuantileWidth <= target->width) &&
+				((target->probabilityWidth <= 0) || (report->maximumProbabilityWidth <= target->probabilityWidth));
+
+	return report->hasConverged;
+}
+
+void
+printConvergenceReport(const ConvergenceReport *  report, const ConvergenceTarget *  target, size_t maximumIterations)
+{
+	printf("\n");
+	if (report->hasConverged)
+	{
+		printf("\tConverged after %zu iterations (at most %zu).\n", report->numberOfIterations, maximumIterations);
+	}
+	else
+	{
+		printf("\tDid not converge within %zu iterations.\n", maximumIterations);
+	}
+	printf("\tWidth of the 95%% confidence interval of the mean: %.6lf A (target %.6lf A)\n", report->meanWidth, target->width);
+	if (report->maximumQuantileWidth > 0)
+	{
+		printf("\tWidest 95%% confidence interval of a quantile: %.6lf A (target %.6lf A)\n", report->maximumQuantileWidth, target->width);
+	}
+	if (target->probabilityWidth > 0)
+	{
+		printf(
+			"\tWidest 95%% confidence interval of a probability: %.6lf (target %.6lf)\n",
+			report->maximumProbabilityWidth,
+			target->probabilityWidth);
+	}
+
+	return;
+}
@@ -0,0 +1,99 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common.h"
+#include "sample-query.h"
+
+/*
+ *	The adaptive mode (`-w` option) evaluates `kConvergenceConstantInitialIterations`
+ *	iterations, then doubles the number of iterations after each check, up to
+ *	the budget given with `-M`. Doubling keeps the total cost of the checks
+ *	(which sort the samples) within a constant factor of that of the last one.
+ */
+typedef enum
+{
+	kConvergenceConstantInitialIterations	= 1024,
+} ConvergenceConstant;
+
+/*
+ *	The standard normal quantile at 0.975, for 95% confidence intervals.
+ */
+#define kConvergenceNormalQuantile975		(1.959963984540054)
+
+/*
+ *	Target widths of the 95% confidence intervals:
+ *		width			: Of the mean and of the quantile queries (`-p`), in A.
+ *		probabilityWidth	: Of the probabilities of the threshold queries (`-q`).
+ *					  Zero if they are not checked.
+ */
+typedef struct
+{
+	double	width;
+	double	probabilityWidth;
+} ConvergenceTarget;
+
+typedef struct
+{
+	size_t	numberOfIterations;
+	bool	hasConverged;
+	double	meanWidth;
+
+	/*
+	 *	The widest confidence interval over the quantile and threshold queries.
+	 *	Zero if there are none.
+	 */
+	double	maximumQuantileWidth;
+	double	maximumProbabilityWidth;
+} ConvergenceReport;
+
+/**
+ *	@brief	Estimate the 95% confidence interval widths of the mean and of the queries
+ *		from the samples so far, and check them against the target. The quantile
+ *		intervals are distribution-free, between the order statistics whose ranks
+ *		bound the binomial 95% interval of the quantile's rank.
+ *
+ *	@param	samples		: The samples so far.
+ *	@param	numberOfSamples	: The number of samples. Must be non-zero.
+ *	@param	target		: The target widths.
+ *	@param	queries		: The threshold and quantile queries.
+ *	@param	report		: Where to write the widths and whether they meet the target.
+ *	@return			: `report->hasConverged`.
+ */
+bool	checkConvergence(
+		const double *			samples,
+		size_t				numberOfSamples,
+		const ConvergenceTarget *	target,
+		const SampleQueryList *		queries,
+		ConvergenceReport *		report);
+
+/**
+ *	@brief	Print the iterations used and the achieved confidence interval widths.
+ *
+ *	@param	report		: The report of the last check.
+ *	@param	target		: The target widths.
+ *	@param	maximumIterations	: The iteration budget.
+ */
+void	printConvergenceReport(const ConvergenceReport *  report, const ConvergenceTarget *  target, size_t maximumIterations);
@@ -0,0 +1,1322 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "conversion-kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_X86_KERNEL_DISPATCH	1
+#include <immintrin.h>
+#endif
+
+/*
+ *	Random bits to a double in [0, 1): the top 52 bits become the mantissa of a
+ *	double in [1, 2), from which 1 is subtracted. Unlike an integer-to-double
+ *	conversion, this maps directly onto AVX2 instructions.
+ */
+#define kConversionKernelsExponentOfOne		(0x3FF0000000000000ULL)
+
+static inline uint64_t
+rotateLeft(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+/*
+ *	Steps every lane, and writes the 64 random bits of each to `randomBits`.
+ */
+static inline void
+nextRandomBitsScalar(RandomLaneStream *  stream, uint64_t *  randomBits)
+{
+	uint64_t (*s)[kRandomConstantLanes] = stream->state;
+
+	for (size_t j = 0; j < kRandomConstantLanes; j++)
+	{
+		uint64_t	t = s[1][j] << 17;
+
+		randomBits[j] = rotateLeft(s[1][j] * 5, 7) * 9;
+
+		s[2][j] ^= s[0][j];
+		s[3][j] ^= s[1][j];
+		s[1][j] ^= s[2][j];
+		s[0][j] ^= s[3][j];
+		s[2][j] ^= t;
+		s[3][j] = rotateLeft(s[3][j], 45);
+	}
+
+	return;
+}
+
+static void
+fillUniformLaneGroupScalar(RandomLaneStream *  stream, double *  group, double low, double width)
+{
+	uint64_t	randomBits[kRandomConstantLanes];
+
+	nextRandomBitsScalar(stream, randomBits);
+	for (size_t j = 0; j < kRandomConstantLanes; j++)
+	{
+		uint64_t	bits = (randomBits[j] >> 12) | kConversionKernelsExponentOfOne;
+		double		unit;
+
+		memcpy(&unit, &bits, sizeof(unit));
+		group[j] = low + width * (unit - 1.0);
+	}
+
+	return;
+}
+
+static void
+fillUniformBlockScalar(RandomLaneStream *  stream, double *  samples, size_t count, double low, double high)
+{
+	double	width = high - low;
+	size_t	i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		fillUniformLaneGroupScalar(stream, &samples[i], low, width);
+	}
+
+	if (i < count)
+	{
+		double	group[kRandomConstantLanes];
+
+		fillUniformLaneGroupScalar(stream, group, low, width);
+		memcpy(&samples[i], group, (count - i) * sizeof(double));
+	}
+
+	return;
+}
+
+static inline double
+unitFromBitsScalar(uint64_t randomBits)
+{
+	uint64_t	bits = (randomBits >> 12) | kConversionKernelsExponentOfOne;
+	double		unit;
+
+	memcpy(&unit, &bits, sizeof(unit));
+
+	return unit - 1.0;
+}
+
+static void
+fillPhiloxUnitBlockScalar(const PhiloxKey *  key, uint64_t firstIndex, double *  first, double *  second, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t	index = firstIndex + i;
+		uint32_t	counter[4] = {(uint32_t)index, (uint32_t)(index >> 32), 0, 0};
+		uint32_t	output[4];
+
+		philox4x32(key, counter, output);
+		first[i] = unitFromBitsScalar(((uint64_t)output[1] << 32) | output[0]);
+		second[i] = unitFromBitsScalar(((uint64_t)output[3] << 32) | output[2]);
+	}
+
+	return;
+}
+
+static void
+convertSensorOutputBlockScalar(
+	const double *	vout,
+	const double *	vref,
+	double *	calibratedCurrent,
+	size_t		count,
+	double		reciprocalSensitivity)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		calibratedCurrent[i] = (vout[i] - vref[i]) * reciprocalSensitivity;
+	}
+
+	return;
+}
+
+static void
+convertSensorArrayBlockScalar(
+	const double *	vout,
+	const double *	vref,
+	const double *	scale,
+	const double *	offset,
+	double *	calibratedCurrent,
+	size_t		count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		calibratedCurrent[i] = (vout[i] - vref[i]) * scale[i] - offset[i];
+	}
+
+	return;
+}
+
+/*
+ *	The error terms of `convertSensorOutputWithErrorsBlock`, in the order in which
+ *	they are drawn, and their uniform distributions, over [low, low + width), with
+ *	the temperature taken relative to the reference temperature. They are set up
+ *	once per block, the same way for every kernel.
+ */
+typedef enum
+{
+	kSensorErrorTermSensitivityError	= 0,
+	kSensorErrorTermOffsetError,
+	kSensorErrorTermTemperatureDeviation,
+	kSensorErrorTermSensitivityDrift,
+	kSensorErrorTermOffsetDrift,
+	kSensorErrorTermNonlinearity,
+	kSensorErrorTermMax,
+} SensorErrorTerm;
+
+typedef struct
+{
+	double	low[kSensorErrorTermMax];
+	double	width[kSensorErrorTermMax];
+	double	sensitivity;
+	double	reciprocalCurrentRange;
+} SensorErrorTerms;
+
+static void
+getSensorErrorTerms(const SensorErrorModel *  model, SensorErrorTerms *  terms)
+{
+	static const InputDistributionIndex	kSensorErrorTermInputs[kSensorErrorTermMax] =
+						{
+							[kSensorErrorTermSensitivityError]	= kInputDistributionIndexSensitivityError,
+							[kSensorErrorTermOffsetError]		= kInputDistributionIndexOffsetError,
+							[kSensorErrorTermTemperatureDeviation]	= kInputDistributionIndexTemperature,
+							[kSensorErrorTermSensitivityDrift]	= kInputDistributionIndexSensitivityDrift,
+							[kSensorErrorTermOffsetDrift]		= kInputDistributionIndexOffsetDrift,
+							[kSensorErrorTermNonlinearity]		= kInputDistributionIndexNonlinearity,
+						};
+
+	for (size_t t = 0; t < kSensorErrorTermMax; t++)
+	{
+		terms->low[t] = model->low[kSensorErrorTermInputs[t]];
+		terms->width[t] = model->high[kSensorErrorTermInputs[t]] - model->low[kSensorErrorTermInputs[t]];
+	}
+	terms->low[kSensorErrorTermTemperatureDeviation] -= model->referenceTemperature;
+	terms->sensitivity = model->sensitivity;
+	terms->reciprocalCurrentRange = model->reciprocalCurrentRange;
+
+	return;
+}
+
+/*
+ *	The low and high 32 bits of random bits to doubles in [0, 1), exactly.
+ */
+static inline double
+unitFromLowHalfScalar(uint64_t randomBits)
+{
+	uint64_t	bits = ((randomBits << 32) >> 12) | kConversionKernelsExponentOfOne;
+	double		unit;
+
+	memcpy(&unit, &bits, sizeof(unit));
+
+	return unit - 1.0;
+}
+
+static inline double
+unitFromHighHalfScalar(uint64_t randomBits)
+{
+	uint64_t	bits = ((randomBits >> 32) << 20) | kConversionKernelsExponentOfOne;
+	double		unit;
+
+	memcpy(&unit, &bits, sizeof(unit));
+
+	return unit - 1.0;
+}
+
+static void
+convertSensorOutputWithErrorsBlockScalar(
+	RandomLaneStream *		stream,
+	const double *			vout,
+	const double *			vref,
+	double *			calibratedCurrent,
+	size_t				count,
+	const SensorErrorModel *	model)
+{
+	SensorErrorTerms	terms;
+
+	getSensorErrorTerms(model, &terms);
+
+	for (size_t i = 0; i < count; i += kRandomConstantLanes)
+	{
+		uint64_t	randomBits[3][kRandomConstantLanes];
+		size_t		groupSize = (count - i < kRandomConstantLanes) ? count - i : kRandomConstantLanes;
+
+		for (size_t k = 0; k < 3; k++)
+		{
+			nextRandomBitsScalar(stream, randomBits[k]);
+		}
+
+		for (size_t j = 0; j < groupSize; j++)
+		{
+			double	unit[kSensorErrorTermMax] =
+				{
+					unitFromLowHalfScalar(randomBits[0][j]),
+					unitFromHighHalfScalar(randomBits[0][j]),
+					unitFromLowHalfScalar(randomBits[1][j]),
+					unitFromHighHalfScalar(randomBits[1][j]),
+					unitFromLowHalfScalar(randomBits[2][j]),
+					unitFromHighHalfScalar(randomBits[2][j]),
+				};
+			double	term[kSensorErrorTermMax];
+			double	temperatureDeviation;
+			double	offset;
+			double	gain;
+			double	linearCurrent;
+
+			for (size_t t = 0; t < kSensorErrorTermMax; t++)
+			{
+				term[t] = terms.low[t] + terms.width[t] * unit[t];
+			}
+
+			temperatureDeviation = term[kSensorErrorTermTemperatureDeviation];
+			offset = term[kSensorErrorTermOffsetError] + term[kSensorErrorTermOffsetDrift] * temperatureDeviation;
+			gain = terms.sensitivity * ((1.0 + term[kSensorErrorTermSensitivityError]) + term[kSensorErrorTermSensitivityDrift] * temperatureDeviation);
+			linearCurrent = ((vout[i + j] - vref[i + j]) - offset) / gain;
+			calibratedCurrent[i + j] = linearCurrent - term[kSensorErrorTermNonlinearity] * ((linearCurrent * linearCurrent) * terms.reciprocalCurrentRange);
+		}
+	}
+
+	return;
+}
+
+/*
+ *	Lane accumulators of the deviations pass of `accumulateMomentsBlock`.
+ */
+typedef struct
+{
+	_Alignas(64) double	sumOfSquaredDeviations[kRandomConstantLanes];
+	_Alignas(64) double	sumOfCubedDeviations[kRandomConstantLanes];
+	_Alignas(64) double	sumOfFourthPowerDeviations[kRandomConstantLanes];
+	_Alignas(64) double	minimum[kRandomConstantLanes];
+	_Alignas(64) double	maximum[kRandomConstantLanes];
+} MomentLanes;
+
+/*
+ *	Sums the lanes pairwise, ((0 + 1) + (2 + 3)) + ..., in the same order for every kernel.
+ */
+static double
+sumLanes(const double *  lanes)
+{
+	double	sums[kRandomConstantLanes];
+
+	memcpy(sums, lanes, sizeof(sums));
+	for (size_t width = kRandomConstantLanes / 2; width > 0; width /= 2)
+	{
+		for (size_t j = 0; j < width; j++)
+		{
+			sums[j] = sums[2 * j] + sums[2 * j + 1];
+		}
+	}
+
+	return sums[0];
+}
+
+static void
+initializeMomentLanes(MomentLanes *  lanes, double firstSample)
+{
+	for (size_t j = 0; j < kRandomConstantLanes; j++)
+	{
+		lanes->sumOfSquaredDeviations[j] = 0.0;
+		lanes->sumOfCubedDeviations[j] = 0.0;
+		lanes->sumOfFourthPowerDeviations[j] = 0.0;
+		lanes->minimum[j] = firstSample;
+		lanes->maximum[j] = firstSample;
+	}
+
+	return;
+}
+
+/*
+ *	The scalar passes over samples `first` to `count`, also used by the vector
+ *	kernels for the samples after the last whole group of lanes.
+ */
+static void
+sumSamplesScalar(const double *  samples, size_t first, size_t count, double *  laneSums)
+{
+	for (size_t i = first; i < count; i++)
+	{
+		laneSums[i % kRandomConstantLanes] += samples[i];
+	}
+
+	return;
+}
+
+static void
+accumulateDeviationsScalar(const double *  samples, size_t first, size_t count, double mean, MomentLanes *  lanes)
+{
+	for (size_t i = first; i < count; i++)
+	{
+		size_t	lane = i % kRandomConstantLanes;
+		double	deviation = samples[i] - mean;
+		double	squaredDeviation = deviation * deviation;
+
+		lanes->sumOfSquaredDeviations[lane] += squaredDeviation;
+		lanes->sumOfCubedDeviations[lane] += squaredDeviation * deviation;
+		lanes->sumOfFourthPowerDeviations[lane] += squaredDeviation * squaredDeviation;
+		lanes->minimum[lane] = (samples[i] < lanes->minimum[lane]) ? samples[i] : lanes->minimum[lane];
+		lanes->maximum[lane] = (samples[i] > lanes->maximum[lane]) ? samples[i] : lanes->maximum[lane];
+	}
+
+	return;
+}
+
+static void
+finishBlockMoments(size_t count, double mean, const MomentLanes *  lanes, BlockMoments *  moments)
+{
+	moments->count = count;
+	moments->mean = mean;
+	moments->sumOfSquaredDeviations = sumLanes(lanes->sumOfSquaredDeviations);
+	moments->sumOfCubedDeviations = sumLanes(lanes->sumOfCubedDeviations);
+	moments->sumOfFourthPowerDeviations = sumLanes(lanes->sumOfFourthPowerDeviations);
+	moments->minimum = lanes->minimum[0];
+	moments->maximum = lanes->maximum[0];
+	for (size_t j = 1; j < kRandomConstantLanes; j++)
+	{
+		moments->minimum = (lanes->minimum[j] < moments->minimum) ? lanes->minimum[j] : moments->minimum;
+		moments->maximum = (lanes->maximum[j] > moments->maximum) ? lanes->maximum[j] : moments->maximum;
+	}
+
+	return;
+}
+
+static void
+accumulateMomentsBlockScalar(const double *  samples, size_t count, BlockMoments *  moments)
+{
+	double		laneSums[kRandomConstantLanes] = {0};
+	MomentLanes	lanes;
+	double		mean;
+	size_t		i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		for (size_t j = 0; j < kRandomConstantLanes; j++)
+		{
+			laneSums[j] += samples[i + j];
+		}
+	}
+	sumSamplesScalar(samples, i, count, laneSums);
+	mean = sumLanes(laneSums) / (double)count;
+
+	initializeMomentLanes(&lanes, samples[0]);
+	accumulateDeviationsScalar(samples, 0, count, mean, &lanes);
+	finishBlockMoments(count, mean, &lanes, moments);
+
+	return;
+}
+
+#if defined(HAVE_X86_KERNEL_DISPATCH)
+__attribute__((target("avx2")))
+static inline __m256i
+rotateLeftAVX2(__m256i x, int k)
+{
+	return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+/*
+ *	Steps four lanes whose state words are held in `s`, and returns their random bits.
+ */
+__attribute__((target("avx2")))
+static inline __m256i
+stepRandomStateAVX2(__m256i s[4])
+{
+	__m256i		x = _mm256_add_epi64(_mm256_slli_epi64(s[1], 2), s[1]);
+	__m256i		r = rotateLeftAVX2(x, 7);
+	__m256i		t = _mm256_slli_epi64(s[1], 17);
+
+	r = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+
+	s[2] = _mm256_xor_si256(s[2], s[0]);
+	s[3] = _mm256_xor_si256(s[3], s[1]);
+	s[1] = _mm256_xor_si256(s[1], s[2]);
+	s[0] = _mm256_xor_si256(s[0], s[3]);
+	s[2] = _mm256_xor_si256(s[2], t);
+	s[3] = rotateLeftAVX2(s[3], 45);
+
+	return r;
+}
+
+__attribute__((target("avx2")))
+static inline void
+loadRandomStateAVX2(const RandomLaneStream *  stream, size_t lane, __m256i s[4])
+{
+	for (size_t w = 0; w < 4; w++)
+	{
+		s[w] = _mm256_load_si256((const __m256i *)&stream->state[w][lane]);
+	}
+
+	return;
+}
+
+__attribute__((target("avx2")))
+static inline void
+storeRandomStateAVX2(RandomLaneStream *  stream, size_t lane, const __m256i s[4])
+{
+	for (size_t w = 0; w < 4; w++)
+	{
+		_mm256_store_si256((__m256i *)&stream->state[w][lane], s[w]);
+	}
+
+	return;
+}
+
+/*
+ *	Steps four lanes, starting at lane `lane`, and returns their random bits.
+ */
+__attribute__((target("avx2")))
+static inline __m256i
+nextRandomBitsAVX2(RandomLaneStream *  stream, size_t lane)
+{
+	__m256i	s[4];
+	__m256i	r;
+
+	loadRandomStateAVX2(stream, lane, s);
+	r = stepRandomStateAVX2(s);
+	storeRandomStateAVX2(stream, lane, s);
+
+	return r;
+}
+
+/*
+ *	Steps four lanes, starting at lane `lane`, and returns their uniform samples.
+ */
+__attribute__((target("avx2")))
+static inline __m256d
+nextUniformAVX2(RandomLaneStream *  stream, size_t lane, __m256d low, __m256d width)
+{
+	__m256i	bits = _mm256_or_si256(
+				_mm256_srli_epi64(nextRandomBitsAVX2(stream, lane), 12),
+				_mm256_set1_epi64x((long long)kConversionKernelsExponentOfOne));
+	__m256d	unit = _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+
+	return _mm256_add_pd(low, _mm256_mul_pd(width, unit));
+}
+
+__attribute__((target("avx2")))
+static void
+fillUniformBlockAVX2(RandomLaneStream *  stream, double *  samples, size_t count, double low, double high)
+{
+	__m256d	lowVector = _mm256_set1_pd(low);
+	__m256d	widthVector = _mm256_set1_pd(high - low);
+	size_t	i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		_mm256_storeu_pd(&samples[i], nextUniformAVX2(stream, 0, lowVector, widthVector));
+		_mm256_storeu_pd(&samples[i + 4], nextUniformAVX2(stream, 4, lowVector, widthVector));
+	}
+
+	if (i < count)
+	{
+		_Alignas(32) double	group[kRandomConstantLanes];
+
+		_mm256_store_pd(&group[0], nextUniformAVX2(stream, 0, lowVector, widthVector));
+		_mm256_store_pd(&group[4], nextUniformAVX2(stream, 4, lowVector, widthVector));
+		memcpy(&samples[i], group, (count - i) * sizeof(double));
+	}
+
+	return;
+}
+
+/*
+ *	Philox4x32-10 of four counters, one per 64-bit lane, with each 32-bit word of
+ *	the counters and results held in the low half of a lane of `c[w]`.
+ */
+__attribute__((target("avx2")))
+static inline void
+philox4x32AVX2(const PhiloxKey *  key, __m256i c[4])
+{
+	__m256i	lowHalf = _mm256_set1_epi64x(0xFFFFFFFFLL);
+	__m256i	multiplier0 = _mm256_set1_epi64x(kPhiloxConstantMultiplier0);
+	__m256i	multiplier1 = _mm256_set1_epi64x(kPhiloxConstantMultiplier1);
+	uint32_t	k0 = key->key[0];
+	uint32_t	k1 = key->key[1];
+
+	for (int round = 0; round < kPhiloxConstantRounds; round++)
+	{
+		__m256i	product0 = _mm256_mul_epu32(c[0], multiplier0);
+		__m256i	product1 = _mm256_mul_epu32(c[2], multiplier1);
+
+		c[0] = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product1, 32), c[1]), _mm256_set1_epi64x(k0));
+		c[2] = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(product0, 32), c[3]), _mm256_set1_epi64x(k1));
+		c[1] = _mm256_and_si256(product1, lowHalf);
+		c[3] = _mm256_and_si256(product0, lowHalf);
+
+		k0 += kPhiloxConstantWeyl0;
+		k1 += kPhiloxConstantWeyl1;
+	}
+
+	return;
+}
+
+__attribute__((target("avx2")))
+static inline __m256d
+unitFromWordsAVX2(__m256i low, __m256i high)
+{
+	__m256i	bits = _mm256_or_si256(_mm256_slli_epi64(high, 32), low);
+
+	bits = _mm256_or_si256(_mm256_srli_epi64(bits, 12), _mm256_set1_epi64x((long long)kConversionKernelsExponentOfOne));
+
+	return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+__attribute__((target("avx2")))
+static void
+fillPhiloxUnitBlockAVX2(const PhiloxKey *  key, uint64_t firstIndex, double *  first, double *  second, size_t count)
+{
+	__m256i	index = _mm256_add_epi64(_mm256_set1_epi64x((long long)firstIndex), _mm256_setr_epi64x(0, 1, 2, 3));
+	size_t	i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256i	c[4] =
+			{
+				_mm256_and_si256(index, _mm256_set1_epi64x(0xFFFFFFFFLL)),
+				_mm256_srli_epi64(index, 32),
+				_mm256_setzero_si256(),
+				_mm256_setzero_si256(),
+			};
+
+		philox4x32AVX2(key, c);
+		_mm256_storeu_pd(&first[i], unitFromWordsAVX2(c[0], c[1]));
+		_mm256_storeu_pd(&second[i], unitFromWordsAVX2(c[2], c[3]));
+		index = _mm256_add_epi64(index, _mm256_set1_epi64x(4));
+	}
+
+	fillPhiloxUnitBlockScalar(key, firstIndex + i, &first[i], &second[i], count - i);
+
+	return;
+}
+
+__attribute__((target("avx2")))
+static void
+convertSensorOutputBlockAVX2(
+	const double *	vout,
+	const double *	vref,
+	double *	calibratedCurrent,
+	size_t		count,
+	double		reciprocalSensitivity)
+{
+	__m256d	reciprocal = _mm256_set1_pd(reciprocalSensitivity);
+	size_t	i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d	difference = _mm256_sub_pd(_mm256_loadu_pd(&vout[i]), _mm256_loadu_pd(&vref[i]));
+
+		_mm256_storeu_pd(&calibratedCurrent[i], _mm256_mul_pd(difference, reciprocal));
+	}
+
+	convertSensorOutputBlockScalar(&vout[i], &vref[i], &calibratedCurrent[i], count - i, reciprocalSensitivity);
+
+	return;
+}
+
+__attribute__((target("avx2")))
+static void
+convertSensorArrayBlockAVX2(
+	const double *	vout,
+	const double *	vref,
+	const double *	scale,
+	const double *	offset,
+	double *	calibratedCurrent,
+	size_t		count)
+{
+	size_t	i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m256d	difference = _mm256_sub_pd(_mm256_loadu_pd(&vout[i]), _mm256_loadu_pd(&vref[i]));
+		__m256d	scaled = _mm256_mul_pd(difference, _mm256_loadu_pd(&scale[i]));
+
+		_mm256_storeu_pd(&calibratedCurrent[i], _mm256_sub_pd(scaled, _mm256_loadu_pd(&offset[i])));
+	}
+
+	convertSensorArrayBlockScalar(&vout[i], &vref[i], &scale[i], &offset[i], &calibratedCurrent[i], count - i);
+
+	return;
+}
+
+/*
+ *	The error terms of `convertSensorOutputWithErrorsBlock`, broadcast to AVX2 vectors.
+ */
+typedef struct
+{
+	__m256d	low[kSensorErrorTermMax];
+	__m256d	width[kSensorErrorTermMax];
+	__m256d	sensitivity;
+	__m256d	reciprocalCurrentRange;
+} SensorErrorTermsAVX2;
+
+__attribute__((target("avx2")))
+static inline __m256d
+unitFromLowHalfAVX2(__m256i randomBits)
+{
+	__m256i	bits = _mm256_or_si256(
+				_mm256_srli_epi64(_mm256_slli_epi64(randomBits, 32), 12),
+				_mm256_set1_epi64x((long long)kConversionKernelsExponentOfOne));
+
+	return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+__attribute__((target("avx2")))
+static inline __m256d
+unitFromHighHalfAVX2(__m256i randomBits)
+{
+	__m256i	bits = _mm256_or_si256(
+				_mm256_slli_epi64(_mm256_srli_epi64(randomBits, 32), 20),
+				_mm256_set1_epi64x((long long)kConversionKernelsExponentOfOne));
+
+	return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+/*
+ *	Draws the error terms of four lanes, whose state words are held in `state`,
+ *	and converts their samples.
+ */
+__attribute__((target("avx2")))
+static inline __m256d
+convertSensorOutputWithErrorsAVX2(
+	__m256i				state[4],
+	__m256d				vout,
+	__m256d				vref,
+	const SensorErrorTermsAVX2 *	terms)
+{
+	__m256i	randomBits0 = stepRandomStateAVX2(state);
+	__m256i	randomBits1 = stepRandomStateAVX2(state);
+	__m256i	randomBits2 = stepRandomStateAVX2(state);
+	__m256d	unit[kSensorErrorTermMax] =
+		{
+			unitFromLowHalfAVX2(randomBits0),
+			unitFromHighHalfAVX2(randomBits0),
+			unitFromLowHalfAVX2(randomBits1),
+			unitFromHighHalfAVX2(randomBits1),
+			unitFromLowHalfAVX2(randomBits2),
+			unitFromHighHalfAVX2(randomBits2),
+		};
+	__m256d	term[kSensorErrorTermMax];
+	__m256d	temperatureDeviation;
+	__m256d	offset;
+	__m256d	gain;
+	__m256d	linearCurrent;
+	__m256d	bow;
+
+	for (size_t t = 0; t < kSensorErrorTermMax; t++)
+	{
+		term[t] = _mm256_add_pd(terms->low[t], _mm256_mul_pd(terms->width[t], unit[t]));
+	}
+
+	temperatureDeviation = term[kSensorErrorTermTemperatureDeviation];
+	offset = _mm256_add_pd(term[kSensorErrorTermOffsetError], _mm256_mul_pd(term[kSensorErrorTermOffsetDrift], temperatureDeviation));
+	gain = _mm256_mul_pd(
+			terms->sensitivity,
+			_mm256_add_pd(
+				_mm256_add_pd(_mm256_set1_pd(1.0), term[kSensorErrorTermSensitivityError]),
+				_mm256_mul_pd(term[kSensorErrorTermSensitivityDrift], temperatureDeviation)));
+	linearCurrent = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(vout, vref), offset), gain);
+	bow = _mm256_mul_pd(_mm256_mul_pd(linearCurrent, linearCurrent), terms->reciprocalCurrentRange);
+
+	return _mm256_sub_pd(linearCurrent, _mm256_mul_pd(term[kSensorErrorTermNonlinearity], bow));
+}
+
+__attribute__((target("avx2")))
+static void
+convertSensorOutputWithErrorsBlockAVX2(
+	RandomLaneStream *		stream,
+	const double *			vout,
+	const double *			vref,
+	double *			calibratedCurrent,
+	size_t				count,
+	const SensorErrorModel *	model)
+{
+	SensorErrorTerms	terms;
+	SensorErrorTermsAVX2	vectorTerms;
+	__m256i			lowLanes[4];
+	__m256i			highLanes[4];
+	size_t			i = 0;
+
+	getSensorErrorTerms(model, &terms);
+	for (size_t t = 0; t < kSensorErrorTermMax; t++)
+	{
+		vectorTerms.low[t] = _mm256_set1_pd(terms.low[t]);
+		vectorTerms.width[t] = _mm256_set1_pd(terms.width[t]);
+	}
+	vectorTerms.sensitivity = _mm256_set1_pd(terms.sensitivity);
+	vectorTerms.reciprocalCurrentRange = _mm256_set1_pd(terms.reciprocalCurrentRange);
+
+	/*
+	 *	The lanes stay in registers over the block, rather than going through the
+	 *	stream after every draw.
+	 */
+	loadRandomStateAVX2(stream, 0, lowLanes);
+	loadRandomStateAVX2(stream, 4, highLanes);
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		_mm256_storeu_pd(
+			&calibratedCurrent[i],
+			convertSensorOutputWithErrorsAVX2(lowLanes, _mm256_loadu_pd(&vout[i]), _mm256_loadu_pd(&vref[i]), &vectorTerms));
+		_mm256_storeu_pd(
+			&calibratedCurrent[i + 4],
+			convertSensorOutputWithErrorsAVX2(highLanes, _mm256_loadu_pd(&vout[i + 4]), _mm256_loadu_pd(&vref[i + 4]), &vectorTerms));
+	}
+	storeRandomStateAVX2(stream, 0, lowLanes);
+	storeRandomStateAVX2(stream, 4, highLanes);
+
+	/*
+	 *	The scalar kernel steps the lanes and rounds the same way.
+	 */
+	convertSensorOutputWithErrorsBlockScalar(stream, &vout[i], &vref[i], &calibratedCurrent[i], count - i, model);
+
+	return;
+}
+
+__attribute__((target("avx2")))
+static void
+accumulateMomentsBlockAVX2(const double *  samples, size_t count, BlockMoments *  moments)
+{
+	_Alignas(64) double	laneSums[kRandomConstantLanes];
+	MomentLanes		lanes;
+	__m256d			sums[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+	__m256d			squares[2];
+	__m256d			cubes[2];
+	__m256d			fourthPowers[2];
+	__m256d			minima[2];
+	__m256d			maxima[2];
+	__m256d			meanVector;
+	double			mean;
+	size_t			i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		sums[0] = _mm256_add_pd(sums[0], _mm256_loadu_pd(&samples[i]));
+		sums[1] = _mm256_add_pd(sums[1], _mm256_loadu_pd(&samples[i + 4]));
+	}
+	_mm256_store_pd(&laneSums[0], sums[0]);
+	_mm256_store_pd(&laneSums[4], sums[1]);
+	sumSamplesScalar(samples, i, count, laneSums);
+	mean = sumLanes(laneSums) / (double)count;
+
+	initializeMomentLanes(&lanes, samples[0]);
+	meanVector = _mm256_set1_pd(mean);
+	for (int h = 0; h < 2; h++)
+	{
+		squares[h] = _mm256_setzero_pd();
+		cubes[h] = _mm256_setzero_pd();
+		fourthPowers[h] = _mm256_setzero_pd();
+		minima[h] = _mm256_set1_pd(samples[0]);
+		maxima[h] = _mm256_set1_pd(samples[0]);
+	}
+
+	for (i = 0; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		for (int h = 0; h < 2; h++)
+		{
+			__m256d	sample = _mm256_loadu_pd(&samples[i + 4 * h]);
+			__m256d	deviation = _mm256_sub_pd(sample, meanVector);
+			__m256d	squaredDeviation = _mm256_mul_pd(deviation, deviation);
+
+			squares[h] = _mm256_add_pd(squares[h], squaredDeviation);
+			cubes[h] = _mm256_add_pd(cubes[h], _mm256_mul_pd(squaredDeviation, deviation));
+			fourthPowers[h] = _mm256_add_pd(fourthPowers[h], _mm256_mul_pd(squaredDeviation, squaredDeviation));
+			minima[h] = _mm256_min_pd(sample, minima[h]);
+			maxima[h] = _mm256_max_pd(sample, maxima[h]);
+		}
+	}
+
+	for (int h = 0; h < 2; h++)
+	{
+		_mm256_store_pd(&lanes.sumOfSquaredDeviations[4 * h], squares[h]);
+		_mm256_store_pd(&lanes.sumOfCubedDeviations[4 * h], cubes[h]);
+		_mm256_store_pd(&lanes.sumOfFourthPowerDeviations[4 * h], fourthPowers[h]);
+		_mm256_store_pd(&lanes.minimum[4 * h], minima[h]);
+		_mm256_store_pd(&lanes.maximum[4 * h], maxima[h]);
+	}
+	accumulateDeviationsScalar(samples, i, count, mean, &lanes);
+	finishBlockMoments(count, mean, &lanes, moments);
+
+	return;
+}
+
+/*
+ *	AVX-512F implies FMA, so the compiler may contract a multiply followed by an
+ *	add into a fused multiply-add, which rounds once and so differs from the other
+ *	kernels. Passing the product through an empty `asm` statement prevents that.
+ */
+__attribute__((target("avx512f")))
+static inline __m512d
+roundProductAVX512(__m512d product)
+{
+	__asm__("" : "+v"(product));
+
+	return product;
+}
+
+/*
+ *	Steps every lane of state words held in `s`, and returns their random bits.
+ */
+__attribute__((target("avx512f")))
+static inline __m512i
+stepRandomStateAVX512(__m512i s[4])
+{
+	__m512i		x = _mm512_add_epi64(_mm512_slli_epi64(s[1], 2), s[1]);
+	__m512i		r = _mm512_rol_epi64(x, 7);
+	__m512i		t = _mm512_slli_epi64(s[1], 17);
+
+	r = _mm512_add_epi64(_mm512_slli_epi64(r, 3), r);
+
+	s[2] = _mm512_xor_si512(s[2], s[0]);
+	s[3] = _mm512_xor_si512(s[3], s[1]);
+	s[1] = _mm512_xor_si512(s[1], s[2]);
+	s[0] = _mm512_xor_si512(s[0], s[3]);
+	s[2] = _mm512_xor_si512(s[2], t);
+	s[3] = _mm512_rol_epi64(s[3], 45);
+
+	return r;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512i
+nextRandomBitsAVX512(RandomLaneStream *  stream)
+{
+	__m512i	s[4];
+	__m512i	r;
+
+	for (size_t w = 0; w < 4; w++)
+	{
+		s[w] = _mm512_load_si512(&stream->state[w][0]);
+	}
+	r = stepRandomStateAVX512(s);
+	for (size_t w = 0; w < 4; w++)
+	{
+		_mm512_store_si512(&stream->state[w][0], s[w]);
+	}
+
+	return r;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d
+nextUniformAVX512(RandomLaneStream *  stream, __m512d low, __m512d width)
+{
+	__m512i	bits = _mm512_or_si512(
+				_mm512_srli_epi64(nextRandomBitsAVX512(stream), 12),
+				_mm512_set1_epi64((long long)kConversionKernelsExponentOfOne));
+	__m512d	unit = _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+
+	return _mm512_add_pd(low, roundProductAVX512(_mm512_mul_pd(width, unit)));
+}
+
+__attribute__((target("avx512f")))
+static void
+fillUniformBlockAVX512(RandomLaneStream *  stream, double *  samples, size_t count, double low, double high)
+{
+	__m512d	lowVector = _mm512_set1_pd(low);
+	__m512d	widthVector = _mm512_set1_pd(high - low);
+	size_t	i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		_mm512_storeu_pd(&samples[i], nextUniformAVX512(stream, lowVector, widthVector));
+	}
+
+	if (i < count)
+	{
+		_Alignas(64) double	group[kRandomConstantLanes];
+
+		_mm512_store_pd(group, nextUniformAVX512(stream, lowVector, widthVector));
+		memcpy(&samples[i], group, (count - i) * sizeof(double));
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static inline void
+philox4x32AVX512(const PhiloxKey *  key, __m512i c[4])
+{
+	__m512i	lowHalf = _mm512_set1_epi64(0xFFFFFFFFLL);
+	__m512i	multiplier0 = _mm512_set1_epi64(kPhiloxConstantMultiplier0);
+	__m512i	multiplier1 = _mm512_set1_epi64(kPhiloxConstantMultiplier1);
+	uint32_t	k0 = key->key[0];
+	uint32_t	k1 = key->key[1];
+
+	for (int round = 0; round < kPhiloxConstantRounds; round++)
+	{
+		__m512i	product0 = _mm512_mul_epu32(c[0], multiplier0);
+		__m512i	product1 = _mm512_mul_epu32(c[2], multiplier1);
+
+		c[0] = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product1, 32), c[1]), _mm512_set1_epi64(k0));
+		c[2] = _mm512_xor_si512(_mm512_xor_si512(_mm512_srli_epi64(product0, 32), c[3]), _mm512_set1_epi64(k1));
+		c[1] = _mm512_and_si512(product1, lowHalf);
+		c[3] = _mm512_and_si512(product0, lowHalf);
+
+		k0 += kPhiloxConstantWeyl0;
+		k1 += kPhiloxConstantWeyl1;
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d
+unitFromWordsAVX512(__m512i low, __m512i high)
+{
+	__m512i	bits = _mm512_or_si512(_mm512_slli_epi64(high, 32), low);
+
+	bits = _mm512_or_si512(_mm512_srli_epi64(bits, 12), _mm512_set1_epi64((long long)kConversionKernelsExponentOfOne));
+
+	return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+}
+
+__attribute__((target("avx512f")))
+static void
+fillPhiloxUnitBlockAVX512(const PhiloxKey *  key, uint64_t firstIndex, double *  first, double *  second, size_t count)
+{
+	__m512i	index = _mm512_add_epi64(_mm512_set1_epi64((long long)firstIndex), _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+	size_t	i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m512i	c[4] =
+			{
+				_mm512_and_si512(index, _mm512_set1_epi64(0xFFFFFFFFLL)),
+				_mm512_srli_epi64(index, 32),
+				_mm512_setzero_si512(),
+				_mm512_setzero_si512(),
+			};
+
+		philox4x32AVX512(key, c);
+		_mm512_storeu_pd(&first[i], unitFromWordsAVX512(c[0], c[1]));
+		_mm512_storeu_pd(&second[i], unitFromWordsAVX512(c[2], c[3]));
+		index = _mm512_add_epi64(index, _mm512_set1_epi64(8));
+	}
+
+	fillPhiloxUnitBlockScalar(key, firstIndex + i, &first[i], &second[i], count - i);
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static void
+convertSensorOutputBlockAVX512(
+	const double *	vout,
+	const double *	vref,
+	double *	calibratedCurrent,
+	size_t		count,
+	double		reciprocalSensitivity)
+{
+	__m512d	reciprocal = _mm512_set1_pd(reciprocalSensitivity);
+	size_t	i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m512d	difference = _mm512_sub_pd(_mm512_loadu_pd(&vout[i]), _mm512_loadu_pd(&vref[i]));
+
+		_mm512_storeu_pd(&calibratedCurrent[i], _mm512_mul_pd(difference, reciprocal));
+	}
+
+	if (i < count)
+	{
+		__mmask8	mask = (__mmask8)((1u << (count - i)) - 1);
+		__m512d		difference = _mm512_sub_pd(
+						_mm512_maskz_loadu_pd(mask, &vout[i]),
+						_mm512_maskz_loadu_pd(mask, &vref[i]));
+
+		_mm512_mask_storeu_pd(&calibratedCurrent[i], mask, _mm512_mul_pd(difference, reciprocal));
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static void
+convertSensorArrayBlockAVX512(
+	const double *	vout,
+	const double *	vref,
+	const double *	scale,
+	const double *	offset,
+	double *	calibratedCurrent,
+	size_t		count)
+{
+	size_t	i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m512d	difference = _mm512_sub_pd(_mm512_loadu_pd(&vout[i]), _mm512_loadu_pd(&vref[i]));
+		__m512d	scaled = roundProductAVX512(_mm512_mul_pd(difference, _mm512_loadu_pd(&scale[i])));
+
+		_mm512_storeu_pd(&calibratedCurrent[i], _mm512_sub_pd(scaled, _mm512_loadu_pd(&offset[i])));
+	}
+
+	if (i < count)
+	{
+		__mmask8	mask = (__mmask8)((1u << (count - i)) - 1);
+		__m512d		difference = _mm512_sub_pd(
+						_mm512_maskz_loadu_pd(mask, &vout[i]),
+						_mm512_maskz_loadu_pd(mask, &vref[i]));
+		__m512d		scaled = roundProductAVX512(_mm512_mul_pd(difference, _mm512_maskz_loadu_pd(mask, &scale[i])));
+
+		_mm512_mask_storeu_pd(&calibratedCurrent[i], mask, _mm512_sub_pd(scaled, _mm512_maskz_loadu_pd(mask, &offset[i])));
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d
+unitFromLowHalfAVX512(__m512i randomBits)
+{
+	__m512i	bits = _mm512_or_si512(
+				_mm512_srli_epi64(_mm512_slli_epi64(randomBits, 32), 12),
+				_mm512_set1_epi64((long long)kConversionKernelsExponentOfOne));
+
+	return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+}
+
+__attribute__((target("avx512f")))
+static inline __m512d
+unitFromHighHalfAVX512(__m512i randomBits)
+{
+	__m512i	bits = _mm512_or_si512(
+				_mm512_slli_epi64(_mm512_srli_epi64(randomBits, 32), 20),
+				_mm512_set1_epi64((long long)kConversionKernelsExponentOfOne));
+
+	return _mm512_sub_pd(_mm512_castsi512_pd(bits), _mm512_set1_pd(1.0));
+}
+
+/*
+ *	Draws the error terms of every lane, whose state words are held in `state`,
+ *	and converts their samples. Every product is rounded before it is added, as
+ *	in the other kernels.
+ */
+__attribute__((target("avx512f")))
+static inline __m512d
+convertSensorOutputWithErrorsAVX512(
+	__m512i				state[4],
+	__m512d				vout,
+	__m512d				vref,
+	const SensorErrorTerms *	terms)
+{
+	__m512i	randomBits0 = stepRandomStateAVX512(state);
+	__m512i	randomBits1 = stepRandomStateAVX512(state);
+	__m512i	randomBits2 = stepRandomStateAVX512(state);
+	__m512d	unit[kSensorErrorTermMax] =
+		{
+			unitFromLowHalfAVX512(randomBits0),
+			unitFromHighHalfAVX512(randomBits0),
+			unitFromLowHalfAVX512(randomBits1),
+			unitFromHighHalfAVX512(randomBits1),
+			unitFromLowHalfAVX512(randomBits2),
+			unitFromHighHalfAVX512(randomBits2),
+		};
+	__m512d	term[kSensorErrorTermMax];
+	__m512d	temperatureDeviation;
+	__m512d	offset;
+	__m512d	gain;
+	__m512d	linearCurrent;
+	__m512d	bow;
+
+	for (size_t t = 0; t < kSensorErrorTermMax; t++)
+	{
+		term[t] = _mm512_add_pd(
+				_mm512_set1_pd(terms->low[t]),
+				roundProductAVX512(_mm512_mul_pd(_mm512_set1_pd(terms->width[t]), unit[t])));
+	}
+
+	temperatureDeviation = term[kSensorErrorTermTemperatureDeviation];
+	offset = _mm512_add_pd(
+			term[kSensorErrorTermOffsetError],
+			roundProductAVX512(_mm512_mul_pd(term[kSensorErrorTermOffsetDrift], temperatureDeviation)));
+	gain = _mm512_mul_pd(
+			_mm512_set1_pd(terms->sensitivity),
+			_mm512_add_pd(
+				_mm512_add_pd(_mm512_set1_pd(1.0), term[kSensorErrorTermSensitivityError]),
+				roundProductAVX512(_mm512_mul_pd(term[kSensorErrorTermSensitivityDrift], temperatureDeviation))));
+	linearCurrent = _mm512_div_pd(_mm512_sub_pd(_mm512_sub_pd(vout, vref), offset), gain);
+	bow = _mm512_mul_pd(_mm512_mul_pd(linearCurrent, linearCurrent), _mm512_set1_pd(terms->reciprocalCurrentRange));
+
+	return _mm512_sub_pd(linearCurrent, roundProductAVX512(_mm512_mul_pd(term[kSensorErrorTermNonlinearity], bow)));
+}
+
+__attribute__((target("avx512f")))
+static void
+convertSensorOutputWithErrorsBlockAVX512(
+	RandomLaneStream *		stream,
+	const double *			vout,
+	const double *			vref,
+	double *			calibratedCurrent,
+	size_t				count,
+	const SensorErrorModel *	model)
+{
+	SensorErrorTerms	terms;
+	__m512i			state[4];
+	size_t			i = 0;
+
+	getSensorErrorTerms(model, &terms);
+
+	for (size_t w = 0; w < 4; w++)
+	{
+		state[w] = _mm512_load_si512(&stream->state[w][0]);
+	}
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		_mm512_storeu_pd(
+			&calibratedCurrent[i],
+			convertSensorOutputWithErrorsAVX512(state, _mm512_loadu_pd(&vout[i]), _mm512_loadu_pd(&vref[i]), &terms));
+	}
+
+	if (i < count)
+	{
+		__mmask8	mask = (__mmask8)((1u << (count - i)) - 1);
+
+		_mm512_mask_storeu_pd(
+			&calibratedCurrent[i],
+			mask,
+			convertSensorOutputWithErrorsAVX512(
+				state,
+				_mm512_maskz_loadu_pd(mask, &vout[i]),
+				_mm512_maskz_loadu_pd(mask, &vref[i]),
+				&terms));
+	}
+
+	for (size_t w = 0; w < 4; w++)
+	{
+		_mm512_store_si512(&stream->state[w][0], state[w]);
+	}
+
+	return;
+}
+
+__attribute__((target("avx512f")))
+static void
+accumulateMomentsBlockAVX512(const double *  samples, size_t count, BlockMoments *  moments)
+{
+	_Alignas(64) double	laneSums[kRandomConstantLanes];
+	MomentLanes		lanes;
+	__m512d			sum = _mm512_setzero_pd();
+	__m512d			squares = _mm512_setzero_pd();
+	__m512d			cubes = _mm512_setzero_pd();
+	__m512d			fourthPowers = _mm512_setzero_pd();
+	__m512d			minima = _mm512_set1_pd(samples[0]);
+	__m512d			maxima = _mm512_set1_pd(samples[0]);
+	__m512d			meanVector;
+	double			mean;
+	size_t			i = 0;
+
+	for (; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		sum = _mm512_add_pd(sum, _mm512_loadu_pd(&samples[i]));
+	}
+	_mm512_store_pd(laneSums, sum);
+	sumSamplesScalar(samples, i, count, laneSums);
+	mean = sumLanes(laneSums) / (double)count;
+
+	initializeMomentLanes(&lanes, samples[0]);
+	meanVector = _mm512_set1_pd(mean);
+	for (i = 0; i + kRandomConstantLanes <= count; i += kRandomConstantLanes)
+	{
+		__m512d	sample = _mm512_loadu_pd(&samples[i]);
+		__m512d	deviation = _mm512_sub_pd(sample, meanVector);
+		__m512d	squaredDeviation = roundProductAVX512(_mm512_mul_pd(deviation, deviation));
+
+		squares = _mm512_add_pd(squares, squaredDeviation);
+		cubes = _mm512_add_pd(cubes, roundProductAVX512(_mm512_mul_pd(squaredDeviation, deviation)));
+		fourthPowers = _mm512_add_pd(fourthPowers, roundProductAVX512(_mm512_mul_pd(squaredDeviation, squaredDeviation)));
+		minima = _mm512_min_pd(sample, minima);
+		maxima = _mm512_max_pd(sample, maxima);
+	}
+
+	_mm512_store_pd(lanes.sumOfSquaredDeviations, squares);
+	_mm512_store_pd(lanes.sumOfCubedDeviations, cubes);
+	_mm512_store_pd(lanes.sumOfFourthPowerDeviations, fourthPowers);
+	_mm512_store_pd(lanes.minimum, minima);
+	_mm512_store_pd(lanes.maximum, maxima);
+	accumulateDeviationsScalar(samples, i, count, mean, &lanes);
+	finishBlockMoments(count, mean, &lanes, moments);
+
+	return;
+}
+#endif /* defined(HAVE_X86_KERNEL_DISPATCH) */
+
+static const ConversionKernels	kConversionKernelsScalar =
+{
+	.isa				= kConversionKernelIsaScalar,
+	.name				= "scalar",
+	.fillUniformBlock		= fillUniformBlockScalar,
+	.fillPhiloxUnitBlock		= fillPhiloxUnitBlockScalar,
+	.convertSensorOutputBlock	= convertSensorOutputBlockScalar,
+	.convertSensorArrayBlock		= convertSensorArrayBlockScalar,
+	.convertSensorOutputWithErrorsBlock	= convertSensorOutputWithErrorsBlockScalar,
+	.accumulateMomentsBlock		= accumulateMomentsBlockScalar,
+};
+
+#if defined(HAVE_X86_KERNEL_DISPATCH)
+static const ConversionKernels	kConversionKernelsAVX2 =
+{
+	.isa				= kConversionKernelIsaAVX2,
+	.name				= "avx2",
+	.fillUniformBlock		= fillUniformBlockAVX2,
+	.fillPhiloxUnitBlock		= fillPhiloxUnitBlockAVX2,
+	.convertSensorOutputBlock	= convertSensorOutputBlockAVX2,
+	.convertSensorArrayBlock		= convertSensorArrayBlockAVX2,
+	.convertSensorOutputWithErrorsBlock	= convertSensorOutputWithErrorsBlockAVX2,
+	.accumulateMomentsBlock		= accumulateMomentsBlockAVX2,
+};
+
+static const ConversionKernels	kConversionKernelsAVX512 =
+{
+	.isa				= kConversionKernelIsaAVX512,
+	.name				= "avx512",
+	.fillUniformBlock		= fillUniformBlockAVX512,
+	.fillPhiloxUnitBlock		= fillPhiloxUnitBlockAVX512,
+	.convertSensorOutputBlock	= convertSensorOutputBlockAVX512,
+	.convertSensorArrayBlock		= convertSensorArrayBlockAVX512,
+	.convertSensorOutputWithErrorsBlock	= convertSensorOutputWithErrorsBlockAVX512,
+	.accumulateMomentsBlock		= accumulateMomentsBlockAVX512,
+};
+#endif
+
+const ConversionKernels *
+selectConversionKernels(ConversionKernelIsa isa)
+{
+#if defined(HAVE_X86_KERNEL_DISPATCH)
+	bool	hasAVX512 = __builtin_cpu_supports("avx512f");
+	bool	hasAVX2 = __builtin_cpu_supports("avx2");
+
+	switch (isa)
+	{
+		case kConversionKernelIsaAutomatic:
+			return hasAVX512 ? &kConversionKernelsAVX512 : (hasAVX2 ? &kConversionKernelsAVX2 : &kConversionKernelsScalar);
+		case kConversionKernelIsaAVX512:
+			return hasAVX512 ? &kConversionKernelsAVX512 : NULL;
+		case kConversionKernelIsaAVX2:
+			return hasAVX2 ? &kConversionKernelsAVX2 : NULL;
+		case kConversionKernelIsaScalar:
+			return &kConversionKernelsScalar;
+	}
+
+	return NULL;
+#else
+	return ((isa == kConversionKernelIsaAutomatic) || (isa == kConversionKernelIsaScalar)) ? &kConversionKernelsScalar : NULL;
+#endif
+}
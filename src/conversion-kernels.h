@@ -0,0 +1,131 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "random.h"
+#include "sensor-variants.h"
+
+/*
+ *	Instruction sets of the batched kernels. `kConversionKernelIsaAutomatic`
+ *	picks the widest one that the running CPU supports.
+ */
+typedef enum
+{
+	kConversionKernelIsaAutomatic	= 0,
+	kConversionKernelIsaScalar	= 1,
+	kConversionKernelIsaAVX2	= 2,
+	kConversionKernelIsaAVX512	= 3,
+} ConversionKernelIsa;
+
+/*
+ *	Central moments of a block of samples, about the mean of the block, as
+ *	accumulated by the `accumulateMomentsBlock` kernel.
+ */
+typedef struct
+{
+	size_t	count;
+	double	mean;
+	double	sumOfSquaredDeviations;
+	double	sumOfCubedDeviations;
+	double	sumOfFourthPowerDeviations;
+	double	minimum;
+	double	maximum;
+} BlockMoments;
+
+/*
+ *	Batched sampling and conversion kernels, operating on structure-of-arrays
+ *	buffers. Every implementation produces the same samples for the same lane
+ *	stream, as long as the scalar fallback is not compiled with floating-point
+ *	contraction into fused multiply-adds (e.g., `-ffp-contract=off` with `-march=native`).
+ *
+ *	fillUniformBlock		: Writes `count` samples of the uniform distribution over
+ *					  [low, high) to `samples`. Sample `g * kRandomConstantLanes + j`
+ *					  is the `g`-th draw of lane `j`. A trailing partial group still
+ *					  advances every lane by one draw.
+ *	fillPhiloxUnitBlock		: Writes, for `i` in [0, count), the two uniform samples over
+ *					  [0, 1) of draw `firstIndex + i` of the Philox generator keyed
+ *					  by `key` to `first[i]` and `second[i]`. Draw `n` is
+ *					  Philox4x32-10 of counter `n`: its low and high 64 bits
+ *					  give the two samples.
+ *	convertSensorOutputBlock	: Writes `(vout[i] - vref[i]) * reciprocalSensitivity`
+ *					  to `calibratedCurrent[i]`, for `i` in [0, count).
+ *	convertSensorArrayBlock		: Writes `(vout[i] - vref[i]) * scale[i] - offset[i]` to
+ *					  `calibratedCurrent[i]`, for `i` in [0, count), i.e., with
+ *					  a separate calibration for each channel `i` of a sensor array.
+ *	convertSensorOutputWithErrorsBlock	: Writes the calibrated current of `vout[i]` and `vref[i]`
+ *					  under the extended error model to `calibratedCurrent[i]`,
+ *					  for `i` in [0, count). Its six error terms are drawn from
+ *					  `stream`, two per draw, from its low and high 32 bits: one
+ *					  lane group of draws gives the sensitivity and offset errors,
+ *					  the next the temperature and sensitivity drift, and the last
+ *					  the offset drift and nonlinearity, of `kRandomConstantLanes`
+ *					  samples. A trailing partial group still advances every lane.
+ *	accumulateMomentsBlock		: Writes the moments of the `count` (at least one) samples
+ *					  to `moments`, in two passes over the block: the mean, then
+ *					  the sums of powers of the deviations from it. Sample `i` is
+ *					  accumulated in lane `i % kRandomConstantLanes`, and the lanes
+ *					  are summed pairwise, so every implementation gives the same moments.
+ */
+typedef struct
+{
+	ConversionKernelIsa	isa;
+	const char *		name;
+	void			(*fillUniformBlock)(RandomLaneStream *  stream, double *  samples, size_t count, double low, double high);
+	void			(*fillPhiloxUnitBlock)(
+					const PhiloxKey *  key,
+					uint64_t firstIndex,
+					double *  first,
+					double *  second,
+					size_t count);
+	void			(*convertSensorOutputBlock)(
+					const double *  vout,
+					const double *  vref,
+					double *  calibratedCurrent,
+					size_t count,
+					double reciprocalSensitivity);
+	void			(*convertSensorArrayBlock)(
+					const double *  vout,
+					const double *  vref,
+					const double *  scale,
+					const double *  offset,
+					double *  calibratedCurrent,
+					size_t count);
+	void			(*convertSensorOutputWithErrorsBlock)(
+					RandomLaneStream *  stream,
+					const double *  vout,
+					const double *  vref,
+					double *  calibratedCurrent,
+					size_t count,
+					const SensorErrorModel *  model);
+	void			(*accumulateMomentsBlock)(const double *  samples, size_t count, BlockMoments *  moments);
+} ConversionKernels;
+
+/**
+ *	@brief	Select the kernels for an instruction set.
+ *
+ *	@param	isa	: The requested instruction set.
+ *	@return		: The kernels, or `NULL` if the running CPU does not support `isa`.
+ */
+const ConversionKernels *	selectConversionKernels(ConversionKernelIsa isa);
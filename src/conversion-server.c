@@ -0,0 +1,743 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ENABLE_NATIVE_POSIX)
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "conversion-server.h"
+#include "monte-carlo.h"
+#include "sensor-variants.h"
+
+void
+initializeConversionRequest(ConversionRequest *  request, uint32_t numberOfIterations)
+{
+	*request = (ConversionRequest)
+	{
+		.magic = kConversionServerConstantMagicRequest,
+		.version = kConversionServerConstantVersion,
+		.frameSize = sizeof(ConversionRequest),
+		.sensorVariantIndex = kSensorVariantIndexTMCS1123x3A,
+		.numberOfIterations = numberOfIterations,
+		.numberOfThresholds = 0,
+		.reserved = 0,
+		.seed = kDefaultMonteCarloSeed,
+		.voutLow = kDefaultInputDistributionVoutUniformDistLow,
+		.voutHigh = kDefaultInputDistributionVoutUniformDistHigh,
+		.vrefLow = kDefaultInputDistributionVrefUniformDistLow,
+		.vrefHigh = kDefaultInputDistributionVrefUniformDistHigh,
+	};
+
+	return;
+}
+
+#if defined(ENABLE_NATIVE_POSIX)
+/*
+ *	Counts of the samples of a slice at or below each threshold of the request,
+ *	padded to a cache line so that workers do not share lines.
+ */
+typedef struct
+{
+	_Alignas(64) uint64_t	counts[kConversionServerConstantMaxThresholds];
+} ConversionServerSliceCounts;
+
+/*
+ *	The state kept between requests: the worker threads, their per-slice
+ *	buffers, and the request being evaluated.
+ */
+typedef struct
+{
+	ThreadPool *			pool;
+	const ConversionKernels *	kernels;
+	StreamingStatistics *		sliceStatistics;
+	ConversionServerSliceCounts *	sliceCounts;
+	const ConversionRequest *	request;
+	const SensorVariant *		sensorVariant;
+	PhiloxKey			philoxKey;
+	ResultCache *			resultCache;
+} ConversionServer;
+
+/*
+ *	A connected client, the part of its next request received so far, and the
+ *	responses not yet written to it. The connection is non-blocking: responses
+ *	wait in `responses` until the client reads them, and the server stops
+ *	reading requests from a client whose buffer is full, so that a client that
+ *	does not read cannot stall the others.
+ */
+typedef struct
+{
+	int			connection;
+	size_t			numberOfReceivedBytes;
+	ConversionRequest	request;
+	size_t			numberOfPendingBytes;
+	size_t			numberOfSentBytes;
+	ConversionResponse	responses[kConversionServerConstantMaxPendingResponses];
+} ConversionServerClient;
+
+static volatile sig_atomic_t	conversionServerStopSignal = 0;
+
+static void
+stopConversionServer(int signalNumber)
+{
+	conversionServerStopSignal = signalNumber;
+
+	return;
+}
+
+static CommonConstantReturnType
+writeFrame(int connection, const void *  frame, size_t size)
+{
+	const unsigned char *	bytes = frame;
+
+	while (size > 0)
+	{
+		ssize_t	written = write(connection, bytes, size);
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return kCommonConstantReturnTypeError;
+		}
+		bytes += written;
+		size -= (size_t)written;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static CommonConstantReturnType
+readFrame(int connection, void *  frame, size_t size)
+{
+	unsigned char *	bytes = frame;
+
+	while (size > 0)
+	{
+		ssize_t	received = read(connection, bytes, size);
+
+		if ((received < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+		if (received <= 0)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+		bytes += received;
+		size -= (size_t)received;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	The Monte Carlo block kernel of the server: the batched equivalent of the
+ *	conversion in `main.c`, over the input ranges of the current request.
+ */
+static void
+evaluateConversionServerBlock(
+	RandomLaneStream *	randomStream,
+	double *		outputSamples,
+	size_t			firstIteration,
+	size_t			count,
+	size_t			sliceIndex,
+	void *			context)
+{
+	const ConversionServer *	server = context;
+	const ConversionRequest *	request = server->request;
+	_Alignas(64) double		vout[kMonteCarloConstantBlockSize];
+	_Alignas(64) double		vref[kMonteCarloConstantBlockSize];
+	uint64_t *			counts = server->sliceCounts[sliceIndex].counts;
+
+	/*
+	 *	The Philox draws only depend on the iteration index, so the run leaves
+	 *	`randomStream` unseeded (see `isRandomStreamUnused`).
+	 */
+	(void)randomStream;
+
+	server->kernels->fillPhiloxUnitBlock(&server->philoxKey, firstIteration, vout, vref, count);
+	for (size_t i = 0; i < count; i++)
+	{
+		vout[i] = request->voutLow + (request->voutHigh - request->voutLow) * vout[i];
+		vref[i] = request->vrefLow + (request->vrefHigh - request->vrefLow) * vref[i];
+	}
+	server->kernels->convertSensorOutputBlock(vout, vref, outputSamples, count, server->sensorVariant->sensitivityReciprocal);
+
+	for (uint32_t k = 0; k < request->numberOfThresholds; k++)
+	{
+		uint64_t	numberAtOrBelow = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			numberAtOrBelow += (outputSamples[i] <= request->thresholds[k]);
+		}
+		counts[k] += numberAtOrBelow;
+	}
+
+	return;
+}
+
+static bool
+isValidInputRange(double low, double high)
+{
+	return isfinite(low) && isfinite(high) && (low <= high);
+}
+
+static void
+evaluateConversionRequest(ConversionServer *  server, const ConversionRequest *  request, ConversionResponse *  response)
+{
+	size_t			numberOfThreads = getThreadPoolSize(server->pool);
+	ResultCacheKey		key;
+	ResultCacheValue	value = {0};
+	MonteCarloRun		run;
+	bool			isCacheable;
+
+	*response = (ConversionResponse)
+	{
+		.magic = kConversionServerConstantMagicResponse,
+		.version = kConversionServerConstantVersion,
+		.frameSize = sizeof(ConversionResponse),
+		.status = kConversionServerStatusInvalidRequest,
+	};
+
+	if ((request->sensorVariantIndex >= kSensorVariantIndexMax) ||
+		(request->numberOfIterations == 0) ||
+		(request->numberOfIterations > kConversionServerConstantMaxIterations) ||
+		(request->numberOfThresholds > kConversionServerConstantMaxThresholds) ||
+		!isValidInputRange(request->voutLow, request->voutHigh) ||
+		!isValidInputRange(request->vrefLow, request->vrefHigh))
+	{
+		return;
+	}
+	for (uint32_t k = 0; k < request->numberOfThresholds; k++)
+	{
+		if (!isfinite(request->thresholds[k]))
+		{
+			return;
+		}
+	}
+
+	server->request = request;
+	server->sensorVariant = &kSensorVariants[request->sensorVariantIndex];
+
+	isCacheable = (server->resultCache != NULL) &&
+		(makeResultCacheKey(
+			&key,
+			kResultCacheKindSummary,
+			request->voutLow,
+			request->voutHigh,
+			request->vrefLow,
+			request->vrefHigh,
+			server->sensorVariant->sensitivity,
+			request->numberOfIterations,
+			request->seed,
+			kSamplingMethodPseudoRandom,
+			kRandomGeneratorPhilox,
+			numberOfThreads,
+			request->thresholds,
+			request->numberOfThresholds) == kCommonConstantReturnTypeSuccess);
+
+	if (!isCacheable || !lookupResultCache(server->resultCache, &key, &value))
+	{
+		seedPhiloxKey(&server->philoxKey, request->seed);
+		memset(server->sliceCounts, 0, numberOfThreads * sizeof(ConversionServerSliceCounts));
+
+		run = (MonteCarloRun)
+		{
+			.numberOfIterations = request->numberOfIterations,
+			.firstIteration = 0,
+			.seed = request->seed,
+			.kernel = evaluateConversionServerBlock,
+			.kernelContext = server,
+			.outputSamples = NULL,
+			.summary = &value.summary,
+			.sliceStatistics = server->sliceStatistics,
+			.isRandomStreamUnused = true,
+		};
+		runParallelMonteCarlo(server->pool, &run);
+
+		for (uint32_t k = 0; k < request->numberOfThresholds; k++)
+		{
+			uint64_t	count = 0;
+
+			for (size_t t = 0; t < numberOfThreads; t++)
+			{
+				count += server->sliceCounts[t].counts[k];
+			}
+			value.thresholdProbabilities[k] = (double)count / (double)value.summary.numberOfSamples;
+		}
+
+		if (isCacheable)
+		{
+			insertResultCache(server->resultCache, &key, &value);
+		}
+	}
+
+	response->status = kConversionServerStatusSuccess;
+	response->numberOfThresholds = request->numberOfThresholds;
+	response->numberOfSamples = value.summary.numberOfSamples;
+	response->mean = value.summary.mean;
+	response->variance = value.summary.variance;
+	response->minimum = value.summary.minimum;
+	response->maximum = value.summary.maximum;
+	memcpy(response->quantiles, value.summary.quantiles, sizeof(response->quantiles));
+	memcpy(response->thresholdProbabilities, value.thresholdProbabilities, sizeof(response->thresholdProbabilities));
+
+	return;
+}
+
+/*
+ *	Write as much of the pending responses of a client as its connection takes
+ *	without blocking. Returns `false` if the connection should be closed.
+ */
+static bool
+flushConversionServerClient(ConversionServerClient *  client)
+{
+	const unsigned char *	responseBytes = (const unsigned char *)client->responses;
+
+	while (client->numberOfSentBytes < client->numberOfPendingBytes)
+	{
+		ssize_t	written = write(
+					client->connection,
+					&responseBytes[client->numberOfSentBytes],
+					client->numberOfPendingBytes - client->numberOfSentBytes);
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+		}
+		client->numberOfSentBytes += (size_t)written;
+	}
+	client->numberOfPendingBytes = 0;
+	client->numberOfSentBytes = 0;
+
+	return true;
+}
+
+static bool
+isConversionServerClientFull(const ConversionServerClient *  client)
+{
+	return client->numberOfPendingBytes + sizeof(ConversionResponse) > sizeof(client->responses);
+}
+
+/*
+ *	Read what a client has sent, and queue the answer to its request once the
+ *	whole frame has arrived. Returns `false` if the connection should be closed.
+ */
+static bool
+serveConversionServerClient(ConversionServer *  server, ConversionServerClient *  client)
+{
+	unsigned char *		requestBytes = (unsigned char *)&client->request;
+	unsigned char *		responseBytes = (unsigned char *)client->responses;
+	ssize_t			received;
+
+	received = read(
+			client->connection,
+			&requestBytes[client->numberOfReceivedBytes],
+			sizeof(ConversionRequest) - client->numberOfReceivedBytes);
+	if (received < 0)
+	{
+		return (errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK);
+	}
+	if (received == 0)
+	{
+		return false;
+	}
+
+	client->numberOfReceivedBytes += (size_t)received;
+	if (client->numberOfReceivedBytes < sizeof(ConversionRequest))
+	{
+		return true;
+	}
+	client->numberOfReceivedBytes = 0;
+
+	/*
+	 *	A frame with the wrong header cannot be trusted to be followed by a
+	 *	well-framed one, so the connection is dropped.
+	 */
+	if ((client->request.magic != kConversionServerConstantMagicRequest) ||
+		(client->request.version != kConversionServerConstantVersion) ||
+		(client->request.frameSize != sizeof(ConversionRequest)))
+	{
+		fprintf(stderr, "Warning: Closing a connection that sent a malformed conversion request.\n");
+
+		return false;
+	}
+
+	/*
+	 *	Move the part of the pending responses not yet written to the front of
+	 *	the buffer, to make room for this one.
+	 */
+	if (client->numberOfSentBytes > 0)
+	{
+		memmove(responseBytes, &responseBytes[client->numberOfSentBytes], client->numberOfPendingBytes - client->numberOfSentBytes);
+		client->numberOfPendingBytes -= client->numberOfSentBytes;
+		client->numberOfSentBytes = 0;
+	}
+	evaluateConversionRequest(server, &client->request, (ConversionResponse *)&responseBytes[client->numberOfPendingBytes]);
+	client->numberOfPendingBytes += sizeof(ConversionResponse);
+
+	return flushConversionServerClient(client);
+}
+
+static int
+openConversionServerSocket(const char *  socketPath)
+{
+	struct sockaddr_un	address = { .sun_family = AF_UNIX };
+	struct stat		status;
+	int			listener;
+
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "Error: Socket path \"%s\" is too long.\n", socketPath);
+
+		return -1;
+	}
+	strcpy(address.sun_path, socketPath);
+
+	/*
+	 *	Replace a socket left behind by a previous server, but nothing else.
+	 */
+	if ((lstat(socketPath, &status) == 0) && S_ISSOCK(status.st_mode))
+	{
+		unlink(socketPath);
+	}
+
+	listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0)
+	{
+		fprintf(stderr, "Error: Could not create socket: %s.\n", strerror(errno));
+
+		return -1;
+	}
+
+	if ((bind(listener, (const struct sockaddr *)&address, sizeof(address)) != 0) ||
+		(listen(listener, kConversionServerConstantListenBacklog) != 0))
+	{
+		fprintf(stderr, "Error: Could not listen on socket \"%s\": %s.\n", socketPath, strerror(errno));
+		close(listener);
+
+		return -1;
+	}
+
+	return listener;
+}
+
+CommonConstantReturnType
+runConversionServer(const char *  socketPath, size_t numberOfThreads, ConversionKernelIsa isa, ResultCache *  resultCache)
+{
+	ConversionServer	server = { .resultCache = resultCache };
+	ConversionServerClient	clients[kConversionServerConstantMaxClients];
+	struct pollfd		pollDescriptors[kConversionServerConstantMaxClients + 1];
+	size_t			numberOfClients = 0;
+	struct sigaction	stopAction = { .sa_handler = stopConversionServer };
+	int			listener;
+	CommonConstantReturnType	returnValue = kCommonConstantReturnTypeSuccess;
+
+	server.kernels = selectConversionKernels(isa);
+	if (server.kernels == NULL)
+	{
+		fprintf(stderr, "Error: The requested conversion kernel (-k option) is not supported by this CPU.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (createThreadPool(numberOfThreads, &server.pool) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	server.sliceStatistics = checkedMalloc(numberOfThreads * sizeof(StreamingStatistics), __FILE__, __LINE__);
+	server.sliceCounts = aligned_alloc(_Alignof(ConversionServerSliceCounts), numberOfThreads * sizeof(ConversionServerSliceCounts));
+	if (server.sliceCounts == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate the per-thread buffers of the server.\n");
+		free(server.sliceStatistics);
+		destroyThreadPool(server.pool);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	listener = openConversionServerSocket(socketPath);
+	if (listener < 0)
+	{
+		free(server.sliceCounts);
+		free(server.sliceStatistics);
+		destroyThreadPool(server.pool);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	No `SA_RESTART`, so that a stop signal interrupts `poll()`. Writes to a
+	 *	client that has gone away fail with `EPIPE` instead of killing the server.
+	 */
+	conversionServerStopSignal = 0;
+	sigemptyset(&stopAction.sa_mask);
+	sigaction(SIGINT, &stopAction, NULL);
+	sigaction(SIGTERM, &stopAction, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	fprintf(stderr, "Serving conversion requests on \"%s\" with %zu worker thread(s).\n", socketPath, numberOfThreads);
+
+	while (!conversionServerStopSignal)
+	{
+		size_t	numberOfOpenClients = 0;
+
+		/*
+		 *	Wait for requests only from the clients with room for their answer,
+		 *	and for room to write to the clients with responses pending.
+		 */
+		pollDescriptors[0] = (struct pollfd) { .fd = listener, .events = POLLIN };
+		for (size_t i = 0; i < numberOfClients; i++)
+		{
+			pollDescriptors[i + 1] = (struct pollfd)
+			{
+				.fd = clients[i].connection,
+				.events = (isConversionServerClientFull(&clients[i]) ? 0 : POLLIN) |
+					((clients[i].numberOfPendingBytes > 0) ? POLLOUT : 0),
+			};
+		}
+
+		if (poll(pollDescriptors, numberOfClients + 1, -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "Error: Could not wait for conversion requests: %s.\n", strerror(errno));
+			returnValue = kCommonConstantReturnTypeError;
+
+			break;
+		}
+
+		/*
+		 *	Serve the clients first, compacting the list as connections close,
+		 *	so that the poll descriptors still line up with the clients.
+		 */
+		for (size_t i = 0; i < numberOfClients; i++)
+		{
+			bool	isOpen = true;
+			short	revents = pollDescriptors[i + 1].revents;
+
+			if (revents & (POLLOUT | POLLERR))
+			{
+				isOpen = flushConversionServerClient(&clients[i]);
+			}
+			if (isOpen && (revents & (POLLIN | POLLHUP | POLLERR)) && !isConversionServerClientFull(&clients[i]))
+			{
+				isOpen = serveConversionServerClient(&server, &clients[i]);
+			}
+			else if (revents & (POLLHUP | POLLERR))
+			{
+				isOpen = false;
+			}
+
+			if (isOpen)
+			{
+				if (numberOfOpenClients != i)
+				{
+					clients[numberOfOpenClients] = clients[i];
+				}
+				numberOfOpenClients++;
+			}
+			else
+			{
+				close(clients[i].connection);
+			}
+		}
+		numberOfClients = numberOfOpenClients;
+
+		if (pollDescriptors[0].revents & POLLIN)
+		{
+			int	connection = accept(listener, NULL, NULL);
+
+			if (connection >= 0)
+			{
+				if ((numberOfClients < kConversionServerConstantMaxClients) &&
+					(fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK) == 0))
+				{
+					clients[numberOfClients].connection = connection;
+					clients[numberOfClients].numberOfReceivedBytes = 0;
+					clients[numberOfClients].numberOfPendingBytes = 0;
+					clients[numberOfClients].numberOfSentBytes = 0;
+					numberOfClients++;
+				}
+				else
+				{
+					fprintf(stderr, "Warning: Refusing a connection: already serving %d clients.\n", kConversionServerConstantMaxClients);
+					close(connection);
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < numberOfClients; i++)
+	{
+		close(clients[i].connection);
+	}
+	close(listener);
+	unlink(socketPath);
+
+	if (resultCache != NULL)
+	{
+		ResultCacheStatistics	statistics = getResultCacheStatistics(resultCache);
+
+		fprintf(
+			stderr,
+			"Result cache: %" PRIu64 " hit(s), %" PRIu64 " miss(es), %" PRIu64 " eviction(s).\n",
+			statistics.hits,
+			statistics.misses,
+			statistics.evictions);
+	}
+
+	free(server.sliceCounts);
+	free(server.sliceStatistics);
+	destroyThreadPool(server.pool);
+
+	return returnValue;
+}
+
+CommonConstantReturnType
+connectConversionServer(const char *  socketPath, int *  connection)
+{
+	struct sockaddr_un	address = { .sun_family = AF_UNIX };
+
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "Error: Socket path \"%s\" is too long.\n", socketPath);
+
+		return kCommonConstantReturnTypeError;
+	}
+	strcpy(address.sun_path, socketPath);
+
+	*connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (*connection < 0)
+	{
+		fprintf(stderr, "Error: Could not create socket: %s.\n", strerror(errno));
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (connect(*connection, (const struct sockaddr *)&address, sizeof(address)) != 0)
+	{
+		fprintf(stderr, "Error: Could not connect to \"%s\": %s.\n", socketPath, strerror(errno));
+		close(*connection);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+requestConversion(int connection, const ConversionRequest *  request, ConversionResponse *  response)
+{
+	if ((writeFrame(connection, request, sizeof(*request)) != kCommonConstantReturnTypeSuccess) ||
+		(readFrame(connection, response, sizeof(*response)) != kCommonConstantReturnTypeSuccess))
+	{
+		fprintf(stderr, "Error: Lost the connection to the conversion server.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((response->magic != kConversionServerConstantMagicResponse) ||
+		(response->version != kConversionServerConstantVersion) ||
+		(response->frameSize != sizeof(*response)))
+	{
+		fprintf(stderr, "Error: Malformed response from the conversion server.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+disconnectConversionServer(int connection)
+{
+	close(connection);
+
+	return;
+}
+#else
+CommonConstantReturnType
+runConversionServer(const char *  socketPath, size_t numberOfThreads, ConversionKernelIsa isa, ResultCache *  resultCache)
+{
+	(void)socketPath;
+	(void)numberOfThreads;
+	(void)isa;
+	(void)resultCache;
+
+	fprintf(stderr, "Error: The server mode (-u option) requires a build with ENABLE_NATIVE_POSIX.\n");
+
+	return kCommonConstantReturnTypeError;
+}
+
+CommonConstantReturnType
+connectConversionServer(const char *  socketPath, int *  connection)
+{
+	(void)socketPath;
+	(void)connection;
+
+	fprintf(stderr, "Error: Connecting to a conversion server requires a build with ENABLE_NATIVE_POSIX.\n");
+
+	return kCommonConstantReturnTypeError;
+}
+
+CommonConstantReturnType
+requestConversion(int connection, const ConversionRequest *  request, ConversionResponse *  response)
+{
+	(void)connection;
+	(void)request;
+	(void)response;
+
+	return kCommonConstantReturnTypeError;
+}
+
+void
+disconnectConversionServer(int connection)
+{
+	(void)connection;
+
+	return;
+}
+#endif /* defined(ENABLE_NATIVE_POSIX) */
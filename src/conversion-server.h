@@ -0,0 +1,150 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "common.h"
+#include "conversion-kernels.h"
+#include "distribution-summary.h"
+#include "result-cache.h"
+
+/*
+ *	The server mode (`-u` option) answers conversion requests over a Unix
+ *	domain socket. A client sends fixed-size `ConversionRequest` frames and
+ *	receives one `ConversionResponse` frame per request, in order, on the same
+ *	connection. Frames are in the native byte order, as both ends run on the
+ *	same host.
+ */
+typedef enum
+{
+	kConversionServerConstantMagicRequest		= 0x51434D54,	/* "TMCQ" */
+	kConversionServerConstantMagicResponse		= 0x52434D54,	/* "TMCR" */
+	kConversionServerConstantVersion		= 2,
+	kConversionServerConstantMaxThresholds		= kResultCacheConstantMaxThresholds,
+	kConversionServerConstantMaxIterations		= 1 << 24,
+	kConversionServerConstantMaxClients		= 64,
+	kConversionServerConstantMaxPendingResponses	= 16,
+	kConversionServerConstantListenBacklog		= 16,
+} ConversionServerConstant;
+
+typedef enum
+{
+	kConversionServerStatusSuccess		= 0,
+	kConversionServerStatusInvalidRequest	= 1,
+} ConversionServerStatus;
+
+/*
+ *	A conversion request: `numberOfIterations` Monte Carlo iterations of the
+ *	sensor variant `sensorVariantIndex` (an index of `kSensorVariants`), with
+ *	Vout and Vref uniform over the given ranges, drawn from the Philox
+ *	generator keyed by `seed`. The response carries P(output <= x) for each
+ *	of the first `numberOfThresholds` entries of `thresholds`.
+ */
+typedef struct
+{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	frameSize;
+	uint32_t	sensorVariantIndex;
+	uint32_t	numberOfIterations;
+	uint32_t	numberOfThresholds;
+	uint32_t	reserved;
+	uint64_t	seed;
+	double		voutLow;
+	double		voutHigh;
+	double		vrefLow;
+	double		vrefHigh;
+	double		thresholds[kConversionServerConstantMaxThresholds];
+} ConversionRequest;
+
+/*
+ *	The reply to a `ConversionRequest`. Unless `status` is
+ *	`kConversionServerStatusSuccess`, only `magic`, `version`, `frameSize`
+ *	and `status` are meaningful. The quantiles are at the probabilities of
+ *	`kDistributionSummaryQuantileProbabilities`.
+ */
+typedef struct
+{
+	uint32_t	magic;
+	uint16_t	version;
+	uint16_t	frameSize;
+	uint32_t	status;
+	uint32_t	numberOfThresholds;
+	uint64_t	numberOfSamples;
+	double		mean;
+	double		variance;
+	double		minimum;
+	double		maximum;
+	double		quantiles[kDistributionSummaryConstantNumberOfQuantiles];
+	double		thresholdProbabilities[kConversionServerConstantMaxThresholds];
+} ConversionResponse;
+
+/**
+ *	@brief	Serve conversion requests on a Unix domain socket until interrupted
+ *		(SIGINT or SIGTERM). The worker threads and per-worker buffers are
+ *		created once and reused by every request. Requires `ENABLE_NATIVE_POSIX`.
+ *
+ *	@param	socketPath		: Path of the socket to create. Removed on exit.
+ *	@param	numberOfThreads		: Number of worker threads.
+ *	@param	isa			: Instruction set of the batched kernels.
+ *	@param	resultCache		: Cache of the replies to earlier requests, or `NULL`.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if the server
+ *					  stopped cleanly, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	runConversionServer(const char *  socketPath, size_t numberOfThreads, ConversionKernelIsa isa, ResultCache *  resultCache);
+
+/**
+ *	@brief	Connect to a conversion server. Requires `ENABLE_NATIVE_POSIX`.
+ *
+ *	@param	socketPath		: Path of the server's socket.
+ *	@param	connection		: Set to the connected socket on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	connectConversionServer(const char *  socketPath, int *  connection);
+
+/**
+ *	@brief	Initialize a request with the default inputs, variant and seed, and no thresholds.
+ *
+ *	@param	request			: The request to initialize.
+ *	@param	numberOfIterations	: The number of Monte Carlo iterations.
+ */
+void	initializeConversionRequest(ConversionRequest *  request, uint32_t numberOfIterations);
+
+/**
+ *	@brief	Send a request and wait for its response.
+ *
+ *	@param	connection		: A socket from `connectConversionServer()`.
+ *	@param	request			: The request.
+ *	@param	response		: Where to write the response.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if a well-formed
+ *					  response was received, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	requestConversion(int connection, const ConversionRequest *  request, ConversionResponse *  response);
+
+/**
+ *	@brief	Close a connection to a conversion server.
+ *
+ *	@param	connection		: A socket from `connectConversionServer()`.
+ */
+void	disconnectConversionServer(int connection);
@@ -0,0 +1,58 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/*
+ *	Quantiles reported in every distribution summary, at the probabilities
+ *	listed in `kDistributionSummaryQuantileProbabilities`.
+ */
+typedef enum
+{
+	kDistributionSummaryConstantNumberOfQuantiles	= 7,
+} DistributionSummaryConstant;
+
+static const double	kDistributionSummaryQuantileProbabilities[kDistributionSummaryConstantNumberOfQuantiles] =
+			{
+				0.01,
+				0.05,
+				0.25,
+				0.50,
+				0.75,
+				0.95,
+				0.99,
+			};
+
+/*
+ *	A fixed-size summary of an output distribution, however it was obtained.
+ */
+typedef struct
+{
+	size_t	numberOfSamples;
+	double	mean;
+	double	variance;
+	double	minimum;
+	double	maximum;
+	double	quantiles[kDistributionSummaryConstantNumberOfQuantiles];
+} DistributionSummary;
@@ -0,0 +1,135 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "latency-histogram.h"
+
+static size_t
+getLatencyBucket(uint64_t nanoseconds)
+{
+	int	exponent;
+
+	if (nanoseconds < (UINT64_C(1) << kLatencyHistogramConstantSubBucketBits))
+	{
+		return (size_t)nanoseconds;
+	}
+
+	/*
+	 *	The leading `kLatencyHistogramConstantSubBucketBits + 1` bits of the
+	 *	latency select the bucket within its power-of-two range.
+	 */
+	exponent = 63 - __builtin_clzll(nanoseconds);
+
+	return ((size_t)(exponent - kLatencyHistogramConstantSubBucketBits + 1) << kLatencyHistogramConstantSubBucketBits) +
+		(size_t)((nanoseconds >> (exponent - kLatencyHistogramConstantSubBucketBits)) & ((1 << kLatencyHistogramConstantSubBucketBits) - 1));
+}
+
+static uint64_t
+getLatencyBucketUpperEnd(size_t bucket)
+{
+	size_t		range = bucket >> kLatencyHistogramConstantSubBucketBits;
+	uint64_t	subBucket = bucket & ((1 << kLatencyHistogramConstantSubBucketBits) - 1);
+	int		shift;
+
+	if (range == 0)
+	{
+		return (uint64_t)bucket;
+	}
+
+	shift = (int)range - 1;
+
+	return (((UINT64_C(1) << kLatencyHistogramConstantSubBucketBits) + subBucket + 1) << shift) - 1;
+}
+
+void
+initializeLatencyHistogram(LatencyHistogram *  histogram)
+{
+	memset(histogram, 0, sizeof(LatencyHistogram));
+	histogram->minimumNanoseconds = UINT64_MAX;
+
+	return;
+}
+
+void
+recordLatency(LatencyHistogram *  histogram, uint64_t nanoseconds)
+{
+	histogram->counts[getLatencyBucket(nanoseconds)]++;
+	histogram->numberOfLatencies++;
+	histogram->totalNanoseconds += nanoseconds;
+	histogram->minimumNanoseconds = (nanoseconds < histogram->minimumNanoseconds) ? nanoseconds : histogram->minimumNanoseconds;
+	histogram->maximumNanoseconds = (nanoseconds > histogram->maximumNanoseconds) ? nanoseconds : histogram->maximumNanoseconds;
+
+	return;
+}
+
+uint64_t
+getLatencyPercentile(const LatencyHistogram *  histogram, double probability)
+{
+	uint64_t	rank;
+	uint64_t	cumulativeCount = 0;
+
+	if (histogram->numberOfLatencies == 0)
+	{
+		return 0;
+	}
+
+	rank = (uint64_t)ceil(probability * (double)histogram->numberOfLatencies);
+	rank = (rank == 0) ? 1 : rank;
+	for (size_t i = 0; i < kLatencyHistogramConstantNumberOfBuckets; i++)
+	{
+		cumulativeCount += histogram->counts[i];
+		if (cumulativeCount >= rank)
+		{
+			uint64_t	upperEnd = getLatencyBucketUpperEnd(i);
+
+			return (upperEnd < histogram->maximumNanoseconds) ? upperEnd : histogram->maximumNanoseconds;
+		}
+	}
+
+	return histogram->maximumNanoseconds;
+}
+
+void
+printLatencyHistogram(const LatencyHistogram *  histogram, const char *  label)
+{
+	if (histogram->numberOfLatencies == 0)
+	{
+		fprintf(stderr, "%s: no measurements\n", label);
+
+		return;
+	}
+
+	fprintf(
+		stderr,
+		"%s (microseconds): mean %.3lf, min %.3lf, p50 %.3lf, p99 %.3lf, p99.9 %.3lf, max %.3lf\n",
+		label,
+		(double)histogram->totalNanoseconds / (double)histogram->numberOfLatencies / 1e3,
+		(double)histogram->minimumNanoseconds / 1e3,
+		(double)getLatencyPercentile(histogram, 0.5) / 1e3,
+		(double)getLatencyPercentile(histogram, 0.99) / 1e3,
+		(double)getLatencyPercentile(histogram, 0.999) / 1e3,
+		(double)histogram->maximumNanoseconds / 1e3);
+
+	return;
+}
@@ -0,0 +1,82 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ *	Latencies are counted in log-linear buckets: values below
+ *	2^kLatencyHistogramConstantSubBucketBits nanoseconds have a bucket each, and
+ *	every larger power-of-two range is split into 2^kLatencyHistogramConstantSubBucketBits
+ *	buckets, so that percentiles are within 12.5% of the recorded latencies for a
+ *	fixed, small, memory footprint.
+ */
+typedef enum
+{
+	kLatencyHistogramConstantSubBucketBits		= 3,
+	kLatencyHistogramConstantNumberOfBuckets	= (64 - kLatencyHistogramConstantSubBucketBits + 1) << kLatencyHistogramConstantSubBucketBits,
+} LatencyHistogramConstant;
+
+typedef struct
+{
+	uint64_t	counts[kLatencyHistogramConstantNumberOfBuckets];
+	uint64_t	numberOfLatencies;
+	uint64_t	totalNanoseconds;
+	uint64_t	minimumNanoseconds;
+	uint64_t	maximumNanoseconds;
+} LatencyHistogram;
+
+/**
+ *	@brief	Reset the histogram to hold no latencies.
+ *
+ *	@param	histogram	: The histogram.
+ */
+void	initializeLatencyHistogram(LatencyHistogram *  histogram);
+
+/**
+ *	@brief	Count one latency.
+ *
+ *	@param	histogram	: The histogram.
+ *	@param	nanoseconds	: The latency (in nanoseconds).
+ */
+void	recordLatency(LatencyHistogram *  histogram, uint64_t nanoseconds);
+
+/**
+ *	@brief	Get a percentile of the latencies, as the upper end of the bucket that holds it
+ *		(clamped to the largest latency).
+ *
+ *	@param	histogram	: The histogram.
+ *	@param	probability	: The probability of the percentile, in [0, 1].
+ *	@return			: The latency (in nanoseconds), or 0 if the histogram is empty.
+ */
+uint64_t	getLatencyPercentile(const LatencyHistogram *  histogram, double probability);
+
+/**
+ *	@brief	Print the mean, median, tail percentiles and maximum of the latencies, in
+ *		microseconds, on one line of the standard error.
+ *
+ *	@param	histogram	: The histogram.
+ *	@param	label		: What each latency measures, e.g., "Per-reading latency".
+ */
+void	printLatencyHistogram(const LatencyHistogram *  histogram, const char *  label);
@@ -30,6 +30,13 @@
 #include <uxhw.h>
 #include <string.h>
 #include "utilities.h"
+#include "record-stream.h"
+#include "monte-carlo.h"
+#include "conversion-kernels.h"
+#include "streaming-statistics.h"
+#include "analytic.h"
+#include "binary-output.h"
+#include "phase-timing.h"
 
 /**
  *	@brief  Sets the Input Distributions via call to UxHw Parametric function.
@@ -51,28 +58,1218 @@ setInputDistributionsViaUxHwCall(double *  inputDistributions)
 }
 
 /**
- *	@brief  Sensor calibration routine for TMCS1123x3A, taken from Section 7.1
+ *	@brief  Sensor calibration routine for the TMCS112x variants, taken from Section 7.1
  *		in page 13 of tmcs1123.pdf, 2024-07-04.
  *
+ *	@param  inputDistributions		: The array of input distributions used in the calculation.
+ * 	@param  outputDistributions		: An array of of output distributions. Writes the result to `outputDistributions[outputSelectValue]`.
+ *	@param  calculateCalibratedCurrent	: The conversion function of the sensor variant, which divides by its sensitivity.
+ *
+ *	@return	double				: Returns the distributional value calculated.
+ */
+static inline double
+calculateSensorOutput(double *  inputDistributions, double *  outputDistributions, SensorOutputFunction calculateCalibratedCurrent)
+{
+	double	Vref;
+	double	Vout;
+	double	calibratedValue;
+
+	Vref = inputDistributions[kInputDistributionIndexVref];
+	Vout = inputDistributions[kInputDistributionIndexVout];
+
+	calibratedValue = calculateCalibratedCurrent(Vout, Vref);
+	outputDistributions[kOutputDistributionIndexCalibratedCurrent] = calibratedValue;
+
+	return	calibratedValue;
+}
+
+/**
+ *	@brief  Sets the Input Distributions of the error terms of the extended error model via call
+ *		to UxHw Parametric function.
+ *
+ *	@param  inputDistributions	: An array of double values, where the function writes the distributional data.
+ *	@param  errorModel		: The extended error model, with the bounds of each input distribution.
+ */
+static void
+setErrorModelInputDistributionsViaUxHwCall(double *  inputDistributions, const SensorErrorModel *  errorModel)
+{
+	for (size_t i = kInputDistributionIndexSensitivityError; i < kInputDistributionIndexMax; i++)
+	{
+		inputDistributions[i] = UxHwDoubleUniformDist(errorModel->low[i], errorModel->high[i]);
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Sensor calibration routine under the extended error model: the conversion of
+ *		`calculateSensorOutput()`, with the sensitivity error and drift, the offset error
+ *		and drift, and the nonlinearity of the datasheet, as described in `sensor-variants.h`.
+ *
  *	@param  inputDistributions	: The array of input distributions used in the calculation.
  * 	@param  outputDistributions	: An array of of output distributions. Writes the result to `outputDistributions[outputSelectValue]`.
+ *	@param  errorModel		: The extended error model of the sensor variant.
+ *
+ *	@return	double			: Returns the distributional value calculated.
+ */
+static double
+calculateSensorOutputWithErrorModel(double *  inputDistributions, double *  outputDistributions, const SensorErrorModel *  errorModel)
+{
+	double	temperatureDeviation;
+	double	offset;
+	double	gain;
+	double	linearCurrent;
+	double	calibratedValue;
+
+	temperatureDeviation = inputDistributions[kInputDistributionIndexTemperature] - errorModel->referenceTemperature;
+	offset = inputDistributions[kInputDistributionIndexOffsetError] + inputDistributions[kInputDistributionIndexOffsetDrift] * temperatureDeviation;
+	gain = errorModel->sensitivity *
+		((1.0 + inputDistributions[kInputDistributionIndexSensitivityError]) +
+			inputDistributions[kInputDistributionIndexSensitivityDrift] * temperatureDeviation);
+	linearCurrent = ((inputDistributions[kInputDistributionIndexVout] - inputDistributions[kInputDistributionIndexVref]) - offset) / gain;
+
+	calibratedValue = linearCurrent -
+			inputDistributions[kInputDistributionIndexNonlinearity] * ((linearCurrent * linearCurrent) * errorModel->reciprocalCurrentRange);
+	outputDistributions[kOutputDistributionIndexCalibratedCurrent] = calibratedValue;
+
+	return	calibratedValue;
+}
+
+/**
+ *	@brief  Sets the Input Distributions of a recorded reading via call to UxHw Parametric function.
+ *
+ *	@param  inputDistributions	: An array of double values, where the function writes the distributional data.
+ *	@param  record			: The recorded reading, carrying its own Vout and Vref uncertainty.
+ */
+static void
+setInputDistributionsFromRecordViaUxHwCall(double *  inputDistributions, const SensorReadingRecord *  record)
+{
+	inputDistributions[kInputDistributionIndexVout] = UxHwDoubleUniformDist(record->voutLow, record->voutHigh);
+	inputDistributions[kInputDistributionIndexVref] = UxHwDoubleUniformDist(record->vrefLow, record->vrefHigh);
+
+	return;
+}
+
+/*
+ *	The serial loops below take the conversion function of the sensor variant as
+ *	an argument, and are always inlined into a `switch` on the variant, which is
+ *	taken once, outside the loop. Each case is then a loop of its own variant, in
+ *	which the conversion is inlined, with its constant reciprocal sensitivity.
+ */
+
+/*
+ *	Where the serial Monte Carlo loop reads and writes. `errorModel` is `NULL` unless
+ *	the extended error model is used (`-e` option), `outputSamples` is `NULL` unless
+ *	the samples are stored, `streamingStatistics` is `NULL` unless they are streamed,
+ *	and `loopCycles` is `NULL` unless the cycles of the loop are measured.
+ */
+typedef struct
+{
+	double *			inputDistributions;
+	double *			outputDistributions;
+	const SensorErrorModel *	errorModel;
+	double *			outputSamples;
+	StreamingStatistics *		streamingStatistics;
+	PhaseTimingSliceCycles *	loopCycles;
+} SerialMonteCarloLoop;
+
+/**
+ *	@brief  Iterations [begin, end) of the serial Monte Carlo loop, for one sensor variant.
+ *
+ *	@param  loop				: Where the loop reads and writes.
+ *	@param  begin				: The first iteration.
+ *	@param  end				: One past the last iteration.
+ *	@param  calculateCalibratedCurrent	: The conversion function of the sensor variant.
+ *
+ *	@return	double				: Returns the output of the last iteration.
+ */
+static inline __attribute__((always_inline)) double
+runSerialMonteCarloLoopOfVariant(const SerialMonteCarloLoop *  loop, size_t begin, size_t end, SensorOutputFunction calculateCalibratedCurrent)
+{
+	double	calibratedSensorOutput = 0.0;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		uint64_t	samplingStart = (loop->loopCycles != NULL) ? readCycleCounter() : 0;
+		uint64_t	conversionStart;
+
+		/*
+		 *	Set input distribution values, inside the main computation
+		 *	loop, so that it can also generate samples in the native
+		 *	Monte Carlo Execution Mode.
+		 */
+		setInputDistributionsViaUxHwCall(loop->inputDistributions);
+		if (loop->errorModel != NULL)
+		{
+			setErrorModelInputDistributionsViaUxHwCall(loop->inputDistributions, loop->errorModel);
+		}
+
+		conversionStart = (loop->loopCycles != NULL) ? readCycleCounter() : 0;
+		calibratedSensorOutput = (loop->errorModel != NULL) ?
+					calculateSensorOutputWithErrorModel(loop->inputDistributions, loop->outputDistributions, loop->errorModel) :
+					calculateSensorOutput(loop->inputDistributions, loop->outputDistributions, calculateCalibratedCurrent);
+
+		if (loop->loopCycles != NULL)
+		{
+			loop->loopCycles->samplingCycles += conversionStart - samplingStart;
+			loop->loopCycles->conversionCycles += readCycleCounter() - conversionStart;
+		}
+
+		/*
+		 *	For this application, calibratedSensorOutput is the item we track.
+		 */
+		if (loop->streamingStatistics != NULL)
+		{
+			updateStreamingStatistics(loop->streamingStatistics, calibratedSensorOutput);
+		}
+		else if (loop->outputSamples != NULL)
+		{
+			loop->outputSamples[i] = calibratedSensorOutput;
+		}
+	}
+
+	return calibratedSensorOutput;
+}
+
+#define SERIAL_MONTE_CARLO_LOOP_CASE(variantName, variantSensitivity, variantSupplyVoltage, variantZeroCurrentReference)	\
+	case kSensorVariantIndex##variantName:								\
+		return runSerialMonteCarloLoopOfVariant(loop, begin, end, calculateCalibratedCurrent##variantName);
+
+/**
+ *	@brief  Iterations [begin, end) of the serial Monte Carlo loop.
+ *
+ *	@param  loop		: Where the loop reads and writes.
+ *	@param  sensorVariant	: The sensor variant.
+ *	@param  begin		: The first iteration.
+ *	@param  end		: One past the last iteration.
+ *
+ *	@return	double		: Returns the output of the last iteration.
+ */
+static double
+runSerialMonteCarloLoop(const SerialMonteCarloLoop *  loop, const SensorVariant *  sensorVariant, size_t begin, size_t end)
+{
+	switch (sensorVariant->index)
+	{
+		TMCS112X_SENSOR_VARIANTS(SERIAL_MONTE_CARLO_LOOP_CASE)
+		default:
+			break;
+	}
+
+	return runSerialMonteCarloLoopOfVariant(loop, begin, end, sensorVariant->calculateCalibratedCurrent);
+}
+
+/*
+ *	The Welford accumulators of the samples of a recorded reading.
+ */
+typedef struct
+{
+	double	mean;
+	double	sumOfSquaredDeviations;
+	size_t	numberOfExceedances;
+	double	lastOutput;
+} RecordedReadingSamples;
+
+/**
+ *	@brief  Evaluates a recorded reading `numberOfIterations` times, for one sensor variant,
+ *		with Welford's online update, so that no samples are stored.
+ *
+ *	@param  record				: The recorded reading.
+ *	@param  numberOfIterations		: The number of iterations.
+ *	@param  threshold			: The threshold of `numberOfExceedances`, or `INFINITY` to count none.
+ *	@param  samples				: Where to accumulate the samples, starting from zero.
+ *	@param  calculateCalibratedCurrent	: The conversion function of the sensor variant.
+ */
+static inline __attribute__((always_inline)) void
+accumulateRecordedReadingSamplesOfVariant(
+	const SensorReadingRecord *	record,
+	size_t				numberOfIterations,
+	double				threshold,
+	RecordedReadingSamples *	samples,
+	SensorOutputFunction		calculateCalibratedCurrent)
+{
+	double	inputDistributions[kInputDistributionIndexMax];
+	double	outputDistributions[kOutputDistributionIndexMax];
+	double	mean = 0.0;
+	double	sumOfSquaredDeviations = 0.0;
+	size_t	numberOfExceedances = 0;
+	double	calibratedSensorOutput = 0.0;
+
+	for (size_t j = 0; j < numberOfIterations; j++)
+	{
+		double	delta;
+
+		setInputDistributionsFromRecordViaUxHwCall(inputDistributions, record);
+		calibratedSensorOutput = calculateSensorOutput(inputDistributions, outputDistributions, calculateCalibratedCurrent);
+
+		delta = calibratedSensorOutput - mean;
+		mean += delta / (double)(j + 1);
+		sumOfSquaredDeviations += delta * (calibratedSensorOutput - mean);
+		numberOfExceedances += (calibratedSensorOutput > threshold);
+	}
+
+	samples->mean = mean;
+	samples->sumOfSquaredDeviations = sumOfSquaredDeviations;
+	samples->numberOfExceedances = numberOfExceedances;
+	samples->lastOutput = calibratedSensorOutput;
+
+	return;
+}
+
+#define RECORDED_READING_SAMPLES_CASE(variantName, variantSensitivity, variantSupplyVoltage, variantZeroCurrentReference)	\
+	case kSensorVariantIndex##variantName:								\
+		accumulateRecordedReadingSamplesOfVariant(record, numberOfIterations, threshold, samples, calculateCalibratedCurrent##variantName);	\
+		return;
+
+/**
+ *	@brief  Evaluates a recorded reading `numberOfIterations` times, with Welford's online
+ *		update, so that no samples are stored.
+ *
+ *	@param  sensorVariant		: The sensor variant.
+ *	@param  record			: The recorded reading.
+ *	@param  numberOfIterations	: The number of iterations.
+ *	@param  threshold		: The threshold of `numberOfExceedances`, or `INFINITY` to count none.
+ *	@param  samples			: Where to write the accumulated samples.
+ */
+static void
+accumulateRecordedReadingSamples(
+	const SensorVariant *		sensorVariant,
+	const SensorReadingRecord *	record,
+	size_t				numberOfIterations,
+	double				threshold,
+	RecordedReadingSamples *	samples)
+{
+	switch (sensorVariant->index)
+	{
+		TMCS112X_SENSOR_VARIANTS(RECORDED_READING_SAMPLES_CASE)
+		default:
+			break;
+	}
+
+	accumulateRecordedReadingSamplesOfVariant(record, numberOfIterations, threshold, samples, sensorVariant->calculateCalibratedCurrent);
+
+	return;
+}
+
+/*
+ *	The kernel context of the parallel Monte Carlo engine. `quasiRandomSequence` is
+ *	`NULL` unless a quasi-Monte Carlo sampling method is used (`-m` option),
+ *	`philoxKey` is `NULL` unless the Philox generator is used (`-r` option), and
+ *	`sliceCycles` is `NULL` unless the sampling and conversion cycles are measured
+ *	(`-T` option), and `errorModel` is `NULL` unless the extended error model is
+ *	used (`-e` option).
+ */
+typedef struct
+{
+	const ConversionKernels *	kernels;
+	const SensorVariant *		sensorVariant;
+	const QuasiRandomSequence *	quasiRandomSequence;
+	const PhiloxKey *		philoxKey;
+	PhaseTimingSliceCycles *	sliceCycles;
+	const SensorErrorModel *	errorModel;
+} MonteCarloBlockContext;
+
+/**
+ *	@brief  A block of iterations of the parallel Monte Carlo engine. This is the batched
+ *		equivalent of `setInputDistributionsViaUxHwCall()` followed by `calculateSensorOutput()`:
+ *		the Vout and Vref samples are generated into structure-of-arrays buffers, which
+ *		are then converted with a single multiply by the reciprocal of the sensitivity.
+ *
+ *	@param  randomStream	: The random lane stream of the calling worker thread.
+ *	@param  outputSamples	: Where to write the `count` calibrated sensor output samples.
+ *	@param  firstIteration	: The index of the first iteration of the block in the run.
+ *	@param  count		: The number of iterations, at most `kMonteCarloConstantBlockSize`.
+ *	@param  sliceIndex	: The slice of the calling worker thread.
+ *	@param  context		: The `MonteCarloBlockContext` to use.
+ */
+static void
+evaluateMonteCarloBlock(
+	RandomLaneStream *	randomStream,
+	double *		outputSamples,
+	size_t			firstIteration,
+	size_t			count,
+	size_t			sliceIndex,
+	void *			context)
+{
+	const MonteCarloBlockContext *	blockContext = context;
+	const ConversionKernels *	kernels = blockContext->kernels;
+	_Alignas(64) double		vout[kMonteCarloConstantBlockSize];
+	_Alignas(64) double		vref[kMonteCarloConstantBlockSize];
+	uint64_t			samplingStart = (blockContext->sliceCycles != NULL) ? readCycleCounter() : 0;
+	uint64_t			conversionStart;
+
+	/*
+	 *	Both the quasi-random points and the Philox draws of an iteration only
+	 *	depend on its index, and are generated over the unit square.
+	 */
+	if ((blockContext->quasiRandomSequence != NULL) || (blockContext->philoxKey != NULL))
+	{
+		if (blockContext->quasiRandomSequence != NULL)
+		{
+			generateQuasiRandomBlock(blockContext->quasiRandomSequence, firstIteration, count, vout, vref);
+		}
+		else
+		{
+			kernels->fillPhiloxUnitBlock(blockContext->philoxKey, firstIteration, vout, vref, count);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			vout[i] = kDefaultInputDistributionVoutUniformDistLow +
+				(kDefaultInputDistributionVoutUniformDistHigh - kDefaultInputDistributionVoutUniformDistLow) * vout[i];
+			vref[i] = kDefaultInputDistributionVrefUniformDistLow +
+				(kDefaultInputDistributionVrefUniformDistHigh - kDefaultInputDistributionVrefUniformDistLow) * vref[i];
+		}
+	}
+	else
+	{
+		kernels->fillUniformBlock(
+				randomStream,
+				vout,
+				count,
+				kDefaultInputDistributionVoutUniformDistLow,
+				kDefaultInputDistributionVoutUniformDistHigh);
+		kernels->fillUniformBlock(
+				randomStream,
+				vref,
+				count,
+				kDefaultInputDistributionVrefUniformDistLow,
+				kDefaultInputDistributionVrefUniformDistHigh);
+	}
+
+	/*
+	 *	The error terms of the extended error model are drawn by the conversion
+	 *	kernel itself, so that they never go through memory.
+	 */
+	conversionStart = (blockContext->sliceCycles != NULL) ? readCycleCounter() : 0;
+	if (blockContext->errorModel != NULL)
+	{
+		kernels->convertSensorOutputWithErrorsBlock(randomStream, vout, vref, outputSamples, count, blockContext->errorModel);
+	}
+	else
+	{
+		kernels->convertSensorOutputBlock(vout, vref, outputSamples, count, blockContext->sensorVariant->sensitivityReciprocal);
+	}
+
+	if (blockContext->sliceCycles != NULL)
+	{
+		blockContext->sliceCycles[sliceIndex].samplingCycles += conversionStart - samplingStart;
+		blockContext->sliceCycles[sliceIndex].conversionCycles += readCycleCounter() - conversionStart;
+	}
+
+	return;
+}
+
+/*
+ *	Whether evaluateMonteCarloBlock() never draws from the random lane streams: the
+ *	quasi-random points and the Philox draws only depend on the iteration index, and
+ *	only the extended error model draws from the lane streams besides them.
+ */
+static bool
+isMonteCarloBlockRandomStreamUnused(const MonteCarloBlockContext *  blockContext)
+{
+	return ((blockContext->quasiRandomSequence != NULL) || (blockContext->philoxKey != NULL)) && (blockContext->errorModel == NULL);
+}
+
+/**
+ *	@brief  Converts every record of the input file, writing one line per record to the output
+ *		file (or standard output). In the native Monte Carlo mode, each record is evaluated
+ *		`numberOfMonteCarloIterations` times and its mean and variance are written, so memory
+ *		use does not grow with either the number of records or the number of iterations.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *	@param  resultCache	: Cache of the means and variances of earlier records, or `NULL`.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+runRecordStreamConversion(CommandLineArguments *  arguments, ResultCache *  resultCache)
+{
+	RecordStream *			stream;
+	const SensorReadingRecord *	records;
+	size_t				numberOfRecords;
+	size_t				recordIndex = 0;
+	FILE *				outputFile = stdout;
+	char *				outputBuffer = NULL;
+	clock_t				start = 0;
+	int				returnValue = kCommonConstantReturnTypeSuccess;
+
+	if (openRecordStream(arguments->common.inputFilePath, arguments->inputFormat, &stream) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		outputFile = fopen(arguments->common.outputFilePath, "w");
+		if (outputFile == NULL)
+		{
+			fprintf(stderr, "Error: Could not open output file \"%s\".\n", arguments->common.outputFilePath);
+			closeRecordStream(stream);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	Formatting one short line per record is cheap, but flushing each one is not.
+		 */
+		outputBuffer = checkedMalloc(kRecordStreamConstantOutputBufferSize, __FILE__, __LINE__);
+		setvbuf(outputFile, outputBuffer, _IOFBF, kRecordStreamConstantOutputBufferSize);
+	}
+
+	if (arguments->common.isMonteCarloMode)
+	{
+		fprintf(outputFile, "record,calibratedSensorOutputMean,calibratedSensorOutputVariance\n");
+	}
+	else
+	{
+		fprintf(outputFile, "record,calibratedSensorOutput\n");
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		start = clock();
+	}
+
+	while ((numberOfRecords = readRecordStreamBlock(stream, &records)) > 0)
+	{
+		for (size_t i = 0; i < numberOfRecords; i++, recordIndex++)
+		{
+			RecordedReadingSamples	samples;
+			ResultCacheKey		resultCacheKey;
+			ResultCacheValue	resultCacheValue = {0};
+			bool			isCacheable;
+
+			/*
+			 *	Records whose readings cannot be quantized are evaluated, but not cached.
+			 */
+			isCacheable = (resultCache != NULL) &&
+				(makeResultCacheKey(
+					&resultCacheKey,
+					kResultCacheKindMeanAndVariance,
+					records[i].voutLow,
+					records[i].voutHigh,
+					records[i].vrefLow,
+					records[i].vrefHigh,
+					arguments->sensorVariant->sensitivity,
+					arguments->common.numberOfMonteCarloIterations,
+					0,
+					0,
+					0,
+					0,
+					NULL,
+					0) == kCommonConstantReturnTypeSuccess);
+
+			if (isCacheable && lookupResultCache(resultCache, &resultCacheKey, &resultCacheValue))
+			{
+				fprintf(outputFile, "%zu,%lf,%lf\n", recordIndex, resultCacheValue.summary.mean, resultCacheValue.summary.variance);
+
+				continue;
+			}
+
+			/*
+			 *	Welford's online update, so that no per-record samples are stored.
+			 */
+			accumulateRecordedReadingSamples(
+				arguments->sensorVariant,
+				&records[i],
+				arguments->common.numberOfMonteCarloIterations,
+				INFINITY,
+				&samples);
+
+			if (arguments->common.isMonteCarloMode)
+			{
+				resultCacheValue.summary.numberOfSamples = arguments->common.numberOfMonteCarloIterations;
+				resultCacheValue.summary.mean = samples.mean;
+				resultCacheValue.summary.variance = (arguments->common.numberOfMonteCarloIterations > 1) ?
+						samples.sumOfSquaredDeviations / (double)(arguments->common.numberOfMonteCarloIterations - 1) : 0.0;
+				if (isCacheable)
+				{
+					insertResultCache(resultCache, &resultCacheKey, &resultCacheValue);
+				}
+
+				fprintf(outputFile, "%zu,%lf,%lf\n", recordIndex, samples.mean, resultCacheValue.summary.variance);
+			}
+			else
+			{
+				fprintf(outputFile, "%zu,%"SignaloidParticleModifier"lf\n", recordIndex, samples.lastOutput);
+			}
+		}
+	}
+
+	if (hasRecordStreamFailed(stream))
+	{
+		returnValue = kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		fprintf(
+			stderr,
+			"Converted %zu records. CPU time used: %lf seconds\n",
+			recordIndex,
+			((double)(clock() - start)) / CLOCKS_PER_SEC);
+		if (resultCache != NULL)
+		{
+			ResultCacheStatistics	statistics = getResultCacheStatistics(resultCache);
+
+			fprintf(stderr, "Result cache: %" PRIu64 " hit(s), %" PRIu64 " miss(es)\n", statistics.hits, statistics.misses);
+		}
+	}
+
+	closeRecordStream(stream);
+	if (fflush(outputFile) != 0)
+	{
+		fprintf(stderr, "Error: Could not write output.\n");
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+		free(outputBuffer);
+	}
+
+	return returnValue;
+}
+
+/**
+ *	@brief  Converts every reading of a file of raw ADC codes, writing one line per reading to the
+ *		output file (or standard output). The output distributions of all code pairs are
+ *		computed once, into a table, so converting a reading is a single lookup.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+runAdcCodeStreamConversion(CommandLineArguments *  arguments)
+{
+	AdcCodeTable *		table;
+	AdcCodeStream *		stream;
+	const AdcCodeReading *	readings;
+	size_t			numberOfReadings;
+	size_t			readingIndex = 0;
+	FILE *			outputFile = stdout;
+	char *			outputBuffer = NULL;
+	clock_t			start = clock();
+	clock_t			tableEnd;
+	int			returnValue = kCommonConstantReturnTypeSuccess;
+
+	if (createAdcCodeTable(
+		arguments->adcResolution,
+		arguments->adcReferenceVoltage,
+		arguments->sensorVariant->sensitivity,
+		&table) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	tableEnd = clock();
+
+	if (openAdcCodeStream(arguments->common.inputFilePath, arguments->inputFormat, table->maximumCode, &stream) != kCommonConstantReturnTypeSuccess)
+	{
+		destroyAdcCodeTable(table);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		outputFile = fopen(arguments->common.outputFilePath, "w");
+		if (outputFile == NULL)
+		{
+			fprintf(stderr, "Error: Could not open output file \"%s\".\n", arguments->common.outputFilePath);
+			closeAdcCodeStream(stream);
+			destroyAdcCodeTable(table);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		outputBuffer = checkedMalloc(kRecordStreamConstantOutputBufferSize, __FILE__, __LINE__);
+		setvbuf(outputFile, outputBuffer, _IOFBF, kRecordStreamConstantOutputBufferSize);
+	}
+
+	fprintf(
+		outputFile,
+		"record,calibratedSensorOutputMean,calibratedSensorOutputVariance,calibratedSensorOutputMinimum,calibratedSensorOutputMaximum\n");
+
+	while ((numberOfReadings = readAdcCodeStreamBlock(stream, &readings)) > 0)
+	{
+		for (size_t i = 0; i < numberOfReadings; i++, readingIndex++)
+		{
+			const DistributionSummary *	summary = lookupAdcCodeTable(table, &readings[i]);
+
+			fprintf(outputFile, "%zu,%lf,%le,%lf,%lf\n", readingIndex, summary->mean, summary->variance, summary->minimum, summary->maximum);
+		}
+	}
+
+	if (hasAdcCodeStreamFailed(stream))
+	{
+		returnValue = kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		fprintf(
+			stderr,
+			"Built a table of %zu code differences in %lf seconds. Converted %zu readings. CPU time used: %lf seconds\n",
+			table->numberOfEntries,
+			((double)(tableEnd - start)) / CLOCKS_PER_SEC,
+			readingIndex,
+			((double)(clock() - start)) / CLOCKS_PER_SEC);
+	}
+
+	closeAdcCodeStream(stream);
+	destroyAdcCodeTable(table);
+	if (fflush(outputFile) != 0)
+	{
+		fprintf(stderr, "Error: Could not write output.\n");
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+		free(outputBuffer);
+	}
+
+	return returnValue;
+}
+
+/**
+ *	@brief  Checks every record of the input file for overcurrent, writing a line to the output
+ *		file (or standard output) whenever P(output > threshold) crosses the level of the
+ *		-O option. Each line is flushed at once, so that the event is not held back by
+ *		buffering. With -T, prints the number of events and the per-record latency.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+runOvercurrentDetection(CommandLineArguments *  arguments)
+{
+	RecordStream *			stream;
+	const SensorReadingRecord *	records;
+	const ConversionKernels *	kernels;
+	OvercurrentDetector *		detector;
+	LatencyHistogram		latencyHistogram;
+	size_t				numberOfRecords;
+	size_t				recordIndex = 0;
+	size_t				numberOfTrips = 0;
+	size_t				numberOfClears = 0;
+	size_t				numberOfUnsettledRecords = 0;
+	size_t				numberOfSamples = 0;
+	FILE *				outputFile = stdout;
+	int				returnValue = kCommonConstantReturnTypeSuccess;
+
+	kernels = selectConversionKernels(arguments->conversionKernelIsa);
+	if (kernels == NULL)
+	{
+		fprintf(stderr, "Error: The selected kernel (-k option) is not supported by this CPU or build.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (createOvercurrentDetector(
+		&arguments->overcurrentDetector,
+		kernels,
+		arguments->sensorVariant->sensitivity,
+		arguments->seed,
+		&detector) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (openRecordStream(arguments->common.inputFilePath, arguments->inputFormat, &stream) != kCommonConstantReturnTypeSuccess)
+	{
+		destroyOvercurrentDetector(detector);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		outputFile = fopen(arguments->common.outputFilePath, "w");
+		if (outputFile == NULL)
+		{
+			fprintf(stderr, "Error: Could not open output file \"%s\".\n", arguments->common.outputFilePath);
+			closeRecordStream(stream);
+			destroyOvercurrentDetector(detector);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	fprintf(outputFile, "record,event,probabilityAboveThreshold,samples\n");
+	fflush(outputFile);
+	initializeLatencyHistogram(&latencyHistogram);
+
+	while ((numberOfRecords = readRecordStreamBlock(stream, &records)) > 0)
+	{
+		for (size_t i = 0; i < numberOfRecords; i++, recordIndex++)
+		{
+			OvercurrentDecision	decision;
+			OvercurrentEvent	event;
+			uint64_t		start = readMonotonicNanoseconds();
+
+			event = evaluateOvercurrentDetector(detector, &records[i], &decision);
+			recordLatency(&latencyHistogram, readMonotonicNanoseconds() - start);
+
+			numberOfSamples += decision.numberOfSamples;
+			numberOfUnsettledRecords += !decision.isSettled;
+			if (event != kOvercurrentEventNone)
+			{
+				numberOfTrips += (event == kOvercurrentEventTrip);
+				numberOfClears += (event == kOvercurrentEventClear);
+				fprintf(
+					outputFile,
+					"%zu,%s,%lf,%zu\n",
+					recordIndex,
+					(event == kOvercurrentEventTrip) ? "trip" : "clear",
+					decision.probability,
+					decision.numberOfSamples);
+				fflush(outputFile);
+			}
+		}
+	}
+
+	if (hasRecordStreamFailed(stream))
+	{
+		returnValue = kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		fprintf(
+			stderr,
+			"Checked %zu records: %zu trip(s), %zu clear(s), %zu record(s) unsettled after %zu samples, %.1lf samples per record.\n",
+			recordIndex,
+			numberOfTrips,
+			numberOfClears,
+			numberOfUnsettledRecords,
+			arguments->overcurrentDetector.maximumNumberOfSamples,
+			(recordIndex > 0) ? (double)numberOfSamples / (double)recordIndex : 0.0);
+		printLatencyHistogram(&latencyHistogram, "Per-record latency");
+	}
+
+	closeRecordStream(stream);
+	destroyOvercurrentDetector(detector);
+	if (ferror(outputFile))
+	{
+		fprintf(stderr, "Error: Could not write output.\n");
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+	}
+
+	return returnValue;
+}
+
+/**
+ *	@brief  Summarizes the output distribution of a recorded reading. In the native Monte Carlo
+ *		mode, the reading is evaluated `numberOfMonteCarloIterations` times with
+ *		`calculateSensorOutput()`; otherwise, its exact distribution is used.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *	@param  record		: The recorded reading.
+ *	@param  summary		: Where to write the summary of the reading.
+ */
+static void
+summarizeRecordedReading(const CommandLineArguments *  arguments, const SensorReadingRecord *  record, ReadingSummary *  summary)
+{
+	if (arguments->common.isMonteCarloMode)
+	{
+		RecordedReadingSamples	samples;
+
+		accumulateRecordedReadingSamples(
+			arguments->sensorVariant,
+			record,
+			arguments->common.numberOfMonteCarloIterations,
+			arguments->slidingWindowThreshold,
+			&samples);
+
+		summary->mean = samples.mean;
+		summary->variance = (arguments->common.numberOfMonteCarloIterations > 1) ?
+				samples.sumOfSquaredDeviations / (double)(arguments->common.numberOfMonteCarloIterations - 1) : 0.0;
+		summary->probabilityAboveThreshold = (double)samples.numberOfExceedances / (double)arguments->common.numberOfMonteCarloIterations;
+	}
+	else
+	{
+		TrapezoidalDistribution	distribution = makeCalibratedOutputDistribution(
+							record->voutLow,
+							record->voutHigh,
+							record->vrefLow,
+							record->vrefHigh,
+							arguments->sensorVariant->sensitivity);
+
+		summary->mean = trapezoidalDistributionMean(&distribution);
+		summary->variance = trapezoidalDistributionVariance(&distribution);
+		summary->probabilityAboveThreshold = 1.0 - trapezoidalDistributionCDF(&distribution, arguments->slidingWindowThreshold);
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Tracks the records of the input file as a time series, writing one line per record
+ *		to the output file (or standard output), with the statistics of the window of the
+ *		last -W readings that ends at the record. Each record is summarized once, into a
+ *		ring buffer, and the window statistics are updated incrementally, in constant time
+ *		per record. With -T, prints the per-record latency, and that of the window update.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+runSlidingWindowTracking(CommandLineArguments *  arguments)
+{
+	RecordStream *			stream;
+	const SensorReadingRecord *	records;
+	SlidingWindow *			window;
+	LatencyHistogram		recordLatencyHistogram;
+	LatencyHistogram		updateLatencyHistogram;
+	size_t				numberOfRecords;
+	size_t				recordIndex = 0;
+	FILE *				outputFile = stdout;
+	char *				outputBuffer = NULL;
+	clock_t				start = clock();
+	int				returnValue = kCommonConstantReturnTypeSuccess;
+
+	if (createSlidingWindow(arguments->slidingWindowSize, &window) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (openRecordStream(arguments->common.inputFilePath, arguments->inputFormat, &stream) != kCommonConstantReturnTypeSuccess)
+	{
+		destroySlidingWindow(window);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		outputFile = fopen(arguments->common.outputFilePath, "w");
+		if (outputFile == NULL)
+		{
+			fprintf(stderr, "Error: Could not open output file \"%s\".\n", arguments->common.outputFilePath);
+			closeRecordStream(stream);
+			destroySlidingWindow(window);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		outputBuffer = checkedMalloc(kRecordStreamConstantOutputBufferSize, __FILE__, __LINE__);
+		setvbuf(outputFile, outputBuffer, _IOFBF, kRecordStreamConstantOutputBufferSize);
+	}
+
+	fprintf(outputFile, "record,readingsInWindow,windowMean,windowVariance,windowProbabilityAboveThreshold\n");
+	initializeLatencyHistogram(&recordLatencyHistogram);
+	initializeLatencyHistogram(&updateLatencyHistogram);
+
+	while ((numberOfRecords = readRecordStreamBlock(stream, &records)) > 0)
+	{
+		for (size_t i = 0; i < numberOfRecords; i++, recordIndex++)
+		{
+			ReadingSummary		reading;
+			WindowStatistics	statistics;
+
+			/*
+			 *	The clock is only read when timing, as it costs about as much as
+			 *	updating the window.
+			 */
+			if (arguments->common.isTimingEnabled)
+			{
+				uint64_t	recordStart = readMonotonicNanoseconds();
+				uint64_t	updateStart;
+
+				summarizeRecordedReading(arguments, &records[i], &reading);
+				updateStart = readMonotonicNanoseconds();
+				updateSlidingWindow(window, &reading, &statistics);
+				recordLatency(&updateLatencyHistogram, readMonotonicNanoseconds() - updateStart);
+				recordLatency(&recordLatencyHistogram, readMonotonicNanoseconds() - recordStart);
+			}
+			else
+			{
+				summarizeRecordedReading(arguments, &records[i], &reading);
+				updateSlidingWindow(window, &reading, &statistics);
+			}
+
+			fprintf(
+				outputFile,
+				"%zu,%zu,%lf,%le,%lf\n",
+				recordIndex,
+				statistics.numberOfReadings,
+				statistics.mean,
+				statistics.variance,
+				statistics.probabilityAboveThreshold);
+		}
+	}
+
+	if (hasRecordStreamFailed(stream))
+	{
+		returnValue = kCommonConstantReturnTypeError;
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		double	cpuTimeUsedSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
+
+		fprintf(
+			stderr,
+			"Tracked %zu records over windows of %zu readings. CPU time used: %lf seconds (%.0lf records per second)\n",
+			recordIndex,
+			arguments->slidingWindowSize,
+			cpuTimeUsedSeconds,
+			(cpuTimeUsedSeconds > 0) ? (double)recordIndex / cpuTimeUsedSeconds : 0.0);
+		printLatencyHistogram(&recordLatencyHistogram, "Per-record latency");
+		printLatencyHistogram(&updateLatencyHistogram, "Window update latency");
+	}
+
+	closeRecordStream(stream);
+	destroySlidingWindow(window);
+	if (fflush(outputFile) != 0)
+	{
+		fprintf(stderr, "Error: Could not write output.\n");
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	if (outputFile != stdout)
+	{
+		fclose(outputFile);
+		free(outputBuffer);
+	}
+
+	return returnValue;
+}
+
+static double
+calculateTrapezoidalDistributionCDF(const void *  distribution, double x)
+{
+	return trapezoidalDistributionCDF(distribution, x);
+}
+
+static double
+calculateTrapezoidalDistributionQuantile(const void *  distribution, double probability)
+{
+	return trapezoidalDistributionQuantile(distribution, probability);
+}
+
+/**
+ *	@brief  Evaluates the exact output distribution for the default uniform inputs, as a
+ *		zero-error alternative to sampling it. The difference of two independent
+ *		uniforms, divided by the sensitivity, has a trapezoidal distribution.
  *
- *	@return	double			: Returns the distributional value calculated.
+ *	@param  arguments	: The command-line arguments.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
  */
-static double
-calculateSensorOutput(double *  inputDistributions, double *  outputDistributions)
+static int
+runAnalyticEvaluation(CommandLineArguments *  arguments)
 {
-	double	Vref;
-	double	Vout;
-	double	calibratedValue;
+	TrapezoidalDistribution	distribution;
+	DistributionSummary	summary;
+	double			outputDistributions[kOutputDistributionIndexMax];
+	const char *		outputVariableNames[kOutputDistributionIndexMax] =
+				{
+					"calibratedSensorOutput"
+				};
+	clock_t			start = clock();
+	double			cpuTimeUsedSeconds;
 
-	Vref = inputDistributions[kInputDistributionIndexVref];
-	Vout = inputDistributions[kInputDistributionIndexVout];
+	distribution = makeCalibratedOutputDistribution(
+				kDefaultInputDistributionVoutUniformDistLow,
+				kDefaultInputDistributionVoutUniformDistHigh,
+				kDefaultInputDistributionVrefUniformDistLow,
+				kDefaultInputDistributionVrefUniformDistHigh,
+				arguments->sensorVariant->sensitivity);
+	summarizeTrapezoidalDistribution(&distribution, &summary);
+	outputDistributions[kOutputDistributionIndexCalibratedCurrent] = summary.mean;
 
-	calibratedValue = (Vout - Vref) / kSensorCalibrationConstantTMCS1123x3ASensitivity;
-	outputDistributions[kOutputDistributionIndexCalibratedCurrent] = calibratedValue;
+	cpuTimeUsedSeconds = ((double)(clock() - start)) / CLOCKS_PER_SEC;
 
-	return	calibratedValue;
+	if (arguments->common.isBenchmarkingMode)
+	{
+		printf("%lf %" PRIu64 "\n", summary.mean, (uint64_t)(cpuTimeUsedSeconds*1000000));
+
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	if (!arguments->common.isOutputJSONMode)
+	{
+		printCalibratedValueAndProbabilitiesFromCDF(summary.mean, calculateTrapezoidalDistributionCDF, &distribution);
+		printDistributionSummary(&summary);
+		printQueryResults(
+			&arguments->queries,
+			calculateTrapezoidalDistributionCDF,
+			calculateTrapezoidalDistributionQuantile,
+			&distribution);
+	}
+	else
+	{
+		printJSONFormattedOutput(
+			arguments,
+			&outputDistributions[kOutputDistributionIndexCalibratedCurrent],
+			NULL,
+			outputVariableNames[kOutputDistributionIndexCalibratedCurrent]);
+	}
+
+	if (arguments->common.isTimingEnabled)
+	{
+		printf("\nCPU time used: %lf seconds\n", cpuTimeUsedSeconds);
+	}
+
+	if (arguments->common.isWriteToFileEnabled)
+	{
+		if (writeOutputDoubleDistributionsToCSV(
+			arguments->common.outputFilePath,
+			outputDistributions,
+			outputVariableNames,
+			kOutputDistributionIndexMax))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief  Runs the Monte Carlo iterations in rounds until the confidence intervals of the
+ *		mean and of the queries meet the target of the -w option, or until the budget of
+ *		`numberOfMonteCarloIterations` iterations is spent. Each round doubles the number of
+ *		iterations so far, and appends its samples to those of the previous rounds.
+ *
+ *	@param  arguments		: The command-line arguments.
+ *	@param  threadPool		: The thread pool of the parallel engine, or `NULL` to run serially.
+ *	@param  blockContext		: The kernel context of the parallel engine.
+ *	@param  outputSamples		: Where to write the samples, with room for the whole budget.
+ *	@param  loopCycles		: Where to accumulate the cycles of the serial loop, or `NULL`.
+ *	@param  report			: Where to write the report of the last convergence check.
+ */
+static void
+runAdaptiveMonteCarlo(
+	const CommandLineArguments *	arguments,
+	ThreadPool *			threadPool,
+	MonteCarloBlockContext *	blockContext,
+	double *			outputSamples,
+	PhaseTimingSliceCycles *	loopCycles,
+	ConvergenceReport *		report)
+{
+	size_t	maximumIterations = arguments->common.numberOfMonteCarloIterations;
+	size_t	numberOfIterations = 0;
+
+	for (uint64_t round = 0; numberOfIterations < maximumIterations; round++)
+	{
+		size_t	roundEnd = (numberOfIterations < kConvergenceConstantInitialIterations / 2) ?
+					kConvergenceConstantInitialIterations : 2 * numberOfIterations;
+
+		roundEnd = (roundEnd < maximumIterations) ? roundEnd : maximumIterations;
+
+		if (threadPool != NULL)
+		{
+			/*
+			 *	Each round draws from its own seed, so that its random streams do
+			 *	not repeat those of the previous rounds. The quasi-random sequences
+			 *	and the Philox generator instead continue from the first iteration
+			 *	of the round.
+			 */
+			MonteCarloRun	run =
+					{
+						.numberOfIterations = roundEnd - numberOfIterations,
+						.firstIteration = numberOfIterations,
+						.seed = arguments->seed + round,
+						.kernel = evaluateMonteCarloBlock,
+						.kernelContext = blockContext,
+						.outputSamples = &outputSamples[numberOfIterations],
+						.summary = NULL,
+						.sliceStatistics = NULL,
+						.isRandomStreamUnused = isMonteCarloBlockRandomStreamUnused(blockContext),
+					};
+
+			runParallelMonteCarlo(threadPool, &run);
+		}
+		else
+		{
+			double			inputDistributions[kInputDistributionIndexMax];
+			double			outputDistributions[kOutputDistributionIndexMax];
+			SerialMonteCarloLoop	loop =
+						{
+							.inputDistributions = inputDistributions,
+							.outputDistributions = outputDistributions,
+							.errorModel = blockContext->errorModel,
+							.outputSamples = outputSamples,
+							.streamingStatistics = NULL,
+							.loopCycles = loopCycles,
+						};
+
+			runSerialMonteCarloLoop(&loop, arguments->sensorVariant, numberOfIterations, roundEnd);
+		}
+
+		numberOfIterations = roundEnd;
+
+		if (checkConvergence(outputSamples, numberOfIterations, &arguments->convergenceTarget, &arguments->queries, report))
+		{
+			break;
+		}
+	}
+
+	return;
+}
+
+/**
+ *	@brief  Creates the result cache of the -C option, loading it from its file if one is given.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *	@param  resultCache	: Set to the cache, or to `NULL` if the cache is disabled.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+openResultCache(const CommandLineArguments *  arguments, ResultCache **  resultCache)
+{
+	*resultCache = NULL;
+	if (arguments->resultCacheCapacity == 0)
+	{
+		return kCommonConstantReturnTypeSuccess;
+	}
+
+	if (createResultCache(arguments->resultCacheCapacity, resultCache) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((arguments->resultCachePath != NULL) && (loadResultCache(*resultCache, arguments->resultCachePath) != kCommonConstantReturnTypeSuccess))
+	{
+		destroyResultCache(*resultCache);
+		*resultCache = NULL;
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/**
+ *	@brief  Saves the result cache of the -C option to its file, if one is given, and releases it.
+ *
+ *	@param  arguments	: The command-line arguments.
+ *	@param  resultCache	: The cache. May be `NULL`.
+ *
+ *	@return	int		: `kCommonConstantReturnTypeSuccess` if successful, else `kCommonConstantReturnTypeError`.
+ */
+static int
+closeResultCache(const CommandLineArguments *  arguments, ResultCache *  resultCache)
+{
+	int	returnValue = kCommonConstantReturnTypeSuccess;
+
+	if ((resultCache != NULL) && (arguments->resultCachePath != NULL))
+	{
+		returnValue = saveResultCache(resultCache, arguments->resultCachePath);
+	}
+	destroyResultCache(resultCache);
+
+	return returnValue;
 }
 
 int
@@ -91,7 +1288,26 @@ main(int argc, char *  argv[])
 				{
 					"calibratedSensorOutput"
 				};
-	MeanAndVariance		meanAndVariance;
+	SampleMoments		sampleMoments;
+	ThreadPool *		threadPool = NULL;
+	const ConversionKernels *	conversionKernels = NULL;
+	StreamingStatistics	streamingStatistics;
+	StreamingHistogram	streamingHistogram;
+	DistributionSummary	summary;
+	int			returnValue = kCommonConstantReturnTypeSuccess;
+	PhaseTiming		phaseTiming;
+	MonteCarloBlockContext	blockContext = {0};
+	PhaseTimingSliceCycles	loopCycles = {0};
+	bool			isLoopInstrumented;
+	QuasiRandomSequence	quasiRandomSequence;
+	PhiloxKey		philoxKey;
+	ConvergenceReport	convergenceReport;
+	size_t			maximumIterations = 0;
+	ResultCache *		resultCache;
+	ResultCacheKey		resultCacheKey;
+	ResultCacheValue	resultCacheValue = {0};
+	bool			isCacheable = false;
+	bool			isResultCached = false;
 
 	/*
 	 *	Get command line arguments.
@@ -101,7 +1317,77 @@ main(int argc, char *  argv[])
 		return kCommonConstantReturnTypeError;
 	}
 
-	if (arguments.common.isMonteCarloMode)
+	if (openResultCache(&arguments, &resultCache) != kCommonConstantReturnTypeSuccess)
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	Long-running server, answering conversion requests over a socket.
+	 */
+	if (arguments.serverSocketPath != NULL)
+	{
+		returnValue = runConversionServer(
+				arguments.serverSocketPath,
+				(arguments.numberOfThreads > 0) ? arguments.numberOfThreads : 1,
+				arguments.conversionKernelIsa,
+				resultCache);
+
+		return (closeResultCache(&arguments, resultCache) != kCommonConstantReturnTypeSuccess) ? kCommonConstantReturnTypeError : returnValue;
+	}
+
+	/*
+	 *	Streaming conversion of a file of recorded readings, or of raw ADC codes,
+	 *	or overcurrent detection or sliding-window tracking on recorded readings.
+	 */
+	if (arguments.common.isInputFromFileEnabled)
+	{
+		if (arguments.adcResolution > 0)
+		{
+			returnValue = runAdcCodeStreamConversion(&arguments);
+		}
+		else if (arguments.isOvercurrentDetectionMode)
+		{
+			returnValue = runOvercurrentDetection(&arguments);
+		}
+		else if (arguments.slidingWindowSize > 0)
+		{
+			returnValue = runSlidingWindowTracking(&arguments);
+		}
+		else
+		{
+			returnValue = runRecordStreamConversion(&arguments, resultCache);
+		}
+
+		return (closeResultCache(&arguments, resultCache) != kCommonConstantReturnTypeSuccess) ? kCommonConstantReturnTypeError : returnValue;
+	}
+
+	/*
+	 *	Closed-form evaluation of the output distribution.
+	 */
+	if (arguments.isAnalyticMode)
+	{
+		returnValue = runAnalyticEvaluation(&arguments);
+
+		return (closeResultCache(&arguments, resultCache) != kCommonConstantReturnTypeSuccess) ? kCommonConstantReturnTypeError : returnValue;
+	}
+
+	/*
+	 *	The sampling and conversion cycles of the Monte Carlo loop are only
+	 *	measured when timing, as reading the cycle counter is not free.
+	 */
+	isLoopInstrumented = arguments.common.isTimingEnabled && hasCycleCounter();
+	initializePhaseTiming(&phaseTiming);
+	phaseTiming.numberOfSamples = arguments.common.numberOfMonteCarloIterations;
+	phaseTiming.numberOfThreads = (arguments.numberOfThreads > 0) ? arguments.numberOfThreads : 1;
+	beginPhase(&phaseTiming, kPhaseTimingPhaseSetup);
+	blockContext.errorModel = arguments.isErrorModelEnabled ? &arguments.errorModel : NULL;
+
+	/*
+	 *	In the streaming statistics mode, samples are summarized as they are
+	 *	generated, so there is no sample array to allocate.
+	 */
+	if (arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode)
 	{
 		monteCarloOutputSamples = (double *) checkedMalloc(
 							arguments.common.numberOfMonteCarloIterations * sizeof(double),
@@ -109,6 +1395,57 @@ main(int argc, char *  argv[])
 							__LINE__);
 	}
 
+	if (arguments.numberOfThreads > 0)
+	{
+		conversionKernels = selectConversionKernels(arguments.conversionKernelIsa);
+		if (conversionKernels == NULL)
+		{
+			fprintf(stderr, "Error: The requested conversion kernel (-k option) is not supported by this CPU.\n");
+			free(monteCarloOutputSamples);
+			destroyResultCache(resultCache);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (createThreadPool(arguments.numberOfThreads, &threadPool) != kCommonConstantReturnTypeSuccess)
+		{
+			free(monteCarloOutputSamples);
+			destroyResultCache(resultCache);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		blockContext.kernels = conversionKernels;
+		blockContext.sensorVariant = arguments.sensorVariant;
+
+		if (arguments.samplingMethod != kSamplingMethodPseudoRandom)
+		{
+			if (initializeQuasiRandomSequence(
+				&quasiRandomSequence,
+				arguments.samplingMethod,
+				arguments.common.numberOfMonteCarloIterations,
+				arguments.seed) != kCommonConstantReturnTypeSuccess)
+			{
+				free(monteCarloOutputSamples);
+				destroyThreadPool(threadPool);
+				destroyResultCache(resultCache);
+
+				return kCommonConstantReturnTypeError;
+			}
+			blockContext.quasiRandomSequence = &quasiRandomSequence;
+		}
+		if (arguments.randomGenerator == kRandomGeneratorPhilox)
+		{
+			seedPhiloxKey(&philoxKey, arguments.seed);
+			blockContext.philoxKey = &philoxKey;
+		}
+		if (isLoopInstrumented)
+		{
+			blockContext.sliceCycles = checkedMalloc(arguments.numberOfThreads * sizeof(PhaseTimingSliceCycles), __FILE__, __LINE__);
+			memset(blockContext.sliceCycles, 0, arguments.numberOfThreads * sizeof(PhaseTimingSliceCycles));
+		}
+	}
+
 	/*
 	 *	Start timing.
 	 */
@@ -116,37 +1453,142 @@ main(int argc, char *  argv[])
 	{
 		start = clock();
 	}
+	beginPhase(&phaseTiming, kPhaseTimingPhaseMonteCarloLoop);
 
-	for (size_t i = 0; i < arguments.common.numberOfMonteCarloIterations; i++)
+	/*
+	 *	A summary of the same inputs, iterations and random inputs may already
+	 *	be cached, in which case there is nothing to evaluate.
+	 */
+	isCacheable = (resultCache != NULL) &&
+		(makeResultCacheKey(
+			&resultCacheKey,
+			kResultCacheKindSummary,
+			kDefaultInputDistributionVoutUniformDistLow,
+			kDefaultInputDistributionVoutUniformDistHigh,
+			kDefaultInputDistributionVrefUniformDistLow,
+			kDefaultInputDistributionVrefUniformDistHigh,
+			arguments.sensorVariant->sensitivity,
+			arguments.common.numberOfMonteCarloIterations,
+			arguments.seed,
+			arguments.samplingMethod,
+			arguments.randomGenerator,
+			arguments.numberOfThreads,
+			NULL,
+			0) == kCommonConstantReturnTypeSuccess);
+	if (isCacheable)
 	{
-		/*
-		 *	Set input distribution values, inside the main computation
-		 *	loop, so that it can also generate samples in the native
-		 *	Monte Carlo Execution Mode.
-		 */
-		setInputDistributionsViaUxHwCall(inputDistributions);
+		isResultCached = lookupResultCache(resultCache, &resultCacheKey, &resultCacheValue);
+	}
 
-		calibratedSensorOutput = calculateSensorOutput(inputDistributions, outputDistributions);
+	if (isResultCached)
+	{
+		summary = resultCacheValue.summary;
+	}
+	else if (arguments.isAdaptiveMode)
+	{
+		maximumIterations = arguments.common.numberOfMonteCarloIterations;
+		runAdaptiveMonteCarlo(
+			&arguments,
+			threadPool,
+			&blockContext,
+			monteCarloOutputSamples,
+			(isLoopInstrumented && (threadPool == NULL)) ? &loopCycles : NULL,
+			&convergenceReport);
 
 		/*
-		 *	For this application, calibratedSensorOutput is the item we track.
+		 *	From here on, the evaluation is that of the iterations actually run.
 		 */
-		if (arguments.common.isMonteCarloMode)
+		arguments.common.numberOfMonteCarloIterations = convergenceReport.numberOfIterations;
+		phaseTiming.numberOfSamples = convergenceReport.numberOfIterations;
+
+		if (threadPool == NULL)
+		{
+			accumulatePhaseTimingSliceCycles(&phaseTiming, &loopCycles, 1);
+		}
+		else if (isLoopInstrumented)
+		{
+			accumulatePhaseTimingSliceCycles(&phaseTiming, blockContext.sliceCycles, arguments.numberOfThreads);
+		}
+	}
+	else if (arguments.numberOfThreads > 0)
+	{
+		MonteCarloRun	run =
+				{
+					.numberOfIterations = arguments.common.numberOfMonteCarloIterations,
+					.firstIteration = 0,
+					.seed = arguments.seed,
+					.kernel = evaluateMonteCarloBlock,
+					.kernelContext = &blockContext,
+					.outputSamples = monteCarloOutputSamples,
+					.summary = &summary,
+					.histogram = &streamingHistogram,
+					.sliceStatistics = NULL,
+					.isRandomStreamUnused = isMonteCarloBlockRandomStreamUnused(&blockContext),
+				};
+
+		runParallelMonteCarlo(threadPool, &run);
+
+		if (isLoopInstrumented)
+		{
+			accumulatePhaseTimingSliceCycles(&phaseTiming, blockContext.sliceCycles, arguments.numberOfThreads);
+		}
+	}
+	else
+	{
+		SerialMonteCarloLoop	loop =
+					{
+						.inputDistributions = inputDistributions,
+						.outputDistributions = outputDistributions,
+						.errorModel = blockContext.errorModel,
+						.outputSamples = arguments.common.isMonteCarloMode ? monteCarloOutputSamples : NULL,
+						.streamingStatistics = arguments.isStreamingStatisticsMode ? &streamingStatistics : NULL,
+						.loopCycles = isLoopInstrumented ? &loopCycles : NULL,
+					};
+
+		initializeStreamingStatistics(&streamingStatistics, 0);
+
+		calibratedSensorOutput = runSerialMonteCarloLoop(&loop, arguments.sensorVariant, 0, arguments.common.numberOfMonteCarloIterations);
+
+		if (arguments.isStreamingStatisticsMode)
 		{
-			monteCarloOutputSamples[i] = calibratedSensorOutput;
+			summarizeStreamingStatistics(&streamingStatistics, 1, &summary, &streamingHistogram);
 		}
+
+		accumulatePhaseTimingSliceCycles(&phaseTiming, &loopCycles, 1);
+	}
+	/*
+	 *	The streamed samples are gone once summarized, so the probabilities printed
+	 *	for the output are taken from their histogram now, and cached with the summary.
+	 */
+	if (arguments.isStreamingStatisticsMode && !isResultCached)
+	{
+		getCalibratedValueProbabilitiesFromCDF(summary.mean, getStreamingHistogramCDF, &streamingHistogram, resultCacheValue.thresholdProbabilities);
 	}
+	if (isCacheable && !isResultCached)
+	{
+		resultCacheValue.summary = summary;
+		insertResultCache(resultCache, &resultCacheKey, &resultCacheValue);
+	}
+	beginPhase(&phaseTiming, kPhaseTimingPhasePostProcessing);
 
 	/*
-	 *	If not doing Laplace version, then approximate the cost of the third phase of
-	 *	Monte Carlo (post-processing), by calculating the mean and variance.
+	 *	If not doing Laplace version, then the third phase of Monte Carlo (post-processing)
+	 *	computes the moments of the samples, on the threads of the parallel engine, if any.
+	 *	In the streaming statistics mode, the summary has already been computed online.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	if (arguments.isStreamingStatisticsMode)
+	{
+		calibratedSensorOutput = summary.mean;
+	}
+	else if (arguments.common.isMonteCarloMode)
 	{
-		meanAndVariance = calculateMeanAndVarianceOfDoubleSamples(
-					monteCarloOutputSamples,
-					arguments.common.numberOfMonteCarloIterations);
-		calibratedSensorOutput = meanAndVariance.mean;
+		reduceSampleMoments(
+			threadPool,
+			(conversionKernels != NULL) ? conversionKernels : selectConversionKernels(kConversionKernelIsaAutomatic),
+			monteCarloOutputSamples,
+			arguments.common.numberOfMonteCarloIterations,
+			&sampleMoments);
+		calibratedSensorOutput = sampleMoments.mean;
 	}
 
 	/*
@@ -157,6 +1599,7 @@ main(int argc, char *  argv[])
 		end = clock();
 		cpuTimeUsedSeconds = ((double)(end - start)) / CLOCKS_PER_SEC;
 	}
+	beginPhase(&phaseTiming, kPhaseTimingPhaseOutput);
 
 	if (arguments.common.isBenchmarkingMode)
 	{
@@ -172,7 +1615,31 @@ main(int argc, char *  argv[])
 		/*
 		 *	Print the results (either in JSON or standard output format).
 		 */
-		if (!arguments.common.isOutputJSONMode)
+		if (!arguments.common.isOutputJSONMode && arguments.common.isMonteCarloMode && !arguments.isStreamingStatisticsMode)
+		{
+			SampleQueryIndex	sampleQueryIndex;
+
+			/*
+			 *	Sort the samples once, so that the probabilities and any further
+			 *	queries are answered from the empirical distribution by binary search.
+			 */
+			buildSampleQueryIndex(monteCarloOutputSamples, arguments.common.numberOfMonteCarloIterations, &sampleQueryIndex);
+			printCalibratedValueAndProbabilitiesFromCDF(calibratedSensorOutput, sampleQueryIndexCDF, &sampleQueryIndex);
+			printSampleMoments(&sampleMoments);
+			printQueryResults(&arguments.queries, sampleQueryIndexCDF, sampleQueryIndexQuantile, &sampleQueryIndex);
+			freeSampleQueryIndex(&sampleQueryIndex);
+
+			if (arguments.isAdaptiveMode)
+			{
+				printConvergenceReport(&convergenceReport, &arguments.convergenceTarget, maximumIterations);
+			}
+		}
+		else if (!arguments.common.isOutputJSONMode && arguments.isStreamingStatisticsMode)
+		{
+			printCalibratedValueAndProbabilityValues(calibratedSensorOutput, resultCacheValue.thresholdProbabilities);
+			printDistributionSummary(&summary);
+		}
+		else if (!arguments.common.isOutputJSONMode)
 		{
 			printCalibratedValueAndProbabilities(calibratedSensorOutput);
 		}
@@ -185,14 +1652,6 @@ main(int argc, char *  argv[])
 				outputVariableNames[kOutputDistributionIndexCalibratedCurrent]);
 		}
 
-		/*
-		 *	Print timing result.
-		 */
-		if (arguments.common.isTimingEnabled)
-		{
-			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedSeconds);
-		}
-
 		/*
 		 *	Write output data.
 		 */
@@ -204,7 +1663,7 @@ main(int argc, char *  argv[])
 				outputVariableNames,
 				kOutputDistributionIndexMax))
 			{
-				return kCommonConstantReturnTypeError;
+				returnValue = kCommonConstantReturnTypeError;
 			}
 		}
 	}
@@ -213,12 +1672,57 @@ main(int argc, char *  argv[])
 	 *	Save Monte carlo outputs in an output file.
 	 *	Free dynamically-allocated memory.
 	 */
-	if (arguments.common.isMonteCarloMode)
+	if (arguments.common.isMonteCarloMode && arguments.isBinaryDataOutEnabled)
+	{
+		if (saveMonteCarloDoubleDataToDataDotBinFile(
+			monteCarloOutputSamples,
+			(uint64_t)(cpuTimeUsedSeconds*1000000),
+			arguments.common.numberOfMonteCarloIterations,
+			arguments.seed,
+			arguments.numberOfThreads > 0))
+		{
+			returnValue = kCommonConstantReturnTypeError;
+		}
+	}
+	else if (arguments.common.isMonteCarloMode && arguments.isDataDotOutEnabled)
 	{
 		saveMonteCarloDoubleDataToDataDotOutFile(monteCarloOutputSamples, (uint64_t)(cpuTimeUsedSeconds*1000000), arguments.common.numberOfMonteCarloIterations);
+	}
+	if (resultCache != NULL)
+	{
+		ResultCacheStatistics	statistics = getResultCacheStatistics(resultCache);
+
+		phaseTiming.isResultCacheEnabled = true;
+		phaseTiming.resultCacheHits = statistics.hits;
+		phaseTiming.resultCacheMisses = statistics.misses;
+	}
+	if (closeResultCache(&arguments, resultCache) != kCommonConstantReturnTypeSuccess)
+	{
+		returnValue = kCommonConstantReturnTypeError;
+	}
+	endPhase(&phaseTiming);
 
-		free(monteCarloOutputSamples);
+	/*
+	 *	Print timing result, once the output phase has been timed as well.
+	 */
+	if (arguments.common.isTimingEnabled && !arguments.common.isBenchmarkingMode)
+	{
+		if (arguments.common.isOutputJSONMode)
+		{
+			printPhaseTimingJSON(&phaseTiming);
+		}
+		else
+		{
+			printf("\nCPU time used: %lf seconds\n", cpuTimeUsedSeconds);
+			printPhaseTiming(&phaseTiming);
+		}
 	}
 
-	return 0;
+	free(monteCarloOutputSamples);
+	free(blockContext.sliceCycles);
+
+	destroyThreadPool(threadPool);
+	freeSampleQueryList(&arguments.queries);
+
+	return returnValue;
 }
@@ -0,0 +1,126 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "monte-carlo.h"
+
+typedef struct
+{
+	const MonteCarloRun *	run;
+	size_t			numberOfSlices;
+	StreamingStatistics *	sliceStatistics;
+} MonteCarloSliceContext;
+
+/*
+ *	The first iteration of a slice. The slices start at chunk boundaries of the
+ *	streaming statistics, so that their summary does not depend on the slicing.
+ */
+static size_t
+getMonteCarloSliceBoundary(size_t numberOfIterations, size_t sliceIndex, size_t numberOfSlices)
+{
+	size_t	boundary = (size_t)(((uint64_t)numberOfIterations * sliceIndex) / numberOfSlices);
+
+	if (sliceIndex == numberOfSlices)
+	{
+		return numberOfIterations;
+	}
+
+	return boundary - boundary % kStreamingStatisticsConstantChunkSize;
+}
+
+static void
+runMonteCarloSlice(size_t sliceIndex, void *  context)
+{
+	MonteCarloSliceContext *	sliceContext = context;
+	const MonteCarloRun *		run = sliceContext->run;
+	size_t				begin = getMonteCarloSliceBoundary(run->numberOfIterations, sliceIndex, sliceContext->numberOfSlices);
+	size_t				end = getMonteCarloSliceBoundary(run->numberOfIterations, sliceIndex + 1, sliceContext->numberOfSlices);
+	RandomLaneStream		randomStream;
+
+	/*
+	 *	The statistics of a slice span many cache lines, so workers accumulate them
+	 *	in place: only the lines at the ends of neighbouring slices are shared.
+	 */
+	StreamingStatistics *		statistics = (run->outputSamples == NULL) ? &sliceContext->sliceStatistics[sliceIndex] : NULL;
+
+	if (run->isRandomStreamUnused)
+	{
+		memset(&randomStream, 0, sizeof(randomStream));
+	}
+	else
+	{
+		seedRandomLaneStream(&randomStream, run->seed, sliceIndex);
+	}
+	if (statistics != NULL)
+	{
+		initializeStreamingStatistics(statistics, begin);
+	}
+
+	for (size_t i = begin; i < end; i += kMonteCarloConstantBlockSize)
+	{
+		size_t	count = ((end - i) < kMonteCarloConstantBlockSize) ? (end - i) : kMonteCarloConstantBlockSize;
+
+		if (run->outputSamples != NULL)
+		{
+			run->kernel(&randomStream, &run->outputSamples[i], run->firstIteration + i, count, sliceIndex, run->kernelContext);
+		}
+		else
+		{
+			double	block[kMonteCarloConstantBlockSize];
+
+			run->kernel(&randomStream, block, run->firstIteration + i, count, sliceIndex, run->kernelContext);
+			updateStreamingStatisticsBlock(statistics, block, count);
+		}
+	}
+
+	return;
+}
+
+void
+runParallelMonteCarlo(ThreadPool *  pool, const MonteCarloRun *  run)
+{
+	MonteCarloSliceContext	sliceContext =
+				{
+					.run = run,
+					.numberOfSlices = getThreadPoolSize(pool),
+					.sliceStatistics = run->sliceStatistics,
+				};
+
+	if ((run->outputSamples == NULL) && (run->sliceStatistics == NULL))
+	{
+		sliceContext.sliceStatistics = checkedMalloc(sliceContext.numberOfSlices * sizeof(StreamingStatistics), __FILE__, __LINE__);
+	}
+
+	runThreadPoolTasks(pool, runMonteCarloSlice, &sliceContext, sliceContext.numberOfSlices);
+
+	if (run->outputSamples == NULL)
+	{
+		summarizeStreamingStatistics(sliceContext.sliceStatistics, sliceContext.numberOfSlices, run->summary, run->histogram);
+		if (run->sliceStatistics == NULL)
+		{
+			free(sliceContext.sliceStatistics);
+		}
+	}
+
+	return;
+}
@@ -0,0 +1,109 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "random.h"
+#include "streaming-statistics.h"
+#include "thread-pool.h"
+
+/*
+ *	The engine hands the iterations of a slice to the kernel in blocks of at
+ *	most `kMonteCarloConstantBlockSize` iterations, so that the kernel's
+ *	structure-of-arrays scratch buffers stay in the L1 cache.
+ */
+typedef enum
+{
+	kMonteCarloConstantBlockSize	= 512,
+} MonteCarloConstant;
+
+/*
+ *	Evaluates `count` Monte Carlo iterations, starting at iteration `firstIteration`
+ *	of the run, drawing their input samples from `randomStream`, and writes the
+ *	resulting output samples to `outputSamples`. `sliceIndex` identifies the
+ *	worker's slice, so that the kernel may keep per-slice state in `context`.
+ */
+typedef void	(*MonteCarloBlockKernel)(
+			RandomLaneStream *	randomStream,
+			double *		outputSamples,
+			size_t			firstIteration,
+			size_t			count,
+			size_t			sliceIndex,
+			void *			context);
+
+typedef struct
+{
+	size_t			numberOfIterations;
+
+	/*
+	 *	The index of the first iteration of the run within a longer evaluation
+	 *	made of several runs (see the `-w` option), as passed on to the kernel.
+	 *	Zero for a standalone run.
+	 */
+	size_t			firstIteration;
+	uint64_t		seed;
+	MonteCarloBlockKernel	kernel;
+	void *			kernelContext;
+
+	/*
+	 *	Where the samples go. If `outputSamples` is `NULL`, the samples are not
+	 *	stored: each worker keeps streaming statistics of its slice instead, and
+	 *	their merge is written to `summary`, and their merged histogram to
+	 *	`histogram`, unless it is `NULL`.
+	 */
+	double *		outputSamples;
+	DistributionSummary *	summary;
+	StreamingHistogram *	histogram;
+
+	/*
+	 *	Optional scratch space for the statistics of each slice, with room for
+	 *	one per worker, so that a caller running many small evaluations can
+	 *	allocate it once. If `NULL`, the engine allocates it for each run.
+	 */
+	StreamingStatistics *	sliceStatistics;
+
+	/*
+	 *	Set when the kernel never draws from `randomStream` (e.g., because it draws the
+	 *	samples of an iteration from its index), so that the workers skip seeding their
+	 *	lane streams, which takes a number of jumps that grows with the worker index.
+	 */
+	bool			isRandomStreamUnused;
+} MonteCarloRun;
+
+/**
+ *	@brief	Run the iterations of a Monte Carlo evaluation in parallel. The iterations
+ *		are split into one contiguous slice per worker of `pool`, starting at a chunk
+ *		boundary of the streaming statistics; worker `t` draws from lane stream `t`
+ *		of `run->seed` and writes its samples to its own slice of `run->outputSamples`.
+ *		The samples therefore only depend on the seed and the number of threads. The
+ *		summary of a run without stored samples only depends on its samples, so it
+ *		does not depend on the number of threads when the kernel draws the samples
+ *		of an iteration from its index (e.g., with Philox or quasi-random points).
+ *
+ *	@param	pool		: The thread pool to run on.
+ *	@param	run		: The evaluation to run.
+ */
+void	runParallelMonteCarlo(ThreadPool *  pool, const MonteCarloRun *  run);
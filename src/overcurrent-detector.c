@@ -0,0 +1,215 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "overcurrent-detector.h"
+#include "analytic.h"
+
+typedef enum
+{
+	kOvercurrentDetectorConstantBlockSize	= 512,
+} OvercurrentDetectorPrivateConstant;
+
+struct OvercurrentDetector
+{
+	_Alignas(64) double			vout[kOvercurrentDetectorConstantBlockSize];
+	_Alignas(64) double			vref[kOvercurrentDetectorConstantBlockSize];
+	_Alignas(64) double			current[kOvercurrentDetectorConstantBlockSize];
+	RandomLaneStream			randomStream;
+	OvercurrentDetectorConfiguration	configuration;
+	const ConversionKernels *		kernels;
+	double					sensitivity;
+	double					reciprocalSensitivity;
+	bool					isTripped;
+};
+
+CommonConstantReturnType
+createOvercurrentDetector(
+	const OvercurrentDetectorConfiguration *  configuration,
+	const ConversionKernels *  kernels,
+	double sensitivity,
+	uint64_t seed,
+	OvercurrentDetector **  detector)
+{
+	OvercurrentDetector *	newDetector;
+
+	if (!isfinite(configuration->threshold) || !(configuration->level > 0) || !(configuration->level < 1) ||
+		(configuration->maximumNumberOfSamples == 0) || (sensitivity == 0))
+	{
+		fprintf(stderr, "Error: Invalid overcurrent detector configuration.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newDetector = aligned_alloc(_Alignof(OvercurrentDetector), sizeof(OvercurrentDetector));
+	if (newDetector == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate overcurrent detector.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newDetector->configuration = *configuration;
+	newDetector->kernels = kernels;
+	newDetector->sensitivity = sensitivity;
+	newDetector->reciprocalSensitivity = 1.0 / sensitivity;
+	newDetector->isTripped = false;
+	seedRandomLaneStream(&newDetector->randomStream, seed, 0);
+
+	*detector = newDetector;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+/*
+ *	Whether the Wilson score interval of a probability, estimated from
+ *	`numberOfExceedances` out of `numberOfSamples` samples, excludes `level`.
+ */
+static bool
+isOvercurrentDecisionSettled(size_t numberOfExceedances, size_t numberOfSamples, double level, bool *  isAboveLevel)
+{
+	double	n = (double)numberOfSamples;
+	double	probability = (double)numberOfExceedances / n;
+	double	zSquaredOverN = kOvercurrentDetectorConfidenceZ * kOvercurrentDetectorConfidenceZ / n;
+	double	center = (probability + 0.5 * zSquaredOverN) / (1.0 + zSquaredOverN);
+	double	halfWidth = kOvercurrentDetectorConfidenceZ *
+				sqrt(probability * (1.0 - probability) / n + 0.25 * zSquaredOverN / n) / (1.0 + zSquaredOverN);
+
+	if (center - halfWidth > level)
+	{
+		*isAboveLevel = true;
+
+		return true;
+	}
+
+	if (center + halfWidth < level)
+	{
+		*isAboveLevel = false;
+
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ *	Draws `count` samples of the current of `record` and returns how many
+ *	of them exceed the threshold.
+ */
+static size_t
+countOvercurrentExceedances(OvercurrentDetector *  detector, const SensorReadingRecord *  record, size_t count)
+{
+	size_t	numberOfExceedances = 0;
+
+	for (size_t first = 0; first < count; first += kOvercurrentDetectorConstantBlockSize)
+	{
+		size_t	blockCount = (count - first < kOvercurrentDetectorConstantBlockSize) ? (count - first) : kOvercurrentDetectorConstantBlockSize;
+
+		detector->kernels->fillUniformBlock(&detector->randomStream, detector->vout, blockCount, record->voutLow, record->voutHigh);
+		detector->kernels->fillUniformBlock(&detector->randomStream, detector->vref, blockCount, record->vrefLow, record->vrefHigh);
+		detector->kernels->convertSensorOutputBlock(
+					detector->vout,
+					detector->vref,
+					detector->current,
+					blockCount,
+					detector->reciprocalSensitivity);
+
+		for (size_t i = 0; i < blockCount; i++)
+		{
+			numberOfExceedances += (detector->current[i] > detector->configuration.threshold);
+		}
+	}
+
+	return numberOfExceedances;
+}
+
+OvercurrentEvent
+evaluateOvercurrentDetector(OvercurrentDetector *  detector, const SensorReadingRecord *  record, OvercurrentDecision *  decision)
+{
+	const OvercurrentDetectorConfiguration *	configuration = &detector->configuration;
+	TrapezoidalDistribution				support;
+	size_t						numberOfExceedances = 0;
+	size_t						numberOfSamples = 0;
+	size_t						nextCheck = kOvercurrentDetectorConstantInitialSamples;
+	bool						wasTripped = detector->isTripped;
+
+	*decision = (OvercurrentDecision) {0};
+
+	/*
+	 *	A threshold outside the support of the current settles the reading
+	 *	without sampling.
+	 */
+	support = makeCalibratedOutputDistribution(record->voutLow, record->voutHigh, record->vrefLow, record->vrefHigh, detector->sensitivity);
+	if ((configuration->threshold >= support.lowerBound + support.smallerWidth + support.largerWidth) ||
+		(configuration->threshold < support.lowerBound))
+	{
+		decision->probability = (configuration->threshold < support.lowerBound) ? 1.0 : 0.0;
+		decision->isAboveLevel = (decision->probability > configuration->level);
+		decision->isSettled = true;
+	}
+	else
+	{
+		while (numberOfSamples < configuration->maximumNumberOfSamples)
+		{
+			nextCheck = (nextCheck < configuration->maximumNumberOfSamples) ? nextCheck : configuration->maximumNumberOfSamples;
+			numberOfExceedances += countOvercurrentExceedances(detector, record, nextCheck - numberOfSamples);
+			numberOfSamples = nextCheck;
+			nextCheck *= 2;
+
+			if (isOvercurrentDecisionSettled(numberOfExceedances, numberOfSamples, configuration->level, &decision->isAboveLevel))
+			{
+				decision->isSettled = true;
+				break;
+			}
+		}
+
+		decision->numberOfSamples = numberOfSamples;
+		decision->probability = (double)numberOfExceedances / (double)numberOfSamples;
+
+		/*
+		 *	A reading whose interval still straddles the level holds the decision
+		 *	of the previous reading, so that readings at the level do not chatter.
+		 */
+		if (!decision->isSettled)
+		{
+			decision->isAboveLevel = wasTripped;
+		}
+	}
+
+	detector->isTripped = decision->isAboveLevel;
+	if (detector->isTripped == wasTripped)
+	{
+		return kOvercurrentEventNone;
+	}
+
+	return detector->isTripped ? kOvercurrentEventTrip : kOvercurrentEventClear;
+}
+
+void
+destroyOvercurrentDetector(OvercurrentDetector *  detector)
+{
+	free(detector);
+
+	return;
+}
@@ -0,0 +1,124 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "conversion-kernels.h"
+#include "record-stream.h"
+
+/*
+ *	Each reading is sampled in rounds of doubling size, from
+ *	`kOvercurrentDetectorConstantInitialSamples` samples up to the maximum
+ *	number of samples per reading, which bounds the latency of a reading.
+ *	After each round, the decision is settled once the Wilson score interval
+ *	of P(current > threshold), at `kOvercurrentDetectorConfidenceZ` standard
+ *	deviations (two-sided 99.9%), lies entirely above or below the level.
+ */
+typedef enum
+{
+	kOvercurrentDetectorConstantInitialSamples		= 64,
+	kOvercurrentDetectorConstantDefaultMaximumSamples	= 1 << 16,
+	kOvercurrentDetectorConstantMaxMaximumSamples		= 1 << 24,
+} OvercurrentDetectorConstant;
+
+#define kOvercurrentDetectorConfidenceZ		(3.2905)
+
+/*
+ *	Events of the detector, when the decision of a reading differs from that
+ *	of the reading before it (the first reading is compared to `kOvercurrentEventClear`):
+ *		kOvercurrentEventNone	: The decision is unchanged.
+ *		kOvercurrentEventTrip	: P(current > threshold) rose above the level.
+ *		kOvercurrentEventClear	: P(current > threshold) fell below the level.
+ */
+typedef enum
+{
+	kOvercurrentEventNone	= 0,
+	kOvercurrentEventTrip	= 1,
+	kOvercurrentEventClear	= 2,
+} OvercurrentEvent;
+
+typedef struct
+{
+	double	threshold;
+	double	level;
+	size_t	maximumNumberOfSamples;
+} OvercurrentDetectorConfiguration;
+
+/*
+ *	The decision of the detector for one reading. `probability` is the fraction
+ *	of samples above the threshold, or exactly 0 or 1 when the threshold lies
+ *	outside the support of the current, in which case no samples are drawn.
+ *	`isSettled` is `false` when the maximum number of samples was reached before
+ *	the confidence interval excluded the level, in which case the decision of
+ *	the previous reading is kept.
+ */
+typedef struct
+{
+	bool		isAboveLevel;
+	bool		isSettled;
+	size_t		numberOfSamples;
+	double		probability;
+} OvercurrentDecision;
+
+typedef struct OvercurrentDetector	OvercurrentDetector;
+
+/**
+ *	@brief	Create a detector. Readings are sampled with the batched kernels, from a
+ *		single random lane stream.
+ *
+ *	@param	configuration	: The threshold (in Ampere), the level, in (0, 1), and the maximum
+ *				  number of samples per reading.
+ *	@param	kernels		: The batched sampling and conversion kernels to use.
+ *	@param	sensitivity	: Sensitivity of the sensor (in Volt per Ampere). Must be non-zero.
+ *	@param	seed		: Seed of the random stream.
+ *	@param	detector	: Set to the detector on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createOvercurrentDetector(
+					const OvercurrentDetectorConfiguration *  configuration,
+					const ConversionKernels *  kernels,
+					double sensitivity,
+					uint64_t seed,
+					OvercurrentDetector **  detector);
+
+/**
+ *	@brief	Decide whether P(current > threshold) is above the level for a reading, and
+ *		update the state of the detector.
+ *
+ *	@param	detector	: The detector.
+ *	@param	record		: The reading.
+ *	@param	decision	: Where to write the decision.
+ *	@return			: The event, if the decision differs from that of the previous reading.
+ */
+OvercurrentEvent	evaluateOvercurrentDetector(OvercurrentDetector *  detector, const SensorReadingRecord *  record, OvercurrentDecision *  decision);
+
+/**
+ *	@brief	Release the detector.
+ *
+ *	@param	detector	: The detector. May be `NULL`.
+ */
+void	destroyOvercurrentDetector(OvercurrentDetector *  detector);
@@ -0,0 +1,208 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "phase-timing.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PHASE_TIMING_HAS_CYCLE_COUNTER	1
+#else
+#define PHASE_TIMING_HAS_CYCLE_COUNTER	0
+#endif
+
+static const char *	kPhaseTimingPhaseNames[kPhaseTimingPhaseMax] =
+			{
+				[kPhaseTimingPhaseSetup]		= "setup",
+				[kPhaseTimingPhaseMonteCarloLoop]	= "monteCarloLoop",
+				[kPhaseTimingPhasePostProcessing]	= "postProcessing",
+				[kPhaseTimingPhaseOutput]		= "output",
+			};
+
+uint64_t
+readMonotonicNanoseconds(void)
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+#else
+	return (uint64_t)((double)clock() * (1e9 / CLOCKS_PER_SEC));
+#endif
+}
+
+bool
+hasCycleCounter(void)
+{
+	return PHASE_TIMING_HAS_CYCLE_COUNTER;
+}
+
+uint64_t
+readCycleCounter(void)
+{
+#if PHASE_TIMING_HAS_CYCLE_COUNTER
+	return (uint64_t)__rdtsc();
+#else
+	return 0;
+#endif
+}
+
+void
+initializePhaseTiming(PhaseTiming *  timing)
+{
+	memset(timing, 0, sizeof(*timing));
+
+	return;
+}
+
+void
+beginPhase(PhaseTiming *  timing, PhaseTimingPhase phase)
+{
+	endPhase(timing);
+
+	timing->currentPhase = phase;
+	timing->isPhaseRunning = true;
+	timing->phaseStartCycles = readCycleCounter();
+	timing->phaseStartNanoseconds = readMonotonicNanoseconds();
+
+	return;
+}
+
+void
+endPhase(PhaseTiming *  timing)
+{
+	uint64_t	nanoseconds = readMonotonicNanoseconds();
+	uint64_t	cycles = readCycleCounter();
+
+	if (!timing->isPhaseRunning)
+	{
+		return;
+	}
+
+	timing->wallNanoseconds[timing->currentPhase] += nanoseconds - timing->phaseStartNanoseconds;
+	timing->cycles[timing->currentPhase] += cycles - timing->phaseStartCycles;
+	timing->isPhaseRunning = false;
+
+	return;
+}
+
+void
+accumulatePhaseTimingSliceCycles(PhaseTiming *  timing, const PhaseTimingSliceCycles *  sliceCycles, size_t numberOfSlices)
+{
+	for (size_t i = 0; i < numberOfSlices; i++)
+	{
+		timing->samplingCycles += sliceCycles[i].samplingCycles;
+		timing->conversionCycles += sliceCycles[i].conversionCycles;
+	}
+
+	return;
+}
+
+/*
+ *	Samples per second of wall-clock time in the Monte Carlo loop.
+ */
+static double
+getPhaseTimingThroughput(const PhaseTiming *  timing)
+{
+	uint64_t	nanoseconds = timing->wallNanoseconds[kPhaseTimingPhaseMonteCarloLoop];
+
+	return (nanoseconds > 0) ? (double)timing->numberOfSamples * 1e9 / (double)nanoseconds : 0.0;
+}
+
+void
+printPhaseTiming(const PhaseTiming *  timing)
+{
+	uint64_t	totalNanoseconds = 0;
+
+	for (size_t i = 0; i < kPhaseTimingPhaseMax; i++)
+	{
+		totalNanoseconds += timing->wallNanoseconds[i];
+	}
+
+	printf("\nWall-clock time per phase:\n");
+	for (size_t i = 0; i < kPhaseTimingPhaseMax; i++)
+	{
+		printf(
+			"\t%-16s %12.6lf seconds (%5.1lf%%)",
+			kPhaseTimingPhaseNames[i],
+			(double)timing->wallNanoseconds[i] * 1e-9,
+			(totalNanoseconds > 0) ? 100.0 * (double)timing->wallNanoseconds[i] / (double)totalNanoseconds : 0.0);
+		if (hasCycleCounter())
+		{
+			printf(", %" PRIu64 " cycles", timing->cycles[i]);
+		}
+		printf("\n");
+	}
+	printf("\t%-16s %12.6lf seconds\n", "total", (double)totalNanoseconds * 1e-9);
+
+	if (hasCycleCounter() && (timing->samplingCycles + timing->conversionCycles > 0))
+	{
+		printf(
+			"\tMonte Carlo loop, summed over %zu thread(s): sampling %" PRIu64 " cycles, conversion %" PRIu64 " cycles\n",
+			timing->numberOfThreads,
+			timing->samplingCycles,
+			timing->conversionCycles);
+	}
+	printf("\tThroughput: %.0lf samples/s\n", getPhaseTimingThroughput(timing));
+	if (timing->isResultCacheEnabled)
+	{
+		printf("\tResult cache: %" PRIu64 " hit(s), %" PRIu64 " miss(es)\n", timing->resultCacheHits, timing->resultCacheMisses);
+	}
+
+	return;
+}
+
+void
+printPhaseTimingJSON(const PhaseTiming *  timing)
+{
+	printf("{\"timing\":{\"phases\":{");
+	for (size_t i = 0; i < kPhaseTimingPhaseMax; i++)
+	{
+		printf(
+			"%s\"%s\":{\"wallNanoseconds\":%" PRIu64 ",\"cycles\":%" PRIu64 "}",
+			(i > 0) ? "," : "",
+			kPhaseTimingPhaseNames[i],
+			timing->wallNanoseconds[i],
+			timing->cycles[i]);
+	}
+	printf(
+		"},\"samplingCycles\":%" PRIu64 ",\"conversionCycles\":%" PRIu64 ",\"hasCycleCounter\":%s"
+		",\"numberOfSamples\":%zu,\"numberOfThreads\":%zu,\"samplesPerSecond\":%.1lf",
+		timing->samplingCycles,
+		timing->conversionCycles,
+		hasCycleCounter() ? "true" : "false",
+		timing->numberOfSamples,
+		timing->numberOfThreads,
+		getPhaseTimingThroughput(timing));
+	if (timing->isResultCacheEnabled)
+	{
+		printf(",\"resultCache\":{\"hits\":%" PRIu64 ",\"misses\":%" PRIu64 "}", timing->resultCacheHits, timing->resultCacheMisses);
+	}
+	printf("}}\n");
+
+	return;
+}
@@ -0,0 +1,151 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+
+/*
+ *	The phases of a Monte Carlo evaluation, timed by the `-T` option:
+ *		kPhaseTimingPhaseSetup		: Allocation of the samples, kernel selection and thread pool creation.
+ *		kPhaseTimingPhaseMonteCarloLoop	: Sampling of the inputs and conversion to the output samples.
+ *		kPhaseTimingPhasePostProcessing	: Mean and variance (or summary) of the output samples.
+ *		kPhaseTimingPhaseOutput		: Printing of the results and saving of the samples.
+ */
+typedef enum
+{
+	kPhaseTimingPhaseSetup		= 0,
+	kPhaseTimingPhaseMonteCarloLoop	= 1,
+	kPhaseTimingPhasePostProcessing	= 2,
+	kPhaseTimingPhaseOutput		= 3,
+	kPhaseTimingPhaseMax,
+} PhaseTimingPhase;
+
+/*
+ *	Cycles spent by one worker (or the serial loop) in sampling and in conversion.
+ *	Aligned to a cache line, so that workers can update adjacent counters without
+ *	sharing cache lines.
+ */
+typedef struct
+{
+	_Alignas(64) uint64_t	samplingCycles;
+	uint64_t		conversionCycles;
+} PhaseTimingSliceCycles;
+
+typedef struct
+{
+	uint64_t	wallNanoseconds[kPhaseTimingPhaseMax];
+	uint64_t	cycles[kPhaseTimingPhaseMax];
+
+	/*
+	 *	Breakdown of the Monte Carlo loop, summed over workers. Only measured
+	 *	when a cycle counter is available.
+	 */
+	uint64_t	samplingCycles;
+	uint64_t	conversionCycles;
+	size_t		numberOfSamples;
+	size_t		numberOfThreads;
+
+	/*
+	 *	Lookups of the result cache (`-C` option), when it is enabled.
+	 */
+	bool		isResultCacheEnabled;
+	uint64_t	resultCacheHits;
+	uint64_t	resultCacheMisses;
+
+	PhaseTimingPhase	currentPhase;
+	bool			isPhaseRunning;
+	uint64_t		phaseStartNanoseconds;
+	uint64_t		phaseStartCycles;
+} PhaseTiming;
+
+/**
+ *	@brief	Read a monotonic clock. Falls back to the processor time of the process
+ *		on platforms without `CLOCK_MONOTONIC`.
+ *
+ *	@return	: The time in nanoseconds, from an arbitrary origin.
+ */
+uint64_t	readMonotonicNanoseconds(void);
+
+/**
+ *	@brief	Whether `readCycleCounter()` reads a hardware cycle counter (the x86 time
+ *		stamp counter).
+ *
+ *	@return	: `true` if a cycle counter is available.
+ */
+bool	hasCycleCounter(void);
+
+/**
+ *	@brief	Read the cycle counter.
+ *
+ *	@return	: The counter, or 0 if `hasCycleCounter()` is `false`.
+ */
+uint64_t	readCycleCounter(void);
+
+/**
+ *	@brief	Reset all phase times and counters.
+ *
+ *	@param	timing	: The timing to reset.
+ */
+void	initializePhaseTiming(PhaseTiming *  timing);
+
+/**
+ *	@brief	Start timing a phase, ending the running phase, if any. A phase that
+ *		is started more than once accumulates its times.
+ *
+ *	@param	timing	: The timing.
+ *	@param	phase	: The phase to start.
+ */
+void	beginPhase(PhaseTiming *  timing, PhaseTimingPhase phase);
+
+/**
+ *	@brief	End the running phase, if any.
+ *
+ *	@param	timing	: The timing.
+ */
+void	endPhase(PhaseTiming *  timing);
+
+/**
+ *	@brief	Add the per-slice sampling and conversion cycles to the loop breakdown.
+ *
+ *	@param	timing		: The timing.
+ *	@param	sliceCycles	: The per-slice cycles.
+ *	@param	numberOfSlices	: The number of slices.
+ */
+void	accumulatePhaseTimingSliceCycles(PhaseTiming *  timing, const PhaseTimingSliceCycles *  sliceCycles, size_t numberOfSlices);
+
+/**
+ *	@brief	Print the phase times in a human-readable form.
+ *
+ *	@param	timing	: The timing to print.
+ */
+void	printPhaseTiming(const PhaseTiming *  timing);
+
+/**
+ *	@brief	Print the phase times as a single-line JSON object.
+ *
+ *	@param	timing	: The timing to print.
+ */
+void	printPhaseTimingJSON(const PhaseTiming *  timing);
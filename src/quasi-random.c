@@ -0,0 +1,231 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include "quasi-random.h"
+#include "random.h"
+
+/*
+ *	2^-32, to map 32-bit integers to [0, 1).
+ */
+#define kQuasiRandomUnitScale	(0x1.0p-32)
+
+static inline uint32_t
+reverseBits(uint32_t x)
+{
+	x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+	x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+	x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+	x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+
+	return (x >> 16) | (x << 16);
+}
+
+/*
+ *	Nested uniform (Owen) scrambling of the binary digits of `x`, by the hash-based
+ *	construction of Burley, "Practical Hash-based Owen Scrambling", JCGT 2020: a
+ *	hash whose every output bit depends only on the same or lower input bits,
+ *	applied to the bit-reversed value, permutes each digit depending on the
+ *	digits before it.
+ */
+static inline uint32_t
+scrambleNestedUniform(uint32_t x, uint32_t seed)
+{
+	x = reverseBits(x);
+	x += seed;
+	x ^= x * 0x6c50b47cu;
+	x ^= x * 0xb82f1e52u;
+	x ^= x * 0xc7afe638u;
+	x ^= x * 0x8d22f6e6u;
+
+	return reverseBits(x);
+}
+
+/*
+ *	The coordinate of Sobol point `index` (in Gray code order) in one dimension.
+ */
+static inline uint32_t
+sobolPoint(const uint32_t *  directions, uint32_t index)
+{
+	uint32_t	gray = index ^ (index >> 1);
+	uint32_t	x = 0;
+
+	for (size_t k = 0; gray != 0; k++, gray >>= 1)
+	{
+		if (gray & 1)
+		{
+			x ^= directions[k];
+		}
+	}
+
+	return x;
+}
+
+/*
+ *	A pseudo-random permutation of [0, length), from Kensler, "Correlated
+ *	Multi-Jittered Sampling", Pixar Technical Memo 13-01, 2013. It hashes
+ *	within the next power of two and cycle-walks until the result is in range.
+ */
+static inline uint32_t
+permuteIndex(uint32_t i, uint32_t length, uint32_t seed)
+{
+	uint32_t	mask = length - 1;
+
+	mask |= mask >> 1;
+	mask |= mask >> 2;
+	mask |= mask >> 4;
+	mask |= mask >> 8;
+	mask |= mask >> 16;
+
+	do
+	{
+		i ^= seed;
+		i *= 0xe170893du;
+		i ^= seed >> 16;
+		i ^= (i & mask) >> 4;
+		i ^= seed >> 8;
+		i *= 0x0929eb3fu;
+		i ^= seed >> 23;
+		i ^= (i & mask) >> 1;
+		i *= 1 | seed >> 27;
+		i *= 0x6935fa69u;
+		i ^= (i & mask) >> 11;
+		i *= 0x74dcb303u;
+		i ^= (i & mask) >> 2;
+		i *= 0x9e501cc3u;
+		i ^= (i & mask) >> 2;
+		i *= 0xc860a3dfu;
+		i &= mask;
+		i ^= i >> 5;
+	} while (i >= length);
+
+	return (uint32_t)(((uint64_t)i + seed) % length);
+}
+
+/*
+ *	A hash of `i` to [0, 1), for the position of a point within its stratum.
+ */
+static inline double
+hashToUnit(uint32_t i, uint32_t seed)
+{
+	uint64_t	x = ((uint64_t)seed << 32) | i;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	return (double)(x >> 11) * 0x1.0p-53;
+}
+
+CommonConstantReturnType
+initializeQuasiRandomSequence(
+	QuasiRandomSequence *	sequence,
+	SamplingMethod		method,
+	uint64_t		numberOfPoints,
+	uint64_t		seed)
+{
+	RandomStream	stream;
+	uint64_t	bits;
+
+	if ((numberOfPoints == 0) || (numberOfPoints > kQuasiRandomSequenceMaxPoints))
+	{
+		fprintf(
+			stderr,
+			"Error: Quasi-Monte Carlo sampling supports between 1 and %" PRIu64 " points: Requested %" PRIu64 ".\n",
+			(uint64_t)kQuasiRandomSequenceMaxPoints,
+			numberOfPoints);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	seedRandomStream(&stream, seed, 0);
+	bits = randomStreamNextUint64(&stream);
+
+	sequence->method = method;
+	sequence->numberOfPoints = numberOfPoints;
+	sequence->scrambleSeeds[0] = (uint32_t)bits;
+	sequence->scrambleSeeds[1] = (uint32_t)(bits >> 32);
+
+	/*
+	 *	The first dimension is the van der Corput sequence; the second has the
+	 *	primitive polynomial x + 1, for which each direction number is the
+	 *	previous one XORed with itself shifted right by one.
+	 */
+	for (size_t k = 0; k < 32; k++)
+	{
+		sequence->directions[0][k] = UINT32_C(0x80000000) >> k;
+		sequence->directions[1][k] = (k == 0) ? UINT32_C(0x80000000) : (sequence->directions[1][k - 1] ^ (sequence->directions[1][k - 1] >> 1));
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+generateQuasiRandomBlock(
+	const QuasiRandomSequence *	sequence,
+	uint64_t			firstIndex,
+	size_t				count,
+	double *			dimension0,
+	double *			dimension1)
+{
+	if (sequence->method == kSamplingMethodSobol)
+	{
+		uint32_t	index = (uint32_t)firstIndex;
+		uint32_t	x0 = sobolPoint(sequence->directions[0], index);
+		uint32_t	x1 = sobolPoint(sequence->directions[1], index);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			dimension0[i] = (double)scrambleNestedUniform(x0, sequence->scrambleSeeds[0]) * kQuasiRandomUnitScale;
+			dimension1[i] = (double)scrambleNestedUniform(x1, sequence->scrambleSeeds[1]) * kQuasiRandomUnitScale;
+
+			/*
+			 *	The Gray codes of `index` and `index + 1` differ in the lowest set bit of `index + 1`.
+			 */
+			if (i + 1 < count)
+			{
+				index++;
+				x0 ^= sequence->directions[0][__builtin_ctz(index)];
+				x1 ^= sequence->directions[1][__builtin_ctz(index)];
+			}
+		}
+	}
+	else
+	{
+		uint32_t	length = (uint32_t)sequence->numberOfPoints;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t	index = (uint32_t)(firstIndex + i);
+			uint32_t	stratum0 = permuteIndex(index, length, sequence->scrambleSeeds[0]);
+			uint32_t	stratum1 = permuteIndex(index, length, sequence->scrambleSeeds[1]);
+
+			dimension0[i] = ((double)stratum0 + hashToUnit(index, sequence->scrambleSeeds[0])) / (double)sequence->numberOfPoints;
+			dimension1[i] = ((double)stratum1 + hashToUnit(index, sequence->scrambleSeeds[1])) / (double)sequence->numberOfPoints;
+		}
+	}
+
+	return;
+}
@@ -0,0 +1,100 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+
+/*
+ *	Sampling methods of the parallel Monte Carlo engine (`-m` option):
+ *		kSamplingMethodPseudoRandom	: Independent pseudo-random draws.
+ *		kSamplingMethodSobol		: The two-dimensional Sobol sequence, with nested uniform
+ *						  (Owen) scrambling of each dimension.
+ *		kSamplingMethodLatinHypercube	: Latin hypercube sampling: every one of N equal strata
+ *						  of each dimension holds exactly one of the N points.
+ */
+typedef enum
+{
+	kSamplingMethodPseudoRandom	= 0,
+	kSamplingMethodSobol		= 1,
+	kSamplingMethodLatinHypercube	= 2,
+} SamplingMethod;
+
+/*
+ *	Both point sets index points with 32 bits.
+ */
+#define kQuasiRandomSequenceMaxPoints	((uint64_t)UINT32_MAX)
+
+/*
+ *	A randomized two-dimensional low-discrepancy point set of `numberOfPoints`
+ *	points. The Sobol points are in Gray code order, so that consecutive points
+ *	differ in one direction number per dimension; point `i` only depends on `i`,
+ *	the seed and `numberOfPoints`, so any
+ *	range of points can be generated independently (e.g., by each worker thread)
+ *	and the points do not depend on how the range is split.
+ */
+typedef struct
+{
+	SamplingMethod	method;
+	uint64_t	numberOfPoints;
+	uint32_t	scrambleSeeds[2];
+
+	/*
+	 *	Sobol direction numbers of each dimension.
+	 */
+	uint32_t	directions[2][32];
+} QuasiRandomSequence;
+
+/**
+ *	@brief	Initialize a point set.
+ *
+ *	@param	sequence	: The point set to initialize.
+ *	@param	method		: `kSamplingMethodSobol` or `kSamplingMethodLatinHypercube`.
+ *	@param	numberOfPoints	: The number of points, at most `kQuasiRandomSequenceMaxPoints`.
+ *	@param	seed		: The seed of the randomization.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	initializeQuasiRandomSequence(
+					QuasiRandomSequence *	sequence,
+					SamplingMethod		method,
+					uint64_t		numberOfPoints,
+					uint64_t		seed);
+
+/**
+ *	@brief	Generate points `firstIndex` to `firstIndex + count - 1` of a point set,
+ *		as coordinates in [0, 1).
+ *
+ *	@param	sequence	: The point set.
+ *	@param	firstIndex	: The index of the first point.
+ *	@param	count		: The number of points.
+ *	@param	dimension0	: Where to write the first coordinate of each point.
+ *	@param	dimension1	: Where to write the second coordinate of each point.
+ */
+void	generateQuasiRandomBlock(
+		const QuasiRandomSequence *	sequence,
+		uint64_t			firstIndex,
+		size_t				count,
+		double *			dimension0,
+		double *			dimension1);
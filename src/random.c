@@ -0,0 +1,121 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include "random.h"
+
+static uint64_t
+splitMix64(uint64_t *  state)
+{
+	uint64_t	z = (*state += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+	return z ^ (z >> 31);
+}
+
+/*
+ *	Advance the stream by 2^128 draws, using the jump polynomial published with xoshiro256**.
+ */
+static void
+jumpRandomStream(RandomStream *  stream)
+{
+	static const uint64_t	kJump[] =
+				{
+					0x180ec6d33cfd0abaULL,
+					0xd5a61266f0c9392cULL,
+					0xa9582618e03fc9aaULL,
+					0x39abdc4529b1661cULL,
+				};
+	uint64_t		jumped[4] = {0};
+
+	for (size_t i = 0; i < sizeof(kJump) / sizeof(kJump[0]); i++)
+	{
+		for (int b = 0; b < 64; b++)
+		{
+			if (kJump[i] & (1ULL << b))
+			{
+				for (int j = 0; j < 4; j++)
+				{
+					jumped[j] ^= stream->state[j];
+				}
+			}
+			randomStreamNextUint64(stream);
+		}
+	}
+
+	for (int j = 0; j < 4; j++)
+	{
+		stream->state[j] = jumped[j];
+	}
+
+	return;
+}
+
+void
+seedRandomStream(RandomStream *  stream, uint64_t seed, size_t streamIndex)
+{
+	uint64_t	splitMixState = seed;
+
+	for (int j = 0; j < 4; j++)
+	{
+		stream->state[j] = splitMix64(&splitMixState);
+	}
+
+	for (size_t i = 0; i < streamIndex; i++)
+	{
+		jumpRandomStream(stream);
+	}
+
+	return;
+}
+
+void
+seedRandomLaneStream(RandomLaneStream *  stream, uint64_t seed, size_t streamIndex)
+{
+	RandomStream	laneStream;
+
+	seedRandomStream(&laneStream, seed, streamIndex * kRandomConstantLanes);
+
+	for (size_t j = 0; j < kRandomConstantLanes; j++)
+	{
+		for (int w = 0; w < 4; w++)
+		{
+			stream->state[w][j] = laneStream.state[w];
+		}
+		jumpRandomStream(&laneStream);
+	}
+
+	return;
+}
+
+void
+seedPhiloxKey(PhiloxKey *  key, uint64_t seed)
+{
+	uint64_t	splitMixState = seed;
+	uint64_t	bits = splitMix64(&splitMixState);
+
+	key->key[0] = (uint32_t)bits;
+	key->key[1] = (uint32_t)(bits >> 32);
+
+	return;
+}
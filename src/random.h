@@ -0,0 +1,195 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ *	State of one xoshiro256** pseudo-random number stream. Streams created
+ *	from the same seed with different stream indices are 2^128 draws apart,
+ *	so they never overlap in practice.
+ */
+typedef struct
+{
+	uint64_t	state[4];
+} RandomStream;
+
+typedef enum
+{
+	kRandomConstantLanes	= 8,
+} RandomConstant;
+
+/*
+ *	`kRandomConstantLanes` interleaved xoshiro256** streams, stored so that
+ *	`state[w]` holds state word `w` of every lane and can be loaded as one
+ *	vector. Lane `j` of lane stream `i` is random stream `i * kRandomConstantLanes + j`.
+ *	The batched kernels in `conversion-kernels.h` step all lanes together.
+ */
+typedef struct
+{
+	_Alignas(64) uint64_t	state[4][kRandomConstantLanes];
+} RandomLaneStream;
+
+/*
+ *	Generators of the input samples of the parallel Monte Carlo engine (`-r` option).
+ */
+typedef enum
+{
+	kRandomGeneratorXoshiro	= 0,
+	kRandomGeneratorPhilox	= 1,
+} RandomGenerator;
+
+/*
+ *	Key of the Philox4x32-10 counter-based generator (Salmon et al., "Parallel
+ *	random numbers: As easy as 1, 2, 3", SC 2011). Draw `n` of a key is a pure
+ *	function of the key and of `n`, so any position of the sequence can be
+ *	generated directly, and the draws of an iteration do not depend on which
+ *	thread evaluates it.
+ */
+typedef struct
+{
+	uint32_t	key[2];
+} PhiloxKey;
+
+typedef enum
+{
+	kPhiloxConstantRounds		= 10,
+} PhiloxConstant;
+
+/*
+ *	The round multipliers and key increments of Philox4x32. They do not fit in
+ *	an `int`, so they cannot be enumerators.
+ */
+#define kPhiloxConstantMultiplier0	(0xD2511F53U)
+#define kPhiloxConstantMultiplier1	(0xCD9E8D57U)
+#define kPhiloxConstantWeyl0		(0x9E3779B9U)
+#define kPhiloxConstantWeyl1		(0xBB67AE85U)
+
+/**
+ *	@brief	Seed a random stream.
+ *
+ *	@param	stream		: The stream to seed.
+ *	@param	seed		: The seed shared by all streams of a run.
+ *	@param	streamIndex	: The index of this stream (e.g., the worker thread index).
+ */
+void	seedRandomStream(RandomStream *  stream, uint64_t seed, size_t streamIndex);
+
+/**
+ *	@brief	Seed a lane stream.
+ *
+ *	@param	stream		: The lane stream to seed.
+ *	@param	seed		: The seed shared by all streams of a run.
+ *	@param	streamIndex	: The index of this lane stream (e.g., the worker thread index).
+ */
+void	seedRandomLaneStream(RandomLaneStream *  stream, uint64_t seed, size_t streamIndex);
+
+/**
+ *	@brief	Derive a Philox key from a seed.
+ *
+ *	@param	key		: The key to set.
+ *	@param	seed		: The seed of the run.
+ */
+void	seedPhiloxKey(PhiloxKey *  key, uint64_t seed);
+
+/**
+ *	@brief	Evaluate Philox4x32-10: 128 random bits for the 128-bit `counter` under `key`.
+ *
+ *	@param	key		: The key.
+ *	@param	counter		: The counter, least significant word first.
+ *	@param	output		: Where to write the four random words.
+ */
+static inline void
+philox4x32(const PhiloxKey *  key, const uint32_t counter[4], uint32_t output[4])
+{
+	uint32_t	k0 = key->key[0];
+	uint32_t	k1 = key->key[1];
+	uint32_t	c0 = counter[0];
+	uint32_t	c1 = counter[1];
+	uint32_t	c2 = counter[2];
+	uint32_t	c3 = counter[3];
+
+	for (int round = 0; round < kPhiloxConstantRounds; round++)
+	{
+		uint64_t	product0 = (uint64_t)kPhiloxConstantMultiplier0 * c0;
+		uint64_t	product1 = (uint64_t)kPhiloxConstantMultiplier1 * c2;
+
+		c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+		c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+		c1 = (uint32_t)product1;
+		c3 = (uint32_t)product0;
+
+		k0 += kPhiloxConstantWeyl0;
+		k1 += kPhiloxConstantWeyl1;
+	}
+
+	output[0] = c0;
+	output[1] = c1;
+	output[2] = c2;
+	output[3] = c3;
+
+	return;
+}
+
+/**
+ *	@brief	Draw the next 64 random bits from a stream.
+ *
+ *	@param	stream		: The random stream.
+ *	@return			: 64 uniformly-distributed random bits.
+ */
+static inline uint64_t
+randomStreamNextUint64(RandomStream *  stream)
+{
+	uint64_t *	s = stream->state;
+	uint64_t	x = s[1] * 5;
+	uint64_t	result = ((x << 7) | (x >> 57)) * 9;
+	uint64_t	t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+
+	return result;
+}
+
+/**
+ *	@brief	Draw a sample from the uniform distribution over [low, high).
+ *
+ *	@param	stream		: The random stream.
+ *	@param	low		: Lower bound of the distribution.
+ *	@param	high		: Upper bound of the distribution.
+ *	@return			: The sample.
+ */
+static inline double
+randomStreamUniformDouble(RandomStream *  stream, double low, double high)
+{
+	/*
+	 *	The top 53 bits give a double in [0, 1) with every value equally likely.
+	 */
+	double	unit = (double)(randomStreamNextUint64(stream) >> 11) * 0x1.0p-53;
+
+	return low + (high - low) * unit;
+}
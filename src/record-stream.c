@@ -0,0 +1,612 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ENABLE_NATIVE_POSIX)
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "record-stream.h"
+
+static const char	kRecordStreamBinaryMagic[8] = {'T', 'M', 'C', 'S', 'R', 'E', 'C', '\0'};
+
+struct RecordStream
+{
+	RecordStreamFormat	format;
+	FILE *			file;
+	size_t			lineNumber;
+	bool			isHeaderCandidate;
+	bool			hasFailed;
+	bool			isAtEnd;
+	SensorReadingRecord *	blocks[2];
+	size_t			blockCounts[2];
+	size_t			currentBlock;
+	bool			hasHandedOutBlock;
+	unsigned char *		binaryReadBuffer;
+#if defined(ENABLE_NATIVE_POSIX)
+	/*
+	 *	Binary files are memory-mapped and decoded straight from the mapping.
+	 */
+	const unsigned char *	mappedData;
+	size_t			mappedSize;
+	size_t			mappedOffset;
+
+	/*
+	 *	Double-buffering state, shared between the reader thread and the caller.
+	 */
+	pthread_t		readerThread;
+	pthread_mutex_t		mutex;
+	pthread_cond_t		condition;
+	bool			isBlockFull[2];
+	bool			isStopping;
+	bool			isReaderThreadRunning;
+#endif
+};
+
+static RecordStreamFormat
+detectRecordStreamFormat(const char *  path)
+{
+	size_t	length = strlen(path);
+
+	if ((length >= 4) && (strcmp(&path[length - 4], ".bin") == 0))
+	{
+		return kRecordStreamFormatBinary;
+	}
+
+	return kRecordStreamFormatCSV;
+}
+
+static uint64_t
+decodeLittleEndianUint64(const unsigned char *  bytes)
+{
+	uint64_t	value = 0;
+
+	for (int i = 7; i >= 0; i--)
+	{
+		value = (value << 8) | bytes[i];
+	}
+
+	return value;
+}
+
+static double
+decodeLittleEndianDouble(const unsigned char *  bytes)
+{
+	uint64_t	bits = decodeLittleEndianUint64(bytes);
+	double		value;
+
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+static uint32_t
+decodeLittleEndianUint32(const unsigned char *  bytes)
+{
+	return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static bool
+isValidRecord(const SensorReadingRecord *  record)
+{
+	return (record->voutLow <= record->voutHigh) && (record->vrefLow <= record->vrefHigh);
+}
+
+/*
+ *	Parses one CSV line into `record`. Returns 1 for a record, 0 for a line that
+ *	should be skipped, and -1 for a malformed line.
+ */
+static int
+parseCSVRecordLine(RecordStream *  stream, char *  line, SensorReadingRecord *  record)
+{
+	double		fields[kRecordStreamConstantBinaryFieldsPerRecord];
+	char *		cursor = line;
+	char *		end;
+	bool		isHeaderCandidate = stream->isHeaderCandidate;
+
+	stream->isHeaderCandidate = false;
+
+	while ((*cursor == ' ') || (*cursor == '\t'))
+	{
+		cursor++;
+	}
+
+	if ((*cursor == '\0') || (*cursor == '\n') || (*cursor == '\r') || (*cursor == '#'))
+	{
+		stream->isHeaderCandidate = isHeaderCandidate;
+
+		return 0;
+	}
+
+	for (int i = 0; i < kRecordStreamConstantBinaryFieldsPerRecord; i++)
+	{
+		errno = 0;
+		fields[i] = strtod(cursor, &end);
+		if ((end == cursor) || (errno == ERANGE))
+		{
+			/*
+			 *	A non-numeric first line is taken to be a column header.
+			 */
+			return ((i == 0) && isHeaderCandidate) ? 0 : -1;
+		}
+
+		cursor = end;
+		while ((*cursor == ' ') || (*cursor == '\t'))
+		{
+			cursor++;
+		}
+
+		if (i < kRecordStreamConstantBinaryFieldsPerRecord - 1)
+		{
+			if (*cursor != ',')
+			{
+				return -1;
+			}
+			cursor++;
+		}
+	}
+
+	if ((*cursor != '\0') && (*cursor != '\n') && (*cursor != '\r'))
+	{
+		return -1;
+	}
+
+	*record = (SensorReadingRecord)
+	{
+		.voutLow	= fields[0],
+		.voutHigh	= fields[1],
+		.vrefLow	= fields[2],
+		.vrefHigh	= fields[3],
+	};
+
+	return 1;
+}
+
+static size_t
+fillCSVBlock(RecordStream *  stream, SensorReadingRecord *  block)
+{
+	char	line[kCommonConstantMaxCharsPerLine];
+	size_t	count = 0;
+
+	while ((count < kRecordStreamConstantBlockSize) && (fgets(line, sizeof(line), stream->file) != NULL))
+	{
+		int	result;
+
+		stream->lineNumber++;
+		result = parseCSVRecordLine(stream, line, &block[count]);
+		if (result == 0)
+		{
+			continue;
+		}
+
+		if ((result < 0) || !isValidRecord(&block[count]))
+		{
+			fprintf(stderr, "Error: Malformed record on line %zu of input file.\n", stream->lineNumber);
+			stream->hasFailed = true;
+
+			return 0;
+		}
+
+		count++;
+	}
+
+	if (ferror(stream->file))
+	{
+		fprintf(stderr, "Error: Could not read input file.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	return count;
+}
+
+static size_t
+decodeBinaryRecords(RecordStream *  stream, const unsigned char *  bytes, size_t count, SensorReadingRecord *  block)
+{
+	const size_t	recordSize = kRecordStreamConstantBinaryFieldsPerRecord * sizeof(double);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const unsigned char *	recordBytes = &bytes[i * recordSize];
+
+		block[i] = (SensorReadingRecord)
+		{
+			.voutLow	= decodeLittleEndianDouble(&recordBytes[0 * sizeof(double)]),
+			.voutHigh	= decodeLittleEndianDouble(&recordBytes[1 * sizeof(double)]),
+			.vrefLow	= decodeLittleEndianDouble(&recordBytes[2 * sizeof(double)]),
+			.vrefHigh	= decodeLittleEndianDouble(&recordBytes[3 * sizeof(double)]),
+		};
+
+		if (!isValidRecord(&block[i]))
+		{
+			fprintf(stderr, "Error: Malformed record %zu in binary input file.\n", stream->lineNumber + i);
+			stream->hasFailed = true;
+
+			return 0;
+		}
+	}
+	stream->lineNumber += count;
+
+	return count;
+}
+
+static size_t
+fillBinaryBlock(RecordStream *  stream, SensorReadingRecord *  block)
+{
+	const size_t	recordSize = kRecordStreamConstantBinaryFieldsPerRecord * sizeof(double);
+	size_t		count;
+
+#if defined(ENABLE_NATIVE_POSIX)
+	if (stream->mappedData != NULL)
+	{
+		size_t	remainingBytes = stream->mappedSize - stream->mappedOffset;
+		size_t	pageSize = (size_t)sysconf(_SC_PAGESIZE);
+		size_t	consumedPages;
+
+		count = remainingBytes / recordSize;
+		count = (count < kRecordStreamConstantBlockSize) ? count : kRecordStreamConstantBlockSize;
+		if ((count == 0) && (remainingBytes != 0))
+		{
+			fprintf(stderr, "Error: Binary input file ends with a truncated record.\n");
+			stream->hasFailed = true;
+
+			return 0;
+		}
+
+		count = decodeBinaryRecords(stream, &stream->mappedData[stream->mappedOffset], count, block);
+		stream->mappedOffset += count * recordSize;
+
+		/*
+		 *	Drop the pages we have finished decoding so that the resident set
+		 *	stays bounded, and ask for read-ahead on the next block.
+		 */
+		consumedPages = (stream->mappedOffset / pageSize) * pageSize;
+		if (consumedPages > 0)
+		{
+			madvise((void *)stream->mappedData, consumedPages, MADV_DONTNEED);
+		}
+		if (stream->mappedOffset < stream->mappedSize)
+		{
+			size_t	nextOffset = (stream->mappedOffset / pageSize) * pageSize;
+			size_t	nextLength = kRecordStreamConstantBlockSize * recordSize + pageSize;
+
+			nextLength = (nextOffset + nextLength > stream->mappedSize) ? (stream->mappedSize - nextOffset) : nextLength;
+			madvise((void *)&stream->mappedData[nextOffset], nextLength, MADV_WILLNEED);
+		}
+
+		return count;
+	}
+#endif
+
+	count = fread(stream->binaryReadBuffer, 1, kRecordStreamConstantBlockSize * recordSize, stream->file);
+	if (ferror(stream->file))
+	{
+		fprintf(stderr, "Error: Could not read input file.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	if ((count % recordSize) != 0)
+	{
+		fprintf(stderr, "Error: Binary input file ends with a truncated record.\n");
+		stream->hasFailed = true;
+
+		return 0;
+	}
+
+	return decodeBinaryRecords(stream, stream->binaryReadBuffer, count / recordSize, block);
+}
+
+static size_t
+fillRecordBlock(RecordStream *  stream, SensorReadingRecord *  block)
+{
+	if (stream->hasFailed)
+	{
+		return 0;
+	}
+
+	return (stream->format == kRecordStreamFormatBinary) ? fillBinaryBlock(stream, block) : fillCSVBlock(stream, block);
+}
+
+static CommonConstantReturnType
+readBinaryHeader(RecordStream *  stream)
+{
+	unsigned char		headerBuffer[kRecordStreamConstantBinaryHeaderSize];
+	const unsigned char *	header = headerBuffer;
+
+#if defined(ENABLE_NATIVE_POSIX)
+	if (stream->mappedData != NULL)
+	{
+		if (stream->mappedSize < kRecordStreamConstantBinaryHeaderSize)
+		{
+			fprintf(stderr, "Error: Binary input file is too short to contain a header.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+		header = stream->mappedData;
+		stream->mappedOffset = kRecordStreamConstantBinaryHeaderSize;
+	}
+	else
+#endif
+	if (fread(headerBuffer, 1, sizeof(headerBuffer), stream->file) != sizeof(headerBuffer))
+	{
+		fprintf(stderr, "Error: Binary input file is too short to contain a header.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (memcmp(header, kRecordStreamBinaryMagic, sizeof(kRecordStreamBinaryMagic)) != 0)
+	{
+		fprintf(stderr, "Error: Binary input file does not start with the expected magic.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((decodeLittleEndianUint32(&header[8]) != kRecordStreamConstantBinaryVersion) ||
+		(decodeLittleEndianUint32(&header[12]) != kRecordStreamConstantBinaryFieldsPerRecord))
+	{
+		fprintf(stderr, "Error: Unsupported binary input file version or field count.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+#if defined(ENABLE_NATIVE_POSIX)
+static void
+mapBinaryRecordFile(RecordStream *  stream)
+{
+	struct stat	fileStatus;
+	void *		mapping;
+
+	if ((fstat(fileno(stream->file), &fileStatus) != 0) || (fileStatus.st_size <= 0))
+	{
+		return;
+	}
+
+	mapping = mmap(NULL, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileno(stream->file), 0);
+	if (mapping == MAP_FAILED)
+	{
+		/*
+		 *	Not every file can be mapped (e.g., pipes). Fall back to `fread()`.
+		 */
+		return;
+	}
+
+	madvise(mapping, (size_t)fileStatus.st_size, MADV_SEQUENTIAL);
+	stream->mappedData = mapping;
+	stream->mappedSize = (size_t)fileStatus.st_size;
+
+	return;
+}
+
+static void *
+recordStreamReaderThread(void *  argument)
+{
+	RecordStream *	stream = argument;
+	size_t		slot = 0;
+
+	for (;;)
+	{
+		size_t	count;
+
+		pthread_mutex_lock(&stream->mutex);
+		while (stream->isBlockFull[slot] && !stream->isStopping)
+		{
+			pthread_cond_wait(&stream->condition, &stream->mutex);
+		}
+		if (stream->isStopping)
+		{
+			pthread_mutex_unlock(&stream->mutex);
+			break;
+		}
+		pthread_mutex_unlock(&stream->mutex);
+
+		count = fillRecordBlock(stream, stream->blocks[slot]);
+
+		pthread_mutex_lock(&stream->mutex);
+		stream->blockCounts[slot] = count;
+		stream->isBlockFull[slot] = true;
+		pthread_cond_broadcast(&stream->condition);
+		pthread_mutex_unlock(&stream->mutex);
+
+		if (count == 0)
+		{
+			break;
+		}
+		slot ^= 1;
+	}
+
+	return NULL;
+}
+#endif
+
+CommonConstantReturnType
+openRecordStream(const char *  path, RecordStreamFormat format, RecordStream **  stream)
+{
+	RecordStream *	newStream;
+
+	newStream = calloc(1, sizeof(RecordStream));
+	if (newStream == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate record stream.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newStream->format = (format == kRecordStreamFormatAutomatic) ? detectRecordStreamFormat(path) : format;
+	newStream->isHeaderCandidate = true;
+	newStream->file = fopen(path, (newStream->format == kRecordStreamFormatBinary) ? "rb" : "r");
+	if (newStream->file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open input file \"%s\".\n", path);
+		free(newStream);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		newStream->blocks[i] = malloc(kRecordStreamConstantBlockSize * sizeof(SensorReadingRecord));
+	}
+	newStream->binaryReadBuffer = malloc(kRecordStreamConstantBlockSize * kRecordStreamConstantBinaryFieldsPerRecord * sizeof(double));
+	if ((newStream->blocks[0] == NULL) || (newStream->blocks[1] == NULL) || (newStream->binaryReadBuffer == NULL))
+	{
+		fprintf(stderr, "Error: Could not allocate record stream buffers.\n");
+		closeRecordStream(newStream);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (newStream->format == kRecordStreamFormatBinary)
+	{
+#if defined(ENABLE_NATIVE_POSIX)
+		mapBinaryRecordFile(newStream);
+#endif
+		if (readBinaryHeader(newStream) != kCommonConstantReturnTypeSuccess)
+		{
+			closeRecordStream(newStream);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_mutex_init(&newStream->mutex, NULL);
+	pthread_cond_init(&newStream->condition, NULL);
+	if (pthread_create(&newStream->readerThread, NULL, recordStreamReaderThread, newStream) != 0)
+	{
+		fprintf(stderr, "Error: Could not start record stream reader thread.\n");
+		closeRecordStream(newStream);
+
+		return kCommonConstantReturnTypeError;
+	}
+	newStream->isReaderThreadRunning = true;
+#endif
+
+	*stream = newStream;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+size_t
+readRecordStreamBlock(RecordStream *  stream, const SensorReadingRecord **  records)
+{
+	size_t	count;
+
+	if (stream->isAtEnd)
+	{
+		return 0;
+	}
+
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_mutex_lock(&stream->mutex);
+	if (stream->hasHandedOutBlock)
+	{
+		/*
+		 *	Hand the block the caller has just finished with back to the reader.
+		 */
+		stream->isBlockFull[stream->currentBlock] = false;
+		stream->currentBlock ^= 1;
+		pthread_cond_broadcast(&stream->condition);
+	}
+	while (!stream->isBlockFull[stream->currentBlock])
+	{
+		pthread_cond_wait(&stream->condition, &stream->mutex);
+	}
+	count = stream->blockCounts[stream->currentBlock];
+	pthread_mutex_unlock(&stream->mutex);
+#else
+	count = fillRecordBlock(stream, stream->blocks[stream->currentBlock]);
+#endif
+
+	stream->hasHandedOutBlock = true;
+	stream->isAtEnd = (count == 0);
+	*records = stream->blocks[stream->currentBlock];
+
+	return count;
+}
+
+bool
+hasRecordStreamFailed(RecordStream *  stream)
+{
+	bool	hasFailed;
+
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_mutex_lock(&stream->mutex);
+	hasFailed = stream->hasFailed;
+	pthread_mutex_unlock(&stream->mutex);
+#else
+	hasFailed = stream->hasFailed;
+#endif
+
+	return hasFailed;
+}
+
+void
+closeRecordStream(RecordStream *  stream)
+{
+	if (stream == NULL)
+	{
+		return;
+	}
+
+#if defined(ENABLE_NATIVE_POSIX)
+	if (stream->isReaderThreadRunning)
+	{
+		pthread_mutex_lock(&stream->mutex);
+		stream->isStopping = true;
+		pthread_cond_broadcast(&stream->condition);
+		pthread_mutex_unlock(&stream->mutex);
+		pthread_join(stream->readerThread, NULL);
+		pthread_cond_destroy(&stream->condition);
+		pthread_mutex_destroy(&stream->mutex);
+	}
+
+	if (stream->mappedData != NULL)
+	{
+		munmap((void *)stream->mappedData, stream->mappedSize);
+	}
+#endif
+
+	if (stream->file != NULL)
+	{
+		fclose(stream->file);
+	}
+
+	free(stream->blocks[0]);
+	free(stream->blocks[1]);
+	free(stream->binaryReadBuffer);
+	free(stream);
+
+	return;
+}
@@ -0,0 +1,111 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "common.h"
+
+/*
+ *	Records are handed to the caller in blocks of `kRecordStreamConstantBlockSize`
+ *	records. With `ENABLE_NATIVE_POSIX`, two such blocks are in flight: a reader
+ *	thread fills one while the caller converts the other, so memory use stays
+ *	bounded regardless of the size of the input file.
+ */
+typedef enum
+{
+	kRecordStreamConstantBlockSize			= 8192,
+	kRecordStreamConstantBinaryHeaderSize		= 16,
+	kRecordStreamConstantBinaryFieldsPerRecord	= 4,
+	kRecordStreamConstantBinaryVersion		= 1,
+	kRecordStreamConstantOutputBufferSize		= 1 << 20,
+} RecordStreamConstant;
+
+/*
+ *	Record file formats:
+ *		kRecordStreamFormatCSV		: One record per line, `VoutLow,VoutHigh,VrefLow,VrefHigh`.
+ *						  Blank lines, lines starting with `#` and a leading
+ *						  non-numeric header line are skipped.
+ *		kRecordStreamFormatBinary	: The 8-byte magic `TMCSREC\0`, a little-endian uint32
+ *						  version and a little-endian uint32 field count, followed
+ *						  by packed little-endian IEEE-754 doubles in the same field
+ *						  order as the CSV format.
+ */
+typedef enum
+{
+	kRecordStreamFormatAutomatic	= 0,
+	kRecordStreamFormatCSV		= 1,
+	kRecordStreamFormatBinary	= 2,
+} RecordStreamFormat;
+
+/*
+ *	A single recorded reading. Each record carries its own uncertainty, modelled
+ *	as uniform distributions over [VoutLow, VoutHigh] and [VrefLow, VrefHigh] (in Volt).
+ */
+typedef struct
+{
+	double	voutLow;
+	double	voutHigh;
+	double	vrefLow;
+	double	vrefHigh;
+} SensorReadingRecord;
+
+typedef struct RecordStream	RecordStream;
+
+/**
+ *	@brief	Open a file of recorded readings for block-wise streaming.
+ *
+ *	@param	path		: Path to the record file.
+ *	@param	format		: Format of the file. `kRecordStreamFormatAutomatic` selects
+ *				  the binary format for files ending in `.bin` and CSV otherwise.
+ *	@param	stream		: Set to the opened stream on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	openRecordStream(const char *  path, RecordStreamFormat format, RecordStream **  stream);
+
+/**
+ *	@brief	Get the next block of records. The returned block stays valid until the
+ *		next call to `readRecordStreamBlock()` or `closeRecordStream()`.
+ *
+ *	@param	stream		: The record stream.
+ *	@param	records		: Set to point to the first record of the block.
+ *	@return			: The number of records in the block. Zero at the end of the
+ *				  stream or on error (see `hasRecordStreamFailed()`).
+ */
+size_t	readRecordStreamBlock(RecordStream *  stream, const SensorReadingRecord **  records);
+
+/**
+ *	@brief	Check whether the stream stopped because of a read or parse error.
+ *
+ *	@param	stream		: The record stream.
+ *	@return			: `true` if the stream encountered an error.
+ */
+bool	hasRecordStreamFailed(RecordStream *  stream);
+
+/**
+ *	@brief	Close the stream, stopping the reader thread and releasing its buffers.
+ *
+ *	@param	stream		: The record stream. May be `NULL`.
+ */
+void	closeRecordStream(RecordStream *  stream);
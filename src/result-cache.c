@@ -0,0 +1,459 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "result-cache.h"
+
+/*
+ *	The cache file is a header followed by the entries, each a `ResultCacheKey`
+ *	and a `ResultCacheValue`, in the native layout: a cache file is tied to the
+ *	build and host that wrote it. The header records the byte order and the
+ *	entry size, so that a file from another build is rejected rather than misread.
+ */
+static const char	kResultCacheFileMagic[8] = {'T', 'M', 'C', 'S', 'C', 'C', 'H', '\0'};
+
+#define kResultCacheFileByteOrderMark		(0x01020304U)
+#define kResultCacheNoEntry			(UINT32_MAX)
+
+typedef struct
+{
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	byteOrderMark;
+	uint64_t	entrySize;
+	uint64_t	numberOfEntries;
+} ResultCacheFileHeader;
+
+typedef struct
+{
+	ResultCacheKey		key;
+	ResultCacheValue	value;
+
+	/*
+	 *	Links of the recency list (`previous` is more recent) and of the hash
+	 *	bucket chain, as indices into `entries`.
+	 */
+	uint32_t		previous;
+	uint32_t		next;
+	uint32_t		nextInBucket;
+} ResultCacheEntry;
+
+struct ResultCache
+{
+	size_t			capacity;
+	size_t			numberOfEntries;
+	size_t			numberOfBuckets;
+	uint32_t *		buckets;
+	ResultCacheEntry *	entries;
+	uint32_t		mostRecent;
+	uint32_t		leastRecent;
+	ResultCacheStatistics	statistics;
+};
+
+/*
+ *	Rounds `value` to a multiple of `quantum`. `llround()` has no defined result
+ *	for NaN, infinities or values outside of the range of `int64_t`, which would
+ *	otherwise all share a key, so those are rejected.
+ */
+static bool
+quantize(double value, double quantum, int64_t *  quantized)
+{
+	double	scaled = value / quantum;
+
+	if (!isfinite(scaled) || (fabs(scaled) >= 0x1p63))
+	{
+		return false;
+	}
+	*quantized = (int64_t)llround(scaled);
+
+	return true;
+}
+
+CommonConstantReturnType
+makeResultCacheKey(
+	ResultCacheKey *	key,
+	ResultCacheKind		kind,
+	double			voutLow,
+	double			voutHigh,
+	double			vrefLow,
+	double			vrefHigh,
+	double			sensitivity,
+	uint64_t		numberOfSamples,
+	uint64_t		seed,
+	SamplingMethod		samplingMethod,
+	RandomGenerator		randomGenerator,
+	size_t			numberOfThreads,
+	const double *		thresholds,
+	size_t			numberOfThresholds)
+{
+	/*
+	 *	Cleared as a whole, so that keys can be hashed and compared bytewise.
+	 */
+	memset(key, 0, sizeof(*key));
+
+	key->kind = kind;
+	if (!quantize(voutLow, kResultCacheVoltageQuantum, &key->voutLow) ||
+		!quantize(voutHigh, kResultCacheVoltageQuantum, &key->voutHigh) ||
+		!quantize(vrefLow, kResultCacheVoltageQuantum, &key->vrefLow) ||
+		!quantize(vrefHigh, kResultCacheVoltageQuantum, &key->vrefHigh) ||
+		!quantize(sensitivity, kResultCacheSensitivityQuantum, &key->sensitivity))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+	key->numberOfSamples = numberOfSamples;
+	if (numberOfThreads > 0)
+	{
+		key->seed = seed;
+		key->samplingMethod = samplingMethod;
+		key->randomGenerator = randomGenerator;
+
+		/*
+		 *	Philox and the quasi-random point sets draw the samples of an iteration
+		 *	from its index, so the samples, and their summary, do not depend on the
+		 *	number of threads, and runs with any number of threads share entries.
+		 */
+		key->numberOfThreads = ((samplingMethod == kSamplingMethodPseudoRandom) && (randomGenerator != kRandomGeneratorPhilox)) ? numberOfThreads : 0;
+	}
+	key->numberOfThresholds = numberOfThresholds;
+	for (size_t i = 0; i < numberOfThresholds; i++)
+	{
+		if (!quantize(thresholds[i], kResultCacheCurrentQuantum, &key->thresholds[i]))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+static size_t
+hashResultCacheKey(const ResultCache *  cache, const ResultCacheKey *  key)
+{
+	const unsigned char *	bytes = (const unsigned char *)key;
+	uint64_t		hash = 0xcbf29ce484222325ULL;
+
+	for (size_t i = 0; i < sizeof(*key); i++)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	}
+
+	return (size_t)(hash ^ (hash >> 32)) & (cache->numberOfBuckets - 1);
+}
+
+static uint32_t
+findResultCacheEntry(const ResultCache *  cache, const ResultCacheKey *  key)
+{
+	uint32_t	index = cache->buckets[hashResultCacheKey(cache, key)];
+
+	while ((index != kResultCacheNoEntry) && (memcmp(&cache->entries[index].key, key, sizeof(*key)) != 0))
+	{
+		index = cache->entries[index].nextInBucket;
+	}
+
+	return index;
+}
+
+static void
+unlinkRecency(ResultCache *  cache, uint32_t index)
+{
+	ResultCacheEntry *	entry = &cache->entries[index];
+
+	if (entry->previous != kResultCacheNoEntry)
+	{
+		cache->entries[entry->previous].next = entry->next;
+	}
+	else
+	{
+		cache->mostRecent = entry->next;
+	}
+
+	if (entry->next != kResultCacheNoEntry)
+	{
+		cache->entries[entry->next].previous = entry->previous;
+	}
+	else
+	{
+		cache->leastRecent = entry->previous;
+	}
+
+	return;
+}
+
+static void
+linkMostRecent(ResultCache *  cache, uint32_t index)
+{
+	ResultCacheEntry *	entry = &cache->entries[index];
+
+	entry->previous = kResultCacheNoEntry;
+	entry->next = cache->mostRecent;
+	if (cache->mostRecent != kResultCacheNoEntry)
+	{
+		cache->entries[cache->mostRecent].previous = index;
+	}
+	else
+	{
+		cache->leastRecent = index;
+	}
+	cache->mostRecent = index;
+
+	return;
+}
+
+static void
+unlinkBucket(ResultCache *  cache, uint32_t index)
+{
+	uint32_t *	link = &cache->buckets[hashResultCacheKey(cache, &cache->entries[index].key)];
+
+	while (*link != index)
+	{
+		link = &cache->entries[*link].nextInBucket;
+	}
+	*link = cache->entries[index].nextInBucket;
+
+	return;
+}
+
+CommonConstantReturnType
+createResultCache(size_t capacity, ResultCache **  cache)
+{
+	ResultCache *	newCache;
+
+	if ((capacity == 0) || (capacity > kResultCacheConstantMaxEntries))
+	{
+		fprintf(stderr, "Error: The result cache should hold between 1 and %d entries.\n", kResultCacheConstantMaxEntries);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newCache = checkedMalloc(sizeof(ResultCache), __FILE__, __LINE__);
+	newCache->capacity = capacity;
+	newCache->numberOfEntries = 0;
+
+	/*
+	 *	At least twice as many buckets as entries, and a power of two, so that
+	 *	chains stay short and a bucket is found with a mask.
+	 */
+	newCache->numberOfBuckets = 1;
+	while (newCache->numberOfBuckets < 2 * capacity)
+	{
+		newCache->numberOfBuckets *= 2;
+	}
+	newCache->buckets = checkedMalloc(newCache->numberOfBuckets * sizeof(uint32_t), __FILE__, __LINE__);
+	memset(newCache->buckets, 0xFF, newCache->numberOfBuckets * sizeof(uint32_t));
+	newCache->entries = checkedMalloc(capacity * sizeof(ResultCacheEntry), __FILE__, __LINE__);
+	newCache->mostRecent = kResultCacheNoEntry;
+	newCache->leastRecent = kResultCacheNoEntry;
+	newCache->statistics = (ResultCacheStatistics) {0};
+
+	*cache = newCache;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+bool
+lookupResultCache(ResultCache *  cache, const ResultCacheKey *  key, ResultCacheValue *  value)
+{
+	uint32_t	index = findResultCacheEntry(cache, key);
+
+	if (index == kResultCacheNoEntry)
+	{
+		cache->statistics.misses++;
+
+		return false;
+	}
+
+	cache->statistics.hits++;
+	if (index != cache->mostRecent)
+	{
+		unlinkRecency(cache, index);
+		linkMostRecent(cache, index);
+	}
+	*value = cache->entries[index].value;
+
+	return true;
+}
+
+void
+insertResultCache(ResultCache *  cache, const ResultCacheKey *  key, const ResultCacheValue *  value)
+{
+	uint32_t	index = findResultCacheEntry(cache, key);
+	size_t		bucket;
+
+	if (index != kResultCacheNoEntry)
+	{
+		unlinkRecency(cache, index);
+	}
+	else
+	{
+		if (cache->numberOfEntries < cache->capacity)
+		{
+			index = (uint32_t)cache->numberOfEntries++;
+		}
+		else
+		{
+			index = cache->leastRecent;
+			unlinkRecency(cache, index);
+			unlinkBucket(cache, index);
+			cache->statistics.evictions++;
+		}
+
+		cache->entries[index].key = *key;
+		bucket = hashResultCacheKey(cache, key);
+		cache->entries[index].nextInBucket = cache->buckets[bucket];
+		cache->buckets[bucket] = index;
+	}
+
+	cache->entries[index].value = *value;
+	linkMostRecent(cache, index);
+
+	return;
+}
+
+ResultCacheStatistics
+getResultCacheStatistics(const ResultCache *  cache)
+{
+	return cache->statistics;
+}
+
+CommonConstantReturnType
+loadResultCache(ResultCache *  cache, const char *  path)
+{
+	FILE *			file = fopen(path, "rb");
+	ResultCacheFileHeader	header;
+	ResultCacheEntry	entry;
+	uint64_t		numberOfSkippedEntries;
+
+	if (file == NULL)
+	{
+		if (errno == ENOENT)
+		{
+			return kCommonConstantReturnTypeSuccess;
+		}
+		fprintf(stderr, "Error: Could not open cache file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if ((fread(&header, sizeof(header), 1, file) != 1) ||
+		(memcmp(header.magic, kResultCacheFileMagic, sizeof(kResultCacheFileMagic)) != 0) ||
+		(header.version != kResultCacheConstantFileVersion) ||
+		(header.byteOrderMark != kResultCacheFileByteOrderMark) ||
+		(header.entrySize != sizeof(ResultCacheKey) + sizeof(ResultCacheValue)))
+	{
+		fprintf(stderr, "Error: \"%s\" is not a result cache file of this build.\n", path);
+		fclose(file);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	/*
+	 *	The entries are stored least recently used first, so inserting them in
+	 *	order restores their recency. Those that would be evicted are skipped.
+	 */
+	numberOfSkippedEntries = (header.numberOfEntries > cache->capacity) ? header.numberOfEntries - cache->capacity : 0;
+	for (uint64_t i = 0; i < header.numberOfEntries; i++)
+	{
+		if ((fread(&entry.key, sizeof(entry.key), 1, file) != 1) ||
+			(fread(&entry.value, sizeof(entry.value), 1, file) != 1))
+		{
+			fprintf(stderr, "Error: Cache file \"%s\" is truncated.\n", path);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (i >= numberOfSkippedEntries)
+		{
+			insertResultCache(cache, &entry.key, &entry.value);
+		}
+	}
+	fclose(file);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+saveResultCache(const ResultCache *  cache, const char *  path)
+{
+	ResultCacheFileHeader	header =
+				{
+					.version = kResultCacheConstantFileVersion,
+					.byteOrderMark = kResultCacheFileByteOrderMark,
+					.entrySize = sizeof(ResultCacheKey) + sizeof(ResultCacheValue),
+					.numberOfEntries = cache->numberOfEntries,
+				};
+	size_t			temporaryPathSize = strlen(path) + sizeof(".tmp");
+	char *			temporaryPath = checkedMalloc(temporaryPathSize, __FILE__, __LINE__);
+	FILE *			file;
+	bool			isWritten;
+
+	memcpy(header.magic, kResultCacheFileMagic, sizeof(kResultCacheFileMagic));
+	snprintf(temporaryPath, temporaryPathSize, "%s.tmp", path);
+
+	file = fopen(temporaryPath, "wb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open \"%s\" for writing.\n", temporaryPath);
+		free(temporaryPath);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	isWritten = (fwrite(&header, sizeof(header), 1, file) == 1);
+	for (uint32_t index = cache->leastRecent; isWritten && (index != kResultCacheNoEntry); index = cache->entries[index].previous)
+	{
+		isWritten = (fwrite(&cache->entries[index].key, sizeof(ResultCacheKey), 1, file) == 1) &&
+				(fwrite(&cache->entries[index].value, sizeof(ResultCacheValue), 1, file) == 1);
+	}
+	isWritten = (fclose(file) == 0) && isWritten;
+
+	if (!isWritten || (rename(temporaryPath, path) != 0))
+	{
+		fprintf(stderr, "Error: Could not write cache file \"%s\".\n", path);
+		remove(temporaryPath);
+		free(temporaryPath);
+
+		return kCommonConstantReturnTypeError;
+	}
+	free(temporaryPath);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+destroyResultCache(ResultCache *  cache)
+{
+	if (cache == NULL)
+	{
+		return;
+	}
+
+	free(cache->buckets);
+	free(cache->entries);
+	free(cache);
+
+	return;
+}
@@ -0,0 +1,220 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "common.h"
+#include "distribution-summary.h"
+#include "quasi-random.h"
+#include "random.h"
+
+/*
+ *	Inputs are quantized before they are compared, so that parameters that
+ *	only differ by rounding (e.g., from different ADC scalings) share an entry.
+ *	Voltages are quantized to kResultCacheVoltageQuantum, currents to
+ *	kResultCacheCurrentQuantum, and sensitivities to kResultCacheSensitivityQuantum.
+ */
+#define kResultCacheVoltageQuantum		(1e-6)
+#define kResultCacheCurrentQuantum		(1e-6)
+#define kResultCacheSensitivityQuantum		(1e-9)
+
+typedef enum
+{
+	kResultCacheConstantMaxThresholds	= 8,
+	kResultCacheConstantMaxEntries		= 1 << 24,
+	kResultCacheConstantFileVersion		= 3,
+} ResultCacheConstant;
+
+/*
+ *	What an evaluation computes:
+ *		kResultCacheKindSummary		: A whole `DistributionSummary`, and threshold probabilities.
+ *		kResultCacheKindMeanAndVariance	: Only the mean and variance (and number of samples)
+ *						  of the summary, as for the records of an input file.
+ */
+typedef enum
+{
+	kResultCacheKindSummary		= 0,
+	kResultCacheKindMeanAndVariance	= 1,
+} ResultCacheKind;
+
+/*
+ *	The quantized parameters of an evaluation. The seed, sampling method, random
+ *	generator and number of threads identify the random inputs of the parallel
+ *	Monte Carlo engine, each in a field of its own so that different random
+ *	inputs never share a key. The number of threads is zero when the samples are
+ *	drawn by index (Philox, Sobol or Latin hypercube), as they do not depend on
+ *	it. The fields are all zero for the serial loop (`numberOfThreads` zero
+ *	in `makeResultCacheKey()`), whose UxHw samples are not reproducible anyway.
+ *	Build keys with `makeResultCacheKey()`, so that the unused fields are zero.
+ */
+typedef struct
+{
+	uint64_t	kind;
+	int64_t		voutLow;
+	int64_t		voutHigh;
+	int64_t		vrefLow;
+	int64_t		vrefHigh;
+	int64_t		sensitivity;
+	uint64_t	numberOfSamples;
+	uint64_t	seed;
+	uint64_t	samplingMethod;
+	uint64_t	randomGenerator;
+	uint64_t	numberOfThreads;
+	uint64_t	numberOfThresholds;
+	int64_t		thresholds[kResultCacheConstantMaxThresholds];
+} ResultCacheKey;
+
+/*
+ *	The cached result of an evaluation: its summary and P(output <= threshold)
+ *	for each threshold of its key. The streamed summary of `-M` with `-n`, whose
+ *	key has no thresholds, keeps the probabilities printed for its output
+ *	(see `getCalibratedValueProbabilitiesFromCDF()`) in `thresholdProbabilities`.
+ */
+typedef struct
+{
+	DistributionSummary	summary;
+	double			thresholdProbabilities[kResultCacheConstantMaxThresholds];
+} ResultCacheValue;
+
+typedef struct
+{
+	uint64_t	hits;
+	uint64_t	misses;
+	uint64_t	evictions;
+} ResultCacheStatistics;
+
+typedef struct ResultCache	ResultCache;
+
+/**
+ *	@brief	Quantize the parameters of an evaluation into a cache key.
+ *
+ *	@param	key			: The key to set.
+ *	@param	kind			: What the evaluation computes.
+ *	@param	voutLow			: Lower bound of Vout, in V.
+ *	@param	voutHigh		: Upper bound of Vout, in V.
+ *	@param	vrefLow			: Lower bound of Vref, in V.
+ *	@param	vrefHigh		: Upper bound of Vref, in V.
+ *	@param	sensitivity		: Sensitivity of the sensor variant, in V/A.
+ *	@param	numberOfSamples		: The number of Monte Carlo iterations.
+ *	@param	seed			: The seed of the run.
+ *	@param	samplingMethod		: The sampling method of the run.
+ *	@param	randomGenerator		: The pseudo-random generator of the run.
+ *	@param	numberOfThreads		: The number of threads of the run, or zero for the serial
+ *					  loop, in which case the seed, sampling method and generator
+ *					  are ignored. Only kept in the key when the samples depend
+ *					  on it (see `ResultCacheKey`).
+ *	@param	thresholds		: The thresholds, in A. May be `NULL` if there are none.
+ *	@param	numberOfThresholds	: The number of thresholds, at most `kResultCacheConstantMaxThresholds`.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful, else
+ *					  `kCommonConstantReturnTypeError` if a voltage, the sensitivity
+ *					  or a threshold is not finite or too large to quantize, in
+ *					  which case the evaluation must not be looked up or cached.
+ */
+CommonConstantReturnType	makeResultCacheKey(
+		ResultCacheKey *	key,
+		ResultCacheKind		kind,
+		double			voutLow,
+		double			voutHigh,
+		double			vrefLow,
+		double			vrefHigh,
+		double			sensitivity,
+		uint64_t		numberOfSamples,
+		uint64_t		seed,
+		SamplingMethod		samplingMethod,
+		RandomGenerator		randomGenerator,
+		size_t			numberOfThreads,
+		const double *		thresholds,
+		size_t			numberOfThresholds);
+
+/**
+ *	@brief	Create an empty cache, holding at most `capacity` entries, least
+ *		recently used first out.
+ *
+ *	@param	capacity	: The number of entries, in [1, kResultCacheConstantMaxEntries].
+ *	@param	cache		: Set to the created cache on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createResultCache(size_t capacity, ResultCache **  cache);
+
+/**
+ *	@brief	Look up an evaluation, and count a hit or a miss. A hit becomes the
+ *		most recently used entry.
+ *
+ *	@param	cache	: The cache.
+ *	@param	key	: The key of the evaluation.
+ *	@param	value	: Where to copy the cached result on a hit.
+ *	@return		: `true` on a hit.
+ */
+bool	lookupResultCache(ResultCache *  cache, const ResultCacheKey *  key, ResultCacheValue *  value);
+
+/**
+ *	@brief	Insert or replace the result of an evaluation, as the most recently
+ *		used entry, evicting the least recently used entry if the cache is full.
+ *
+ *	@param	cache	: The cache.
+ *	@param	key	: The key of the evaluation.
+ *	@param	value	: Its result.
+ */
+void	insertResultCache(ResultCache *  cache, const ResultCacheKey *  key, const ResultCacheValue *  value);
+
+/**
+ *	@brief	Get the hit, miss and eviction counters of a cache.
+ *
+ *	@param	cache	: The cache.
+ *	@return		: The counters.
+ */
+ResultCacheStatistics	getResultCacheStatistics(const ResultCache *  cache);
+
+/**
+ *	@brief	Load the entries saved by `saveResultCache()`. A missing file is an
+ *		empty cache. If the file holds more entries than fit, only the most
+ *		recently used ones are kept.
+ *
+ *	@param	cache	: The cache to load into.
+ *	@param	path	: The cache file.
+ *	@return		: `kCommonConstantReturnTypeSuccess` if the file was loaded or does not
+ *			  exist, else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	loadResultCache(ResultCache *  cache, const char *  path);
+
+/**
+ *	@brief	Save the entries of a cache, least recently used first. The file is
+ *		written next to `path` and renamed over it, so that an interrupted
+ *		save leaves the previous file intact.
+ *
+ *	@param	cache	: The cache.
+ *	@param	path	: The cache file.
+ *	@return		: `kCommonConstantReturnTypeSuccess` if successful,
+ *			  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	saveResultCache(const ResultCache *  cache, const char *  path);
+
+/**
+ *	@brief	Release a cache.
+ *
+ *	@param	cache	: The cache. May be `NULL`.
+ */
+void	destroyResultCache(ResultCache *  cache);
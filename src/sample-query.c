@@ -0,0 +1,298 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sample-query.h"
+
+static int
+compareDoubles(const void *  a, const void *  b)
+{
+	double	x = *(const double *)a;
+	double	y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ *	Maps a double to an unsigned integer with the same ordering: negative values
+ *	have all their bits flipped, and non-negative values have their sign bit set.
+ */
+static inline uint64_t
+orderedKeyOfDouble(double value)
+{
+	uint64_t	bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+}
+
+/*
+ *	Least-significant-digit radix sort, in 64 / kSampleQueryConstantRadixBits passes.
+ *	The number of passes is even, so the sorted samples end up back in `samples`.
+ */
+static void
+radixSortDoubles(double *  samples, size_t numberOfSamples)
+{
+	const size_t	numberOfBuckets = (size_t)1 << kSampleQueryConstantRadixBits;
+	double *	scratch = checkedMalloc(numberOfSamples * sizeof(double), __FILE__, __LINE__);
+	size_t *	counts = checkedMalloc(numberOfBuckets * sizeof(size_t), __FILE__, __LINE__);
+	double *	source = samples;
+	double *	destination = scratch;
+
+	for (int shift = 0; shift < 64; shift += kSampleQueryConstantRadixBits)
+	{
+		size_t		offset = 0;
+		double *	swap;
+
+		memset(counts, 0, numberOfBuckets * sizeof(size_t));
+		for (size_t i = 0; i < numberOfSamples; i++)
+		{
+			counts[(orderedKeyOfDouble(source[i]) >> shift) & (numberOfBuckets - 1)]++;
+		}
+
+		for (size_t b = 0; b < numberOfBuckets; b++)
+		{
+			size_t	count = counts[b];
+
+			counts[b] = offset;
+			offset += count;
+		}
+
+		for (size_t i = 0; i < numberOfSamples; i++)
+		{
+			destination[counts[(orderedKeyOfDouble(source[i]) >> shift) & (numberOfBuckets - 1)]++] = source[i];
+		}
+
+		swap = source;
+		source = destination;
+		destination = swap;
+	}
+
+	free(counts);
+	free(scratch);
+
+	return;
+}
+
+void
+buildSampleQueryIndex(const double *  samples, size_t numberOfSamples, SampleQueryIndex *  index)
+{
+	index->numberOfSamples = numberOfSamples;
+	index->sortedSamples = checkedMalloc(numberOfSamples * sizeof(double), __FILE__, __LINE__);
+	memcpy(index->sortedSamples, samples, numberOfSamples * sizeof(double));
+
+	if (numberOfSamples < kSampleQueryConstantRadixSortThreshold)
+	{
+		qsort(index->sortedSamples, numberOfSamples, sizeof(double), compareDoubles);
+	}
+	else
+	{
+		radixSortDoubles(index->sortedSamples, numberOfSamples);
+	}
+
+	return;
+}
+
+void
+freeSampleQueryIndex(SampleQueryIndex *  index)
+{
+	free(index->sortedSamples);
+	index->sortedSamples = NULL;
+	index->numberOfSamples = 0;
+
+	return;
+}
+
+double
+sampleQueryIndexCDF(const void *  index, double x)
+{
+	const SampleQueryIndex *	sampleIndex = index;
+	size_t				low = 0;
+	size_t				high = sampleIndex->numberOfSamples;
+
+	/*
+	 *	Find the first sample greater than `x`.
+	 */
+	while (low < high)
+	{
+		size_t	middle = low + (high - low) / 2;
+
+		if (sampleIndex->sortedSamples[middle] <= x)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return (double)low / (double)sampleIndex->numberOfSamples;
+}
+
+double
+sampleQueryIndexQuantile(const void *  index, double probability)
+{
+	const SampleQueryIndex *	sampleIndex = index;
+	double				rank = ceil(fmin(fmax(probability, 0.0), 1.0) * (double)sampleIndex->numberOfSamples);
+
+	return sampleIndex->sortedSamples[(rank > 0) ? (size_t)rank - 1 : 0];
+}
+
+static CommonConstantReturnType
+appendSampleQuery(SampleQueryList *  list, SampleQueryKind kind, double value)
+{
+	if ((kind == kSampleQueryKindQuantile) && !((value >= 0.0) && (value <= 1.0)))
+	{
+		fprintf(stderr, "Error: Quantile query probability should be in [0, 1]: Provided %lf.\n", value);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	if (list->numberOfQueries == list->capacity)
+	{
+		size_t		capacity = (list->capacity == 0) ? 16 : 2 * list->capacity;
+		SampleQuery *	queries = realloc(list->queries, capacity * sizeof(SampleQuery));
+
+		if (queries == NULL)
+		{
+			fprintf(stderr, "Error: Could not allocate query list.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+		list->queries = queries;
+		list->capacity = capacity;
+	}
+
+	list->queries[list->numberOfQueries++] = (SampleQuery){ .kind = kind, .value = value };
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+appendSampleQueries(SampleQueryList *  list, SampleQueryKind kind, const char *  values)
+{
+	const char *	cursor = values;
+
+	for (;;)
+	{
+		char *	end;
+		double	value;
+
+		errno = 0;
+		value = strtod(cursor, &end);
+		if ((end == cursor) || (errno == ERANGE) || ((*end != ',') && (*end != '\0')))
+		{
+			fprintf(stderr, "Error: Malformed query value list \"%s\".\n", values);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (appendSampleQuery(list, kind, value) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (*end == '\0')
+		{
+			break;
+		}
+		cursor = end + 1;
+	}
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+CommonConstantReturnType
+readSampleQueryFile(SampleQueryList *  list, const char *  path)
+{
+	FILE *		file = fopen(path, "r");
+	char		line[kCommonConstantMaxCharsPerLine];
+	size_t		lineNumber = 0;
+
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error: Could not open query file \"%s\".\n", path);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		char		kind[16];
+		double		value;
+		char		trailing;
+		int		numberOfFields;
+		SampleQueryKind	queryKind = kSampleQueryKindLessOrEqual;
+
+		lineNumber++;
+		numberOfFields = sscanf(line, " %15s %lf %c", kind, &value, &trailing);
+		if ((numberOfFields <= 0) || (kind[0] == '#'))
+		{
+			continue;
+		}
+
+		if (strcmp(kind, "le") == 0)
+		{
+			queryKind = kSampleQueryKindLessOrEqual;
+		}
+		else if (strcmp(kind, "gt") == 0)
+		{
+			queryKind = kSampleQueryKindGreaterThan;
+		}
+		else if (strcmp(kind, "quantile") == 0)
+		{
+			queryKind = kSampleQueryKindQuantile;
+		}
+		else
+		{
+			numberOfFields = 0;
+		}
+
+		if ((numberOfFields != 2) || (appendSampleQuery(list, queryKind, value) != kCommonConstantReturnTypeSuccess))
+		{
+			fprintf(stderr, "Error: Malformed query on line %zu of \"%s\".\n", lineNumber, path);
+			fclose(file);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	fclose(file);
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+freeSampleQueryList(SampleQueryList *  list)
+{
+	free(list->queries);
+	*list = (SampleQueryList){0};
+
+	return;
+}
@@ -0,0 +1,134 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+
+/*
+ *	Below this many samples, the index sorts with `qsort()` rather than a radix sort.
+ */
+typedef enum
+{
+	kSampleQueryConstantRadixSortThreshold	= 4096,
+	kSampleQueryConstantRadixBits		= 16,
+} SampleQueryConstant;
+
+/*
+ *	Query kinds:
+ *		kSampleQueryKindLessOrEqual	: P(X <= value).
+ *		kSampleQueryKindGreaterThan	: P(X > value).
+ *		kSampleQueryKindQuantile	: The quantile at probability `value`.
+ */
+typedef enum
+{
+	kSampleQueryKindLessOrEqual	= 0,
+	kSampleQueryKindGreaterThan	= 1,
+	kSampleQueryKindQuantile	= 2,
+} SampleQueryKind;
+
+typedef struct
+{
+	SampleQueryKind	kind;
+	double		value;
+} SampleQuery;
+
+typedef struct
+{
+	SampleQuery *	queries;
+	size_t		numberOfQueries;
+	size_t		capacity;
+} SampleQueryList;
+
+/*
+ *	The samples of a Monte Carlo run, sorted once so that each CDF or quantile
+ *	query takes O(log N) (CDF) or O(1) (quantile) time.
+ */
+typedef struct
+{
+	double *	sortedSamples;
+	size_t		numberOfSamples;
+} SampleQueryIndex;
+
+/**
+ *	@brief	Build the query index of a set of samples. The samples are copied, not modified.
+ *
+ *	@param	samples		: The samples.
+ *	@param	numberOfSamples	: The number of samples. Must be non-zero.
+ *	@param	index		: Where to write the index.
+ */
+void	buildSampleQueryIndex(const double *  samples, size_t numberOfSamples, SampleQueryIndex *  index);
+
+/**
+ *	@brief	Release the memory of a query index.
+ *
+ *	@param	index		: The index.
+ */
+void	freeSampleQueryIndex(SampleQueryIndex *  index);
+
+/**
+ *	@brief	Empirical cumulative distribution function, the fraction of samples <= x.
+ *
+ *	@param	index		: The index, as `const SampleQueryIndex *`.
+ *	@param	x		: The threshold.
+ *	@return			: The fraction of samples that are at most `x`.
+ */
+double	sampleQueryIndexCDF(const void *  index, double x);
+
+/**
+ *	@brief	Empirical quantile function (nearest rank).
+ *
+ *	@param	index		: The index, as `const SampleQueryIndex *`.
+ *	@param	probability	: The probability, in [0, 1].
+ *	@return			: The smallest sample whose empirical CDF is at least `probability`.
+ */
+double	sampleQueryIndexQuantile(const void *  index, double probability);
+
+/**
+ *	@brief	Append queries of one kind, given as a comma-separated list of values.
+ *
+ *	@param	list		: The query list to append to.
+ *	@param	kind		: The kind of every query in `values`.
+ *	@param	values		: The comma-separated values, e.g., "9.5,10,12.25".
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	appendSampleQueries(SampleQueryList *  list, SampleQueryKind kind, const char *  values);
+
+/**
+ *	@brief	Append the queries of a query file. Each non-blank line that does not start
+ *		with `#` holds one query: `le <threshold>`, `gt <threshold>` or `quantile <probability>`.
+ *
+ *	@param	list		: The query list to append to.
+ *	@param	path		: Path to the query file.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	readSampleQueryFile(SampleQueryList *  list, const char *  path);
+
+/**
+ *	@brief	Release the memory of a query list.
+ *
+ *	@param	list		: The query list.
+ */
+void	freeSampleQueryList(SampleQueryList *  list);
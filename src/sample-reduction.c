@@ -0,0 +1,154 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "sample-reduction.h"
+
+typedef struct
+{
+	const ConversionKernels *	kernels;
+	const double *			samples;
+	size_t				numberOfSamples;
+	size_t				numberOfChunks;
+	size_t				numberOfTasks;
+	BlockMoments *			chunkMoments;
+} SampleReductionContext;
+
+static void
+reduceSampleChunks(size_t taskIndex, void *  context)
+{
+	SampleReductionContext *	reductionContext = context;
+	size_t				begin = (reductionContext->numberOfChunks * taskIndex) / reductionContext->numberOfTasks;
+	size_t				end = (reductionContext->numberOfChunks * (taskIndex + 1)) / reductionContext->numberOfTasks;
+
+	for (size_t chunk = begin; chunk < end; chunk++)
+	{
+		size_t	first = chunk * kSampleReductionConstantChunkSize;
+		size_t	count = reductionContext->numberOfSamples - first;
+
+		count = (count < kSampleReductionConstantChunkSize) ? count : kSampleReductionConstantChunkSize;
+		reductionContext->kernels->accumulateMomentsBlock(&reductionContext->samples[first], count, &reductionContext->chunkMoments[chunk]);
+	}
+
+	return;
+}
+
+/*
+ *	Merges the moments of `b` into those of `a`, with the pairwise update
+ *	formulas of Pébay, "Formulas for robust, one-pass parallel computation of
+ *	covariances and arbitrary-order statistical moments" (Sandia report
+ *	SAND2008-6212, 2008).
+ */
+static void
+mergeBlockMoments(BlockMoments *  a, const BlockMoments *  b)
+{
+	double	na = (double)a->count;
+	double	nb = (double)b->count;
+	double	n = na + nb;
+	double	delta = b->mean - a->mean;
+	double	deltaOverN = delta / n;
+	double	deltaOverNSquared = deltaOverN * deltaOverN;
+	double	crossTerm = delta * deltaOverN * na * nb;
+
+	a->sumOfFourthPowerDeviations += b->sumOfFourthPowerDeviations +
+			crossTerm * deltaOverNSquared * (na * na - na * nb + nb * nb) +
+			6.0 * deltaOverNSquared * (na * na * b->sumOfSquaredDeviations + nb * nb * a->sumOfSquaredDeviations) +
+			4.0 * deltaOverN * (na * b->sumOfCubedDeviations - nb * a->sumOfCubedDeviations);
+	a->sumOfCubedDeviations += b->sumOfCubedDeviations +
+			crossTerm * deltaOverN * (na - nb) +
+			3.0 * deltaOverN * (na * b->sumOfSquaredDeviations - nb * a->sumOfSquaredDeviations);
+	a->sumOfSquaredDeviations += b->sumOfSquaredDeviations + crossTerm;
+	a->mean += deltaOverN * nb;
+	a->count += b->count;
+	a->minimum = (b->minimum < a->minimum) ? b->minimum : a->minimum;
+	a->maximum = (b->maximum > a->maximum) ? b->maximum : a->maximum;
+
+	return;
+}
+
+void
+reduceSampleMoments(
+	ThreadPool *			pool,
+	const ConversionKernels *	kernels,
+	const double *			samples,
+	size_t				numberOfSamples,
+	SampleMoments *			moments)
+{
+	SampleReductionContext	context;
+	BlockMoments *		total;
+	double			n = (double)numberOfSamples;
+
+	*moments = (SampleMoments) {0};
+	if (numberOfSamples == 0)
+	{
+		return;
+	}
+
+	context = (SampleReductionContext)
+	{
+		.kernels = kernels,
+		.samples = samples,
+		.numberOfSamples = numberOfSamples,
+		.numberOfChunks = (numberOfSamples + kSampleReductionConstantChunkSize - 1) / kSampleReductionConstantChunkSize,
+		.numberOfTasks = (pool != NULL) ? getThreadPoolSize(pool) : 1,
+	};
+	context.chunkMoments = checkedMalloc(context.numberOfChunks * sizeof(BlockMoments), __FILE__, __LINE__);
+
+	if (pool != NULL)
+	{
+		runThreadPoolTasks(pool, reduceSampleChunks, &context, context.numberOfTasks);
+	}
+	else
+	{
+		reduceSampleChunks(0, &context);
+	}
+
+	/*
+	 *	Merge neighbouring chunks, then neighbouring pairs, and so on, so that
+	 *	rounding errors grow with the logarithm of the number of chunks.
+	 */
+	for (size_t stride = 1; stride < context.numberOfChunks; stride *= 2)
+	{
+		for (size_t i = 0; i + stride < context.numberOfChunks; i += 2 * stride)
+		{
+			mergeBlockMoments(&context.chunkMoments[i], &context.chunkMoments[i + stride]);
+		}
+	}
+	total = &context.chunkMoments[0];
+
+	moments->numberOfSamples = numberOfSamples;
+	moments->mean = total->mean;
+	moments->variance = (numberOfSamples > 1) ? total->sumOfSquaredDeviations / (n - 1.0) : 0.0;
+	moments->minimum = total->minimum;
+	moments->maximum = total->maximum;
+	if (total->sumOfSquaredDeviations > 0)
+	{
+		moments->skewness = sqrt(n) * total->sumOfCubedDeviations / pow(total->sumOfSquaredDeviations, 1.5);
+		moments->excessKurtosis = n * total->sumOfFourthPowerDeviations /
+				(total->sumOfSquaredDeviations * total->sumOfSquaredDeviations) - 3.0;
+	}
+
+	free(context.chunkMoments);
+
+	return;
+}
@@ -0,0 +1,72 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "conversion-kernels.h"
+#include "thread-pool.h"
+
+/*
+ *	Samples are reduced in chunks of `kSampleReductionConstantChunkSize` samples,
+ *	small enough for both passes of the moments kernel to run from the L1 or L2
+ *	cache. The chunks do not depend on the number of threads, and their moments
+ *	are merged in a fixed pairwise tree, so the result is the same for any
+ *	number of threads and any kernel instruction set.
+ */
+typedef enum
+{
+	kSampleReductionConstantChunkSize	= 4096,
+} SampleReductionConstant;
+
+/*
+ *	Moments of a set of samples. The variance is the unbiased sample variance,
+ *	the skewness and excess kurtosis are the (biased) moment ratios g1 and g2,
+ *	and all three are zero for a set of identical samples.
+ */
+typedef struct
+{
+	size_t	numberOfSamples;
+	double	mean;
+	double	variance;
+	double	skewness;
+	double	excessKurtosis;
+	double	minimum;
+	double	maximum;
+} SampleMoments;
+
+/**
+ *	@brief	Compute the moments of the samples in one pass over memory, in parallel.
+ *
+ *	@param	pool		: The thread pool to run the chunks on, or `NULL` to run them
+ *				  on the calling thread.
+ *	@param	kernels		: The kernels whose `accumulateMomentsBlock` reduces each chunk.
+ *	@param	samples		: The samples.
+ *	@param	numberOfSamples	: The number of samples. The moments of zero samples are all zero.
+ *	@param	moments		: Where to write the moments.
+ */
+void	reduceSampleMoments(
+		ThreadPool *			pool,
+		const ConversionKernels *	kernels,
+		const double *			samples,
+		size_t				numberOfSamples,
+		SampleMoments *			moments);
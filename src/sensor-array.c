@@ -0,0 +1,130 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sensor-array.h"
+
+CommonConstantReturnType
+createSensorArray(
+	size_t			numberOfChannels,
+	const double *		sensitivities,
+	const double *		gains,
+	const double *		offsets,
+	ConversionKernelIsa	isa,
+	SensorArray **		array)
+{
+	const ConversionKernels *	kernels = selectConversionKernels(isa);
+	SensorArray *			newArray;
+
+	if ((numberOfChannels == 0) || (kernels == NULL))
+	{
+		fprintf(stderr, "Error: A sensor array needs at least one channel and a supported conversion kernel.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	for (size_t c = 0; c < numberOfChannels; c++)
+	{
+		if (!(sensitivities[c] > 0))
+		{
+			fprintf(stderr, "Error: The sensitivity of channel %zu should be positive: Provided %lf.\n", c, sensitivities[c]);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	newArray = checkedMalloc(sizeof(SensorArray), __FILE__, __LINE__);
+	newArray->numberOfChannels = numberOfChannels;
+	newArray->scale = checkedMalloc(numberOfChannels * sizeof(double), __FILE__, __LINE__);
+	newArray->offset = checkedMalloc(numberOfChannels * sizeof(double), __FILE__, __LINE__);
+	newArray->kernels = kernels;
+
+	for (size_t c = 0; c < numberOfChannels; c++)
+	{
+		newArray->scale[c] = ((gains != NULL) ? gains[c] : 1.0) / sensitivities[c];
+		newArray->offset[c] = (offsets != NULL) ? offsets[c] : 0.0;
+	}
+
+	*array = newArray;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+convertSensorArrayFrame(
+	const SensorArray *	array,
+	const double *		vout,
+	const double *		vref,
+	double *		calibratedCurrent)
+{
+	convertSensorArrayFrames(array, vout, vref, calibratedCurrent, 1);
+
+	return;
+}
+
+void
+convertSensorArrayFrames(
+	const SensorArray *	array,
+	const double *		vout,
+	const double *		vref,
+	double *		calibratedCurrent,
+	size_t			numberOfFrames)
+{
+	size_t	numberOfChannels = array->numberOfChannels;
+
+	for (size_t begin = 0; begin < numberOfChannels; begin += kSensorArrayConstantBlockChannels)
+	{
+		size_t	count = ((numberOfChannels - begin) < kSensorArrayConstantBlockChannels) ?
+					(numberOfChannels - begin) : kSensorArrayConstantBlockChannels;
+
+		for (size_t f = 0; f < numberOfFrames; f++)
+		{
+			size_t	first = f * numberOfChannels + begin;
+
+			array->kernels->convertSensorArrayBlock(
+						&vout[first],
+						&vref[first],
+						&array->scale[begin],
+						&array->offset[begin],
+						&calibratedCurrent[first],
+						count);
+		}
+	}
+
+	return;
+}
+
+void
+destroySensorArray(SensorArray *  array)
+{
+	if (array == NULL)
+	{
+		return;
+	}
+
+	free(array->scale);
+	free(array->offset);
+	free(array);
+
+	return;
+}
@@ -0,0 +1,113 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+#include "conversion-kernels.h"
+
+/*
+ *	Frames are converted in blocks of `kSensorArrayConstantBlockChannels`
+ *	channels. Converting many frames at once sweeps all frames for one block of
+ *	channels before moving to the next, so that the block's calibration stays
+ *	in the L1 cache.
+ */
+typedef enum
+{
+	kSensorArrayConstantBlockChannels	= 512,
+} SensorArrayConstant;
+
+/*
+ *	An array of sensors sampled together. Channel `c` of a frame converts as
+ *
+ *		calibratedCurrent[c] = (vout[c] - vref[c]) * gain[c] / sensitivity[c] - offset[c]
+ *
+ *	where `gain` is a per-channel gain correction and `offset` the per-channel
+ *	zero-current offset, in A. The channels of a frame are contiguous in each
+ *	of the Vout, Vref and output arrays (structure of arrays).
+ */
+typedef struct
+{
+	size_t				numberOfChannels;
+	double *			scale;
+	double *			offset;
+	const ConversionKernels *	kernels;
+} SensorArray;
+
+/**
+ *	@brief	Create a sensor array, precomputing the per-channel scale `gain / sensitivity`.
+ *
+ *	@param	numberOfChannels	: The number of channels.
+ *	@param	sensitivities		: The sensitivity of each channel, in V/A.
+ *	@param	gains			: The gain correction of each channel, or `NULL` for none.
+ *	@param	offsets			: The zero-current offset of each channel in A, or `NULL` for none.
+ *	@param	isa			: The instruction set of the conversion kernel.
+ *	@param	array			: Set to the created array on success.
+ *	@return				: `kCommonConstantReturnTypeSuccess` if successful,
+ *					  else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createSensorArray(
+					size_t			numberOfChannels,
+					const double *		sensitivities,
+					const double *		gains,
+					const double *		offsets,
+					ConversionKernelIsa	isa,
+					SensorArray **		array);
+
+/**
+ *	@brief	Convert a frame: one reading of every channel.
+ *
+ *	@param	array			: The sensor array.
+ *	@param	vout			: The Vout reading of each channel.
+ *	@param	vref			: The Vref reading of each channel.
+ *	@param	calibratedCurrent	: Where to write the calibrated current of each channel.
+ */
+void	convertSensorArrayFrame(
+		const SensorArray *	array,
+		const double *		vout,
+		const double *		vref,
+		double *		calibratedCurrent);
+
+/**
+ *	@brief	Convert consecutive frames, stored one after the other (frame `f`, channel `c`
+ *		at index `f * numberOfChannels + c`).
+ *
+ *	@param	array			: The sensor array.
+ *	@param	vout			: The Vout readings.
+ *	@param	vref			: The Vref readings.
+ *	@param	calibratedCurrent	: Where to write the calibrated currents.
+ *	@param	numberOfFrames		: The number of frames.
+ */
+void	convertSensorArrayFrames(
+		const SensorArray *	array,
+		const double *		vout,
+		const double *		vref,
+		double *		calibratedCurrent,
+		size_t			numberOfFrames);
+
+/**
+ *	@brief	Release a sensor array.
+ *
+ *	@param	array	: The sensor array. May be `NULL`.
+ */
+void	destroySensorArray(SensorArray *  array);
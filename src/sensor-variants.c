@@ -0,0 +1,83 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <strings.h>
+#include "sensor-variants.h"
+
+#define TMCS112X_SENSOR_VARIANT_ENTRY(variantName, variantSensitivity, variantSupplyVoltage, variantZeroCurrentReference)	\
+	[kSensorVariantIndex##variantName] =								\
+	{												\
+		.name = #variantName,									\
+		.index = kSensorVariantIndex##variantName,						\
+		.sensitivity = (variantSensitivity),							\
+		.sensitivityReciprocal = 1.0 / (variantSensitivity),					\
+		.supplyVoltage = (variantSupplyVoltage),						\
+		.zeroCurrentReference = (variantZeroCurrentReference),					\
+		.currentRange = (variantZeroCurrentReference) / (variantSensitivity),			\
+		.calculateCalibratedCurrent = calculateCalibratedCurrent##variantName,			\
+	},
+
+const SensorVariant	kSensorVariants[kSensorVariantIndexMax] =
+			{
+				TMCS112X_SENSOR_VARIANTS(TMCS112X_SENSOR_VARIANT_ENTRY)
+			};
+
+const SensorVariant *
+findSensorVariant(const char *  name)
+{
+	for (size_t i = 0; i < kSensorVariantIndexMax; i++)
+	{
+		if (strcasecmp(name, kSensorVariants[i].name) == 0)
+		{
+			return &kSensorVariants[i];
+		}
+	}
+
+	return NULL;
+}
+
+void
+initializeSensorErrorModel(SensorErrorModel *  model, const SensorVariant *  sensorVariant, double temperatureLow, double temperatureHigh)
+{
+	model->low[kInputDistributionIndexVout] = kDefaultInputDistributionVoutUniformDistLow;
+	model->high[kInputDistributionIndexVout] = kDefaultInputDistributionVoutUniformDistHigh;
+	model->low[kInputDistributionIndexVref] = kDefaultInputDistributionVrefUniformDistLow;
+	model->high[kInputDistributionIndexVref] = kDefaultInputDistributionVrefUniformDistHigh;
+	model->low[kInputDistributionIndexSensitivityError] = -kSensorErrorModelSensitivityErrorLimit;
+	model->high[kInputDistributionIndexSensitivityError] = kSensorErrorModelSensitivityErrorLimit;
+	model->low[kInputDistributionIndexOffsetError] = -kSensorErrorModelOffsetErrorLimit;
+	model->high[kInputDistributionIndexOffsetError] = kSensorErrorModelOffsetErrorLimit;
+	model->low[kInputDistributionIndexTemperature] = temperatureLow;
+	model->high[kInputDistributionIndexTemperature] = temperatureHigh;
+	model->low[kInputDistributionIndexSensitivityDrift] = -kSensorErrorModelSensitivityDriftLimit;
+	model->high[kInputDistributionIndexSensitivityDrift] = kSensorErrorModelSensitivityDriftLimit;
+	model->low[kInputDistributionIndexOffsetDrift] = -kSensorErrorModelOffsetDriftLimit;
+	model->high[kInputDistributionIndexOffsetDrift] = kSensorErrorModelOffsetDriftLimit;
+	model->low[kInputDistributionIndexNonlinearity] = -kSensorErrorModelNonlinearityLimit;
+	model->high[kInputDistributionIndexNonlinearity] = kSensorErrorModelNonlinearityLimit;
+
+	model->sensitivity = sensorVariant->sensitivity;
+	model->reciprocalCurrentRange = 1.0 / sensorVariant->currentRange;
+	model->referenceTemperature = kSensorErrorModelReferenceTemperature;
+
+	return;
+}
@@ -0,0 +1,145 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+#include "utilities-config.h"
+
+/*
+ *	The TMCS112x family variants, as
+ *		X(name, sensitivity in V/A, supply voltage in V, zero-current reference output in V)
+ *
+ *	All variants are the 5 V supply, bidirectional TMCS1123 parts, whose
+ *	zero-current reference output is at half the supply. The TMCS1122 parts and
+ *	the 3.3 V supply variants are left out until their values are verified
+ *	against the datasheets. Each variant gets its own conversion function
+ *	below, in which the reciprocal of the sensitivity is a compile-time
+ *	constant. The default Vout and Vref inputs are the same readings for every
+ *	variant.
+ */
+#define TMCS112X_SENSOR_VARIANTS(X)									\
+	X(TMCS1123x1A,	0.025,	5.0,	2.5)								\
+	X(TMCS1123x2A,	0.050,	5.0,	2.5)								\
+	X(TMCS1123x3A,	kSensorCalibrationConstantTMCS1123x3ASensitivity,	5.0,	2.5)		\
+	X(TMCS1123x4A,	0.100,	5.0,	2.5)								\
+	X(TMCS1123x5A,	0.150,	5.0,	2.5)
+
+#define TMCS112X_SENSOR_VARIANT_INDEX(variantName, variantSensitivity, variantSupplyVoltage, variantZeroCurrentReference)	kSensorVariantIndex##variantName,
+
+typedef enum
+{
+	TMCS112X_SENSOR_VARIANTS(TMCS112X_SENSOR_VARIANT_INDEX)
+	kSensorVariantIndexMax,
+} SensorVariantIndex;
+
+/*
+ *	Converts one pair of Vout and Vref values (or distributions) to the calibrated current.
+ */
+typedef double	(*SensorOutputFunction)(double vout, double vref);
+
+/*
+ *	One conversion function per variant, e.g., `calculateCalibratedCurrentTMCS1123x3A()`.
+ *	The sensitivity is a literal, so the division by it is folded into a
+ *	multiplication by a constant reciprocal. They are defined here, rather than
+ *	only reached through `SensorVariant`, so that loops specialized per variant
+ *	can inline them.
+ */
+#define TMCS112X_SENSOR_VARIANT_FUNCTION(variantName, variantSensitivity, variantSupplyVoltage, variantZeroCurrentReference)	\
+	static inline double										\
+	calculateCalibratedCurrent##variantName(double vout, double vref)				\
+	{												\
+		return (vout - vref) * (1.0 / (variantSensitivity));					\
+	}
+
+TMCS112X_SENSOR_VARIANTS(TMCS112X_SENSOR_VARIANT_FUNCTION)
+
+typedef struct
+{
+	const char *		name;
+
+	/*
+	 *	The index of the variant in `kSensorVariants`, for a `switch` that
+	 *	selects a loop specialized to the variant once, outside the loop.
+	 */
+	SensorVariantIndex	index;
+
+	double			sensitivity;
+
+	/*
+	 *	The same constant as in the conversion function of the variant, for the
+	 *	batched kernels, which take the reciprocal as an argument.
+	 */
+	double			sensitivityReciprocal;
+	double			supplyVoltage;
+	double			zeroCurrentReference;
+
+	/*
+	 *	The input current range, ±`currentRange`, over which the ideal output
+	 *	stays between the supply rails.
+	 */
+	double			currentRange;
+
+	SensorOutputFunction	calculateCalibratedCurrent;
+} SensorVariant;
+
+extern const SensorVariant	kSensorVariants[kSensorVariantIndexMax];
+
+/*
+ *	The extended error model of a variant (`-e` option): every input, indexed by
+ *	`InputDistributionIndex`, is uniform over [low, high], and the calibrated current is
+ *
+ *		dT = temperature - referenceTemperature
+ *		I0 = (Vout - Vref - (offsetError + offsetDrift * dT)) / (sensitivity * (1 + sensitivityError + sensitivityDrift * dT))
+ *		I  = I0 - nonlinearity * I0^2 / currentRange
+ *
+ *	so that the nonlinearity is a quadratic bow, which is zero at zero current and
+ *	`nonlinearity` times the full-scale current at full scale.
+ */
+typedef struct
+{
+	double	low[kInputDistributionIndexMax];
+	double	high[kInputDistributionIndexMax];
+	double	sensitivity;
+	double	reciprocalCurrentRange;
+	double	referenceTemperature;
+} SensorErrorModel;
+
+/**
+ *	@brief	Find a variant by name (e.g., `TMCS1123x3A`), ignoring case.
+ *
+ *	@param	name	: The name of the variant.
+ *	@return		: The variant, or `NULL` if there is none of that name.
+ */
+const SensorVariant *	findSensorVariant(const char *  name);
+
+/**
+ *	@brief	Set up the extended error model of a variant, with the default Vout and Vref
+ *		inputs and the datasheet limits of the error terms in `utilities-config.h`.
+ *
+ *	@param	model			: The model to set up.
+ *	@param	sensorVariant		: The sensor variant.
+ *	@param	temperatureLow		: Lower bound of the ambient temperature (in °C).
+ *	@param	temperatureHigh		: Upper bound of the ambient temperature (in °C).
+ */
+void	initializeSensorErrorModel(SensorErrorModel *  model, const SensorVariant *  sensorVariant, double temperatureLow, double temperatureHigh);
@@ -0,0 +1,172 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sliding-window.h"
+
+/*
+ *	A sum that is updated by adding and subtracting terms, with the rounding
+ *	error of each update carried in `compensation` (Neumaier's variant of Kahan
+ *	summation), so that the error of the running sums of a window does not grow
+ *	with the number of readings that went through it.
+ */
+typedef struct
+{
+	double	sum;
+	double	compensation;
+} CompensatedSum;
+
+/*
+ *	The window keeps the sums of the reading means, of their squares and of the
+ *	reading variances and tail probabilities, so that adding a reading and
+ *	evicting the oldest one are two updates of each sum. The means are shifted
+ *	by that of the first reading, so that the variance of the means does not
+ *	cancel against the square of a large mean.
+ */
+struct SlidingWindow
+{
+	size_t			windowSize;
+	size_t			numberOfReadings;
+	size_t			oldestReadingIndex;
+	double			shift;
+	CompensatedSum		sumOfShiftedMeans;
+	CompensatedSum		sumOfSquaredShiftedMeans;
+	CompensatedSum		sumOfVariances;
+	CompensatedSum		sumOfProbabilities;
+	ReadingSummary		readings[];
+};
+
+static inline void
+addToCompensatedSum(CompensatedSum *  compensatedSum, double term)
+{
+	double	sum = compensatedSum->sum + term;
+
+	if (fabs(compensatedSum->sum) >= fabs(term))
+	{
+		compensatedSum->compensation += (compensatedSum->sum - sum) + term;
+	}
+	else
+	{
+		compensatedSum->compensation += (term - sum) + compensatedSum->sum;
+	}
+	compensatedSum->sum = sum;
+
+	return;
+}
+
+static inline double
+getCompensatedSum(const CompensatedSum *  compensatedSum)
+{
+	return compensatedSum->sum + compensatedSum->compensation;
+}
+
+CommonConstantReturnType
+createSlidingWindow(size_t windowSize, SlidingWindow **  window)
+{
+	SlidingWindow *	newWindow;
+
+	if ((windowSize == 0) || (windowSize > kSlidingWindowConstantMaxWindowSize))
+	{
+		fprintf(stderr, "Error: The window size should be in [1, %d]: Provided %zu.\n", kSlidingWindowConstantMaxWindowSize, windowSize);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newWindow = calloc(1, sizeof(SlidingWindow) + windowSize * sizeof(ReadingSummary));
+	if (newWindow == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate a window of %zu readings.\n", windowSize);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newWindow->windowSize = windowSize;
+	*window = newWindow;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+updateSlidingWindow(SlidingWindow *  window, const ReadingSummary *  reading, WindowStatistics *  statistics)
+{
+	ReadingSummary *	slot;
+	double			shiftedMean;
+	double			numberOfReadings;
+	double			meanOfShiftedMeans;
+	double			varianceOfMeans;
+
+	if (window->numberOfReadings == 0)
+	{
+		window->shift = reading->mean;
+	}
+
+	if (window->numberOfReadings == window->windowSize)
+	{
+		slot = &window->readings[window->oldestReadingIndex];
+		window->oldestReadingIndex = (window->oldestReadingIndex + 1 == window->windowSize) ? 0 : window->oldestReadingIndex + 1;
+
+		shiftedMean = slot->mean - window->shift;
+		addToCompensatedSum(&window->sumOfShiftedMeans, -shiftedMean);
+		addToCompensatedSum(&window->sumOfSquaredShiftedMeans, -(shiftedMean * shiftedMean));
+		addToCompensatedSum(&window->sumOfVariances, -slot->variance);
+		addToCompensatedSum(&window->sumOfProbabilities, -slot->probabilityAboveThreshold);
+	}
+	else
+	{
+		size_t	newestReadingIndex = window->oldestReadingIndex + window->numberOfReadings;
+
+		slot = &window->readings[(newestReadingIndex < window->windowSize) ? newestReadingIndex : newestReadingIndex - window->windowSize];
+		window->numberOfReadings++;
+	}
+
+	*slot = *reading;
+	shiftedMean = reading->mean - window->shift;
+	addToCompensatedSum(&window->sumOfShiftedMeans, shiftedMean);
+	addToCompensatedSum(&window->sumOfSquaredShiftedMeans, shiftedMean * shiftedMean);
+	addToCompensatedSum(&window->sumOfVariances, reading->variance);
+	addToCompensatedSum(&window->sumOfProbabilities, reading->probabilityAboveThreshold);
+
+	/*
+	 *	The sums are exact up to rounding, which may still leave them slightly
+	 *	outside of their ranges once the terms that made them up are evicted.
+	 */
+	numberOfReadings = (double)window->numberOfReadings;
+	meanOfShiftedMeans = getCompensatedSum(&window->sumOfShiftedMeans) / numberOfReadings;
+	varianceOfMeans = getCompensatedSum(&window->sumOfSquaredShiftedMeans) / numberOfReadings - meanOfShiftedMeans * meanOfShiftedMeans;
+
+	statistics->numberOfReadings = window->numberOfReadings;
+	statistics->mean = window->shift + meanOfShiftedMeans;
+	statistics->variance = fmax(getCompensatedSum(&window->sumOfVariances) / numberOfReadings, 0.0) + fmax(varianceOfMeans, 0.0);
+	statistics->probabilityAboveThreshold = fmin(fmax(getCompensatedSum(&window->sumOfProbabilities) / numberOfReadings, 0.0), 1.0);
+
+	return;
+}
+
+void
+destroySlidingWindow(SlidingWindow *  window)
+{
+	free(window);
+
+	return;
+}
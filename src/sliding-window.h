@@ -0,0 +1,90 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+
+/*
+ *	Largest number of readings in a window, bounding the memory of the ring
+ *	buffer to 24 bytes per reading.
+ */
+typedef enum
+{
+	kSlidingWindowConstantMaxWindowSize	= 1 << 24,
+} SlidingWindowConstant;
+
+/*
+ *	The summary of the output distribution of one reading.
+ */
+typedef struct
+{
+	double	mean;
+	double	variance;
+	double	probabilityAboveThreshold;
+} ReadingSummary;
+
+/*
+ *	The statistics of the last `numberOfReadings` readings, which is the window
+ *	size once as many readings were added. They are those of the mixture of the
+ *	output distributions of the readings, with equal weights, i.e., of the
+ *	current at a time drawn uniformly from the window: the mean and the tail
+ *	probability are the averages over the readings, and the variance is the
+ *	average variance of the readings plus the variance of their means.
+ */
+typedef struct
+{
+	size_t	numberOfReadings;
+	double	mean;
+	double	variance;
+	double	probabilityAboveThreshold;
+} WindowStatistics;
+
+typedef struct SlidingWindow	SlidingWindow;
+
+/**
+ *	@brief	Create an empty sliding window.
+ *
+ *	@param	windowSize	: The number of readings in a full window, in [1, `kSlidingWindowConstantMaxWindowSize`].
+ *	@param	window		: Set to the window on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createSlidingWindow(size_t windowSize, SlidingWindow **  window);
+
+/**
+ *	@brief	Add a reading to the window, evicting the oldest one once the window is full,
+ *		and get the statistics of the window. Takes constant time, whatever the window size.
+ *
+ *	@param	window		: The window.
+ *	@param	reading		: The summary of the new reading.
+ *	@param	statistics	: Where to write the statistics of the window.
+ */
+void	updateSlidingWindow(SlidingWindow *  window, const ReadingSummary *  reading, WindowStatistics *  statistics);
+
+/**
+ *	@brief	Release the window.
+ *
+ *	@param	window	: The window. May be `NULL`.
+ */
+void	destroySlidingWindow(SlidingWindow *  window);
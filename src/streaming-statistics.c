@@ -0,0 +1,492 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "streaming-statistics.h"
+
+/*
+ *	Floor of `index` / 2^shift, for negative indices too.
+ */
+static int64_t
+coarsenBinIndex(int64_t index, int shift)
+{
+	return (index >= 0) ? (index >> shift) : -((-index - 1) >> shift) - 1;
+}
+
+static int64_t
+getLatticeBin(double sample, int binExponent)
+{
+	return (int64_t)floor(ldexp(sample, -binExponent));
+}
+
+/*
+ *	The smallest bin exponent for which [minimum, maximum] fits in the bins. It is also
+ *	large enough for the lattice bins of the samples to be exact in an `int64_t`, and it
+ *	only depends on the range, so it only grows as samples are added.
+ */
+static int
+getRequiredBinExponent(double minimum, double maximum)
+{
+	double	largestMagnitude = fmax(fabs(minimum), fabs(maximum));
+	int	binExponent = kStreamingStatisticsConstantMinBinExponent;
+
+	if (largestMagnitude > 0)
+	{
+		binExponent = (ilogb(largestMagnitude) - 52 > binExponent) ? ilogb(largestMagnitude) - 52 : binExponent;
+	}
+
+	/*
+	 *	Below 2^(ilogb(maximum - minimum) - 12), the range spans more than 2^13 bins.
+	 */
+	if (maximum > minimum)
+	{
+		binExponent = (ilogb(maximum - minimum) - 12 > binExponent) ? ilogb(maximum - minimum) - 12 : binExponent;
+	}
+	while (getLatticeBin(maximum, binExponent) - getLatticeBin(minimum, binExponent) >= kStreamingStatisticsConstantNumberOfBins)
+	{
+		binExponent++;
+	}
+
+	return binExponent;
+}
+
+/*
+ *	Move the counts of a histogram to the bins of width 2^binExponent (no finer than its
+ *	own) that start at the bin of its minimum.
+ */
+static void
+rebinStreamingHistogram(StreamingHistogram *  histogram, int binExponent)
+{
+	uint64_t	binCounts[kStreamingStatisticsConstantNumberOfBins] = {0};
+	int		shift = binExponent - histogram->binExponent;
+	int64_t		firstBin = getLatticeBin(histogram->minimum, binExponent);
+
+	if ((shift == 0) && (firstBin == histogram->firstBin))
+	{
+		return;
+	}
+
+	for (size_t j = 0; j < kStreamingStatisticsConstantNumberOfBins; j++)
+	{
+		if (histogram->binCounts[j] != 0)
+		{
+			binCounts[coarsenBinIndex(histogram->firstBin + (int64_t)j, shift) - firstBin] += histogram->binCounts[j];
+		}
+	}
+
+	memcpy(histogram->binCounts, binCounts, sizeof(binCounts));
+	histogram->binExponent = binExponent;
+	histogram->firstBin = firstBin;
+
+	return;
+}
+
+size_t
+getStreamingHistogramBin(const StreamingHistogram *  histogram, double sample)
+{
+	return (size_t)(getLatticeBin(sample, histogram->binExponent) - histogram->firstBin);
+}
+
+/*
+ *	The bin counts are only cleared with the first sample, so that streams that stay
+ *	empty (e.g., the slices of more threads than chunks) cost little.
+ */
+void
+initializeStreamingHistogram(StreamingHistogram *  histogram)
+{
+	histogram->count = 0;
+	histogram->firstBin = 0;
+	histogram->minimum = INFINITY;
+	histogram->maximum = -INFINITY;
+	histogram->binExponent = kStreamingStatisticsConstantMinBinExponent;
+
+	return;
+}
+
+/*
+ *	The range of the histogram is extended once for the whole block, so that it is
+ *	rebinned at most once per block.
+ */
+void
+updateStreamingHistogramBlock(StreamingHistogram *  histogram, const double *  samples, size_t count)
+{
+	double	blockMinimum = INFINITY;
+	double	blockMaximum = -INFINITY;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (isfinite(samples[i]))
+		{
+			blockMinimum = fmin(blockMinimum, samples[i]);
+			blockMaximum = fmax(blockMaximum, samples[i]);
+		}
+	}
+	if (blockMinimum > blockMaximum)
+	{
+		return;
+	}
+
+	if (histogram->count == 0)
+	{
+		memset(histogram->binCounts, 0, sizeof(histogram->binCounts));
+		histogram->minimum = blockMinimum;
+		histogram->maximum = blockMaximum;
+		histogram->binExponent = getRequiredBinExponent(blockMinimum, blockMaximum);
+		histogram->firstBin = getLatticeBin(blockMinimum, histogram->binExponent);
+	}
+	else if ((blockMinimum < histogram->minimum) || (blockMaximum > histogram->maximum))
+	{
+		histogram->minimum = fmin(blockMinimum, histogram->minimum);
+		histogram->maximum = fmax(blockMaximum, histogram->maximum);
+		rebinStreamingHistogram(histogram, getRequiredBinExponent(histogram->minimum, histogram->maximum));
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (isfinite(samples[i]))
+		{
+			histogram->binCounts[getStreamingHistogramBin(histogram, samples[i])]++;
+			histogram->count++;
+		}
+	}
+
+	return;
+}
+
+/*
+ *	Add the counts of `source` to `destination`. Neither may be empty.
+ */
+static void
+mergeStreamingHistograms(StreamingHistogram *  destination, const StreamingHistogram *  source)
+{
+	int	binExponent;
+	int	shift;
+
+	destination->minimum = fmin(destination->minimum, source->minimum);
+	destination->maximum = fmax(destination->maximum, source->maximum);
+	binExponent = getRequiredBinExponent(destination->minimum, destination->maximum);
+	rebinStreamingHistogram(destination, binExponent);
+
+	shift = binExponent - source->binExponent;
+	for (size_t j = 0; j < kStreamingStatisticsConstantNumberOfBins; j++)
+	{
+		if (source->binCounts[j] != 0)
+		{
+			destination->binCounts[coarsenBinIndex(source->firstBin + (int64_t)j, shift) - destination->firstBin] += source->binCounts[j];
+		}
+	}
+	destination->count += source->count;
+
+	return;
+}
+
+/*
+ *	One pass over the bins, as the probabilities are in increasing order.
+ */
+void
+getStreamingHistogramQuantiles(
+	const StreamingHistogram *	histogram,
+	size_t				numberOfProbabilities,
+	const double *			probabilities,
+	double *			quantiles)
+{
+	double		binWidth = ldexp(1.0, histogram->binExponent);
+	uint64_t	cumulativeCount = 0;
+	size_t		i = 0;
+
+	for (size_t j = 0; (j < kStreamingStatisticsConstantNumberOfBins) && (i < numberOfProbabilities); j++)
+	{
+		uint64_t	binCount = histogram->binCounts[j];
+
+		for (; (i < numberOfProbabilities) && (binCount != 0); i++)
+		{
+			double	target = probabilities[i] * (double)histogram->count;
+			double	binLow = ldexp((double)(histogram->firstBin + (int64_t)j), histogram->binExponent);
+
+			if ((double)(cumulativeCount + binCount) < target)
+			{
+				break;
+			}
+			quantiles[i] = fmin(fmax(binLow + binWidth * (target - (double)cumulativeCount) / (double)binCount, histogram->minimum), histogram->maximum);
+		}
+		cumulativeCount += binCount;
+	}
+
+	for (; i < numberOfProbabilities; i++)
+	{
+		quantiles[i] = histogram->maximum;
+	}
+
+	return;
+}
+
+/*
+ *	Merge the moments of `right` into those of `left`, its left neighbour in the run.
+ */
+static void
+mergeStreamingMomentsNodes(StreamingMomentsNode *  left, const StreamingMomentsNode *  right)
+{
+	size_t	mergedCount = left->count + right->count;
+	double	delta = right->mean - left->mean;
+
+	left->sumOfSquaredDeviations += right->sumOfSquaredDeviations +
+		delta * delta * (double)left->count * (double)right->count / (double)mergedCount;
+	left->mean += delta * (double)right->count / (double)mergedCount;
+	left->count = mergedCount;
+	left->level++;
+
+	return;
+}
+
+/*
+ *	Append a node to a stack of nodes of consecutive chunks, merging it with its left
+ *	sibling in the merge tree, and the result with its own, for as long as they are
+ *	on top of the stack.
+ */
+static void
+pushStreamingMomentsNode(StreamingMomentsNode *  nodes, size_t *  numberOfNodes, StreamingMomentsNode node)
+{
+	while (*numberOfNodes > 0)
+	{
+		StreamingMomentsNode *	top = &nodes[*numberOfNodes - 1];
+		size_t			width = (size_t)1 << node.level;
+
+		if ((top->level != node.level) || (top->firstChunk % (2 * width) != 0) || (top->firstChunk + width != node.firstChunk))
+		{
+			break;
+		}
+
+		mergeStreamingMomentsNodes(top, &node);
+		node = *top;
+		(*numberOfNodes)--;
+	}
+
+	nodes[(*numberOfNodes)++] = node;
+
+	return;
+}
+
+void
+initializeStreamingStatistics(StreamingStatistics *  statistics, size_t firstSample)
+{
+	statistics->count = 0;
+	statistics->minimum = INFINITY;
+	statistics->maximum = -INFINITY;
+	statistics->chunk = (StreamingMomentsNode)
+	{
+		.firstChunk	= firstSample / kStreamingStatisticsConstantChunkSize,
+	};
+	statistics->numberOfNodes = 0;
+	initializeStreamingHistogram(&statistics->histogram);
+
+	return;
+}
+
+static void
+updateStreamingMoments(StreamingStatistics *  statistics, double sample)
+{
+	StreamingMomentsNode *	chunk = &statistics->chunk;
+	double			delta;
+
+	statistics->count++;
+	statistics->minimum = (sample < statistics->minimum) ? sample : statistics->minimum;
+	statistics->maximum = (sample > statistics->maximum) ? sample : statistics->maximum;
+
+	chunk->count++;
+	delta = sample - chunk->mean;
+	chunk->mean += delta / (double)chunk->count;
+	chunk->sumOfSquaredDeviations += delta * (sample - chunk->mean);
+	if (chunk->count == kStreamingStatisticsConstantChunkSize)
+	{
+		pushStreamingMomentsNode(statistics->nodes, &statistics->numberOfNodes, *chunk);
+		*chunk = (StreamingMomentsNode)
+		{
+			.firstChunk	= chunk->firstChunk + 1,
+		};
+	}
+
+	return;
+}
+
+void
+updateStreamingStatistics(StreamingStatistics *  statistics, double sample)
+{
+	updateStreamingMoments(statistics, sample);
+	updateStreamingHistogramBlock(&statistics->histogram, &sample, 1);
+
+	return;
+}
+
+void
+updateStreamingStatisticsBlock(StreamingStatistics *  statistics, const double *  samples, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		updateStreamingMoments(statistics, samples[i]);
+	}
+	updateStreamingHistogramBlock(&statistics->histogram, samples, count);
+
+	return;
+}
+
+void
+summarizeStreamingStatistics(
+	const StreamingStatistics *	statistics,
+	size_t				numberOfStreams,
+	DistributionSummary *		summary,
+	StreamingHistogram *		mergedHistogramOutput)
+{
+	StreamingMomentsNode		nodes[kStreamingStatisticsConstantMaxNodes];
+	size_t				numberOfNodes = 0;
+	StreamingHistogram		mergedHistogram;
+	const StreamingHistogram *	histogram = NULL;
+
+	*summary = (DistributionSummary)
+	{
+		.numberOfSamples	= 0,
+		.mean			= 0.0,
+		.variance		= 0.0,
+		.minimum		= INFINITY,
+		.maximum		= -INFINITY,
+	};
+
+	/*
+	 *	Only the last chunk of the run is incomplete, so pushing the nodes of the
+	 *	streams in order, and then merging the stack from the top, rebuilds the
+	 *	merge tree of the whole run.
+	 */
+	for (size_t s = 0; s < numberOfStreams; s++)
+	{
+		const StreamingStatistics *	stream = &statistics[s];
+
+		for (size_t n = 0; n < stream->numberOfNodes; n++)
+		{
+			pushStreamingMomentsNode(nodes, &numberOfNodes, stream->nodes[n]);
+		}
+		if (stream->chunk.count > 0)
+		{
+			pushStreamingMomentsNode(nodes, &numberOfNodes, stream->chunk);
+		}
+
+		summary->numberOfSamples += stream->count;
+		summary->minimum = (stream->minimum < summary->minimum) ? stream->minimum : summary->minimum;
+		summary->maximum = (stream->maximum > summary->maximum) ? stream->maximum : summary->maximum;
+
+		/*
+		 *	Only copy a histogram once there is a second one to merge into it.
+		 */
+		if (stream->histogram.count == 0)
+		{
+			continue;
+		}
+		if (histogram == NULL)
+		{
+			histogram = &stream->histogram;
+		}
+		else
+		{
+			if (histogram != &mergedHistogram)
+			{
+				mergedHistogram = *histogram;
+				histogram = &mergedHistogram;
+			}
+			mergeStreamingHistograms(&mergedHistogram, &stream->histogram);
+		}
+	}
+
+	for (; numberOfNodes > 1; numberOfNodes--)
+	{
+		mergeStreamingMomentsNodes(&nodes[numberOfNodes - 2], &nodes[numberOfNodes - 1]);
+	}
+
+	if (mergedHistogramOutput != NULL)
+	{
+		if (histogram != NULL)
+		{
+			*mergedHistogramOutput = *histogram;
+		}
+		else
+		{
+			initializeStreamingHistogram(mergedHistogramOutput);
+		}
+	}
+
+	if (summary->numberOfSamples == 0)
+	{
+		for (size_t i = 0; i < kDistributionSummaryConstantNumberOfQuantiles; i++)
+		{
+			summary->quantiles[i] = NAN;
+		}
+
+		return;
+	}
+
+	summary->mean = nodes[0].mean;
+	summary->variance = (summary->numberOfSamples > 1) ? nodes[0].sumOfSquaredDeviations / (double)(summary->numberOfSamples - 1) : 0.0;
+	for (size_t i = 0; i < kDistributionSummaryConstantNumberOfQuantiles; i++)
+	{
+		summary->quantiles[i] = NAN;
+	}
+	if (histogram != NULL)
+	{
+		getStreamingHistogramQuantiles(histogram, kDistributionSummaryConstantNumberOfQuantiles, kDistributionSummaryQuantileProbabilities, summary->quantiles);
+	}
+
+	return;
+}
+
+double
+getStreamingHistogramCDF(const void *  distribution, double x)
+{
+	const StreamingHistogram *	histogram = distribution;
+	size_t				bin;
+	uint64_t			countBelowBin = 0;
+	double				binLow;
+	double				probability;
+
+	if (histogram->count == 0)
+	{
+		return NAN;
+	}
+	if (x < histogram->minimum)
+	{
+		return 0.0;
+	}
+	if (x >= histogram->maximum)
+	{
+		return 1.0;
+	}
+
+	/*
+	 *	Within [minimum, maximum), `x` falls in one of the bins of the histogram.
+	 */
+	bin = getStreamingHistogramBin(histogram, x);
+	for (size_t j = 0; j < bin; j++)
+	{
+		countBelowBin += histogram->binCounts[j];
+	}
+	binLow = ldexp((double)(histogram->firstBin + (int64_t)bin), histogram->binExponent);
+	probability = ((double)countBelowBin + (double)histogram->binCounts[bin] * ldexp(x - binLow, -histogram->binExponent)) / (double)histogram->count;
+
+	return fmin(probability, 1.0);
+}
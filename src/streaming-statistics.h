@@ -0,0 +1,187 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "distribution-summary.h"
+
+/*
+ *	The samples of a run are summarized in chunks of `kStreamingStatisticsConstantChunkSize`
+ *	consecutive samples. The moments of the chunks are merged in a fixed pairwise tree
+ *	over the chunk indices, and the quantiles come from a histogram whose bins lie on a
+ *	fixed lattice, so the summary of a run does not depend on how its samples are split
+ *	between streams, as long as each stream starts at a chunk boundary.
+ *
+ *	The histogram has `kStreamingStatisticsConstantNumberOfBins` bins of width 2^e, where
+ *	e is the smallest exponent, no less than `kStreamingStatisticsConstantMinBinExponent`,
+ *	for which the range of the samples fits in the bins. Bin `i` covers [i * 2^e, (i + 1) * 2^e),
+ *	so two histograms are merged exactly, by coarsening the finer one and summing counts.
+ *	The compact representations of `-J` (`compact-distribution.h`) are built on the same
+ *	histogram, so that they agree with the summary of `-n` for the same samples.
+ */
+typedef enum
+{
+	kStreamingStatisticsConstantChunkSize		= 512,
+	kStreamingStatisticsConstantMaxNodes		= 128,
+	kStreamingStatisticsConstantNumberOfBins	= 4096,
+	kStreamingStatisticsConstantMinBinExponent	= -64,
+} StreamingStatisticsConstant;
+
+/*
+ *	Moments of the samples of a node of the merge tree: the chunks
+ *	[firstChunk, firstChunk + 2^level) of the run, or fewer at the end of the run.
+ */
+typedef struct
+{
+	size_t	firstChunk;
+	size_t	level;
+	size_t	count;
+	double	mean;
+	double	sumOfSquaredDeviations;
+} StreamingMomentsNode;
+
+/*
+ *	A histogram on the lattice of bins of width 2^binExponent. Only finite samples
+ *	are counted. `binCounts[j]` holds the count of lattice bin `firstBin + j`.
+ */
+typedef struct
+{
+	size_t		count;
+	double		minimum;
+	double		maximum;
+	int		binExponent;
+	int64_t		firstBin;
+	uint64_t	binCounts[kStreamingStatisticsConstantNumberOfBins];
+} StreamingHistogram;
+
+/*
+ *	Online statistics of a stream of samples: the moments of its complete chunks,
+ *	as the nodes of the merge tree they complete so far, those of the chunk being
+ *	filled, the extrema, and the histogram.
+ */
+typedef struct
+{
+	size_t			count;
+	double			minimum;
+	double			maximum;
+	StreamingMomentsNode	chunk;
+	size_t			numberOfNodes;
+	StreamingMomentsNode	nodes[kStreamingStatisticsConstantMaxNodes];
+	StreamingHistogram	histogram;
+} StreamingStatistics;
+
+/**
+ *	@brief	Reset a histogram to the empty one.
+ *
+ *	@param	histogram	: The histogram to reset.
+ */
+void	initializeStreamingHistogram(StreamingHistogram *  histogram);
+
+/**
+ *	@brief	Add a block of samples to a histogram. Samples that are not finite are skipped.
+ *
+ *	@param	histogram	: The histogram to update.
+ *	@param	samples		: The new samples.
+ *	@param	count		: The number of samples.
+ */
+void	updateStreamingHistogramBlock(StreamingHistogram *  histogram, const double *  samples, size_t count);
+
+/**
+ *	@brief	The index, in `binCounts`, of the bin of a sample.
+ *
+ *	@param	histogram	: The histogram.
+ *	@param	sample		: A finite sample in [minimum, maximum] of the histogram.
+ *	@return			: The index of the bin that holds `sample`.
+ */
+size_t	getStreamingHistogramBin(const StreamingHistogram *  histogram, double sample);
+
+/**
+ *	@brief	Quantiles of the samples of a non-empty histogram, interpolating linearly
+ *		within the bin that holds each, and clamped to [minimum, maximum].
+ *
+ *	@param	histogram		: The histogram.
+ *	@param	numberOfProbabilities	: The number of quantiles.
+ *	@param	probabilities		: The probabilities of the quantiles, in increasing order.
+ *	@param	quantiles		: Where to write the quantiles.
+ */
+void	getStreamingHistogramQuantiles(
+		const StreamingHistogram *	histogram,
+		size_t				numberOfProbabilities,
+		const double *			probabilities,
+		double *			quantiles);
+
+/**
+ *	@brief	Reset streaming statistics to the empty stream.
+ *
+ *	@param	statistics	: The statistics to reset.
+ *	@param	firstSample	: The index, in the run, of the first sample of the stream.
+ *				  Must be a multiple of `kStreamingStatisticsConstantChunkSize`.
+ */
+void	initializeStreamingStatistics(StreamingStatistics *  statistics, size_t firstSample);
+
+/**
+ *	@brief	Add one sample to streaming statistics.
+ *
+ *	@param	statistics	: The statistics to update.
+ *	@param	sample		: The new sample.
+ */
+void	updateStreamingStatistics(StreamingStatistics *  statistics, double sample);
+
+/**
+ *	@brief	Add a block of samples to streaming statistics.
+ *
+ *	@param	statistics	: The statistics to update.
+ *	@param	samples		: The new samples.
+ *	@param	count		: The number of samples.
+ */
+void	updateStreamingStatisticsBlock(StreamingStatistics *  statistics, const double *  samples, size_t count);
+
+/**
+ *	@brief	Summarize the statistics of the consecutive streams of samples of a run.
+ *		Moments and extrema are merged exactly (Chan et al.) over the merge tree of
+ *		the chunks, and the quantiles are interpolated within the bins of the merged
+ *		histogram, so the summary only depends on the samples of the run and their order.
+ *
+ *	@param	statistics		: The statistics of each stream, in the order of their samples in the run.
+ *	@param	numberOfStreams		: The number of streams.
+ *	@param	summary			: Where to write the summary.
+ *	@param	histogram		: Where to write the merged histogram of the run, for
+ *					  `getStreamingHistogramCDF()`. May be `NULL`.
+ */
+void	summarizeStreamingStatistics(
+		const StreamingStatistics *	statistics,
+		size_t				numberOfStreams,
+		DistributionSummary *		summary,
+		StreamingHistogram *		histogram);
+
+/**
+ *	@brief	The cumulative distribution function, P(X <= x), of the samples of a
+ *		histogram, interpolating linearly within the bin that holds `x`. Its
+ *		signature is that of a `CumulativeDistributionFunction`.
+ *
+ *	@param	histogram	: The `StreamingHistogram`.
+ *	@param	x		: Where to evaluate the CDF.
+ *	@return			: P(X <= x), or NaN if the histogram is empty.
+ */
+double	getStreamingHistogramCDF(const void *  histogram, double x);
@@ -0,0 +1,228 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(ENABLE_NATIVE_POSIX)
+#include <pthread.h>
+#endif
+#include "thread-pool.h"
+
+typedef struct ThreadPoolWorker
+{
+	ThreadPool *	pool;
+	size_t		workerIndex;
+} ThreadPoolWorker;
+
+struct ThreadPool
+{
+	size_t			numberOfThreads;
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_t *		threads;
+	ThreadPoolWorker *	workers;
+	size_t			numberOfStartedThreads;
+	pthread_mutex_t		mutex;
+	pthread_cond_t		workAvailable;
+	pthread_cond_t		workDone;
+
+	/*
+	 *	The current batch of tasks. `generation` is bumped for each batch so
+	 *	that the workers can tell a new batch from the one they just ran.
+	 */
+	ThreadPoolTask		task;
+	void *			context;
+	size_t			numberOfTasks;
+	size_t			generation;
+	size_t			numberOfBusyWorkers;
+	bool			isStopping;
+#endif
+};
+
+#if defined(ENABLE_NATIVE_POSIX)
+static void *
+threadPoolWorkerMain(void *  argument)
+{
+	ThreadPoolWorker *	worker = argument;
+	ThreadPool *		pool = worker->pool;
+	size_t			seenGeneration = 0;
+
+	for (;;)
+	{
+		ThreadPoolTask	task;
+		void *		context;
+		size_t		numberOfTasks;
+
+		pthread_mutex_lock(&pool->mutex);
+		while ((pool->generation == seenGeneration) && !pool->isStopping)
+		{
+			pthread_cond_wait(&pool->workAvailable, &pool->mutex);
+		}
+		if (pool->isStopping)
+		{
+			pthread_mutex_unlock(&pool->mutex);
+			break;
+		}
+		seenGeneration = pool->generation;
+		task = pool->task;
+		context = pool->context;
+		numberOfTasks = pool->numberOfTasks;
+		pthread_mutex_unlock(&pool->mutex);
+
+		for (size_t i = worker->workerIndex; i < numberOfTasks; i += pool->numberOfThreads)
+		{
+			task(i, context);
+		}
+
+		pthread_mutex_lock(&pool->mutex);
+		pool->numberOfBusyWorkers--;
+		if (pool->numberOfBusyWorkers == 0)
+		{
+			pthread_cond_signal(&pool->workDone);
+		}
+		pthread_mutex_unlock(&pool->mutex);
+	}
+
+	return NULL;
+}
+#endif
+
+CommonConstantReturnType
+createThreadPool(size_t numberOfThreads, ThreadPool **  pool)
+{
+	ThreadPool *	newPool;
+
+	if ((numberOfThreads == 0) || (numberOfThreads > kThreadPoolConstantMaxThreads))
+	{
+		fprintf(stderr, "Error: Number of threads should be in [1, %d]: Provided %zu.\n", kThreadPoolConstantMaxThreads, numberOfThreads);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	newPool = calloc(1, sizeof(ThreadPool));
+	if (newPool == NULL)
+	{
+		fprintf(stderr, "Error: Could not allocate thread pool.\n");
+
+		return kCommonConstantReturnTypeError;
+	}
+	newPool->numberOfThreads = numberOfThreads;
+
+#if defined(ENABLE_NATIVE_POSIX)
+	newPool->threads = calloc(numberOfThreads, sizeof(pthread_t));
+	newPool->workers = calloc(numberOfThreads, sizeof(ThreadPoolWorker));
+	if ((newPool->threads == NULL) || (newPool->workers == NULL))
+	{
+		fprintf(stderr, "Error: Could not allocate thread pool.\n");
+		free(newPool->threads);
+		free(newPool->workers);
+		free(newPool);
+
+		return kCommonConstantReturnTypeError;
+	}
+
+	pthread_mutex_init(&newPool->mutex, NULL);
+	pthread_cond_init(&newPool->workAvailable, NULL);
+	pthread_cond_init(&newPool->workDone, NULL);
+
+	for (size_t i = 0; i < numberOfThreads; i++)
+	{
+		newPool->workers[i] = (ThreadPoolWorker){ .pool = newPool, .workerIndex = i };
+		if (pthread_create(&newPool->threads[i], NULL, threadPoolWorkerMain, &newPool->workers[i]) != 0)
+		{
+			fprintf(stderr, "Error: Could not start thread pool worker %zu.\n", i);
+			destroyThreadPool(newPool);
+
+			return kCommonConstantReturnTypeError;
+		}
+		newPool->numberOfStartedThreads++;
+	}
+#endif
+
+	*pool = newPool;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
+void
+runThreadPoolTasks(ThreadPool *  pool, ThreadPoolTask task, void *  context, size_t numberOfTasks)
+{
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->context = context;
+	pool->numberOfTasks = numberOfTasks;
+	pool->numberOfBusyWorkers = pool->numberOfThreads;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->workAvailable);
+	while (pool->numberOfBusyWorkers > 0)
+	{
+		pthread_cond_wait(&pool->workDone, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+#else
+	(void)pool;
+
+	for (size_t i = 0; i < numberOfTasks; i++)
+	{
+		task(i, context);
+	}
+#endif
+
+	return;
+}
+
+size_t
+getThreadPoolSize(const ThreadPool *  pool)
+{
+	return pool->numberOfThreads;
+}
+
+void
+destroyThreadPool(ThreadPool *  pool)
+{
+	if (pool == NULL)
+	{
+		return;
+	}
+
+#if defined(ENABLE_NATIVE_POSIX)
+	pthread_mutex_lock(&pool->mutex);
+	pool->isStopping = true;
+	pthread_cond_broadcast(&pool->workAvailable);
+	pthread_mutex_unlock(&pool->mutex);
+
+	for (size_t i = 0; i < pool->numberOfStartedThreads; i++)
+	{
+		pthread_join(pool->threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&pool->workDone);
+	pthread_cond_destroy(&pool->workAvailable);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->threads);
+	free(pool->workers);
+#endif
+	free(pool);
+
+	return;
+}
@@ -0,0 +1,78 @@
+/*
+ *	Copyright (c) 2024, Signaloid.
+ *
+ *	Permission is hereby granted, free of charge, to any person obtaining a copy
+ *	of this software and associated documentation files (the "Software"), to deal
+ *	in the Software without restriction, including without limitation the rights
+ *	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *	copies of the Software, and to permit persons to whom the Software is
+ *	furnished to do so, subject to the following conditions:
+ *
+ *	The above copyright notice and this permission notice shall be included in all
+ *	copies or substantial portions of the Software.
+ *
+ *	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *	SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "common.h"
+
+typedef enum
+{
+	kThreadPoolConstantMaxThreads	= 1024,
+} ThreadPoolConstant;
+
+/*
+ *	A task receives the index of the task being run (in [0, numberOfTasks))
+ *	and the context pointer passed to `runThreadPoolTasks()`.
+ */
+typedef void	(*ThreadPoolTask)(size_t taskIndex, void *  context);
+
+typedef struct ThreadPool	ThreadPool;
+
+/**
+ *	@brief	Create a pool of worker threads. The workers are kept alive between
+ *		calls to `runThreadPoolTasks()`. Without `ENABLE_NATIVE_POSIX`, the pool
+ *		runs every task on the calling thread.
+ *
+ *	@param	numberOfThreads	: Number of worker threads, in [1, kThreadPoolConstantMaxThreads].
+ *	@param	pool		: Set to the created pool on success.
+ *	@return			: `kCommonConstantReturnTypeSuccess` if successful,
+ *				   else `kCommonConstantReturnTypeError`.
+ */
+CommonConstantReturnType	createThreadPool(size_t numberOfThreads, ThreadPool **  pool);
+
+/**
+ *	@brief	Run `numberOfTasks` tasks on the pool and wait for all of them to finish.
+ *		Task `i` is always run by worker `i % numberOfThreads`, so a task may keep
+ *		per-worker state indexed by the task index.
+ *
+ *	@param	pool		: The thread pool.
+ *	@param	task		: The function to run for each task.
+ *	@param	context		: Passed unchanged to every task.
+ *	@param	numberOfTasks	: The number of tasks.
+ */
+void	runThreadPoolTasks(ThreadPool *  pool, ThreadPoolTask task, void *  context, size_t numberOfTasks);
+
+/**
+ *	@brief	Get the number of worker threads of a pool.
+ *
+ *	@param	pool		: The thread pool.
+ *	@return			: The number of worker threads.
+ */
+size_t	getThreadPoolSize(const ThreadPool *  pool);
+
+/**
+ *	@brief	Stop the worker threads and release the pool.
+ *
+ *	@param	pool		: The thread pool. May be `NULL`.
+ */
+void	destroyThreadPool(ThreadPool *  pool);
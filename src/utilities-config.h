@@ -20,6 +20,8 @@
  *	SOFTWARE.
  */
 
+#pragma once
+
 /*
  *	We use the specific parameters for the TMCS1123x3A, taken from Table 6.6
  *	in page 7 of TMCS1123 Datasheet, 2024-07-04.
@@ -31,15 +33,52 @@
 #define kDefaultInputDistributionVrefUniformDistLow		(2.4)
 #define kDefaultInputDistributionVrefUniformDistHigh		(2.6)
 
+/*
+ *	Limits of the error terms of the extended error model (`-e` option), after
+ *	the electrical characteristics in Table 6.6 of the TMCS1123 Datasheet,
+ *	2024-07-04, each modeled, like Vout and Vref, as uniform between its limits:
+ *		SensitivityError	: Relative error of the sensitivity at 25 °C.
+ *		SensitivityDrift	: Relative drift of the sensitivity (per °C).
+ *		OffsetError		: Offset of Vout - Vref at 25 °C (in Volt).
+ *		OffsetDrift		: Drift of the offset (in Volt per °C).
+ *		Nonlinearity		: Largest deviation from a straight line, relative to the full-scale current.
+ */
+#define kSensorErrorModelSensitivityErrorLimit			(0.004)
+#define kSensorErrorModelSensitivityDriftLimit			(40e-6)
+#define kSensorErrorModelOffsetErrorLimit			(0.8e-3)
+#define kSensorErrorModelOffsetDriftLimit			(10e-6)
+#define kSensorErrorModelNonlinearityLimit			(0.0005)
+#define kSensorErrorModelReferenceTemperature			(25.0)
+
+/*
+ *	Seed of the random streams of the parallel Monte Carlo engine (`-t` option),
+ *	unless one is given with the `-s` option.
+ */
+#define kDefaultMonteCarloSeed					(0x5EED0112ULL)
+
 /*
  *	Input Distributions:
- *		kInputDistributionIndexVout	: Analog Output Voltage (in Volt)
- *		kInputDistributionIndexVref	: Zero Current Reference Output Voltage(in Volt)
+ *		kInputDistributionIndexVout			: Analog Output Voltage (in Volt)
+ *		kInputDistributionIndexVref			: Zero Current Reference Output Voltage(in Volt)
+ *
+ *	and, with the extended error model (`-e` option):
+ *		kInputDistributionIndexSensitivityError		: Relative Sensitivity Error
+ *		kInputDistributionIndexOffsetError		: Offset Error (in Volt)
+ *		kInputDistributionIndexTemperature		: Ambient Temperature (in °C)
+ *		kInputDistributionIndexSensitivityDrift		: Relative Sensitivity Drift (per °C)
+ *		kInputDistributionIndexOffsetDrift		: Offset Drift (in Volt per °C)
+ *		kInputDistributionIndexNonlinearity		: Nonlinearity, relative to the full-scale current
  */
 typedef enum
 {
-	kInputDistributionIndexVout	= 0,
-	kInputDistributionIndexVref	= 1,
+	kInputDistributionIndexVout			= 0,
+	kInputDistributionIndexVref			= 1,
+	kInputDistributionIndexSensitivityError		= 2,
+	kInputDistributionIndexOffsetError		= 3,
+	kInputDistributionIndexTemperature		= 4,
+	kInputDistributionIndexSensitivityDrift		= 5,
+	kInputDistributionIndexOffsetDrift		= 6,
+	kInputDistributionIndexNonlinearity		= 7,
 	kInputDistributionIndexMax,
 } InputDistributionIndex;
 
@@ -52,3 +91,32 @@ typedef enum
 	kOutputDistributionIndexCalibratedCurrent	= 0,
 	kOutputDistributionIndexMax,
 } OutputDistributionIndex;
+
+/*
+ *	Demo-specific command-line options, indexing the `DemoOption` array in `getCommandLineArguments()`.
+ */
+typedef enum
+{
+	kDemoSpecificOptionIndexInputFormat	= 0,
+	kDemoSpecificOptionIndexThreads,
+	kDemoSpecificOptionIndexSeed,
+	kDemoSpecificOptionIndexKernel,
+	kDemoSpecificOptionIndexNoDataDotOut,
+	kDemoSpecificOptionIndexAnalytic,
+	kDemoSpecificOptionIndexQueryThresholds,
+	kDemoSpecificOptionIndexQueryQuantiles,
+	kDemoSpecificOptionIndexQueryFile,
+	kDemoSpecificOptionIndexBinaryDataOut,
+	kDemoSpecificOptionIndexJSONCompact,
+	kDemoSpecificOptionIndexDevice,
+	kDemoSpecificOptionIndexSamplingMethod,
+	kDemoSpecificOptionIndexTargetWidth,
+	kDemoSpecificOptionIndexRandomGenerator,
+	kDemoSpecificOptionIndexServe,
+	kDemoSpecificOptionIndexResultCache,
+	kDemoSpecificOptionIndexAdc,
+	kDemoSpecificOptionIndexOvercurrent,
+	kDemoSpecificOptionIndexSlidingWindow,
+	kDemoSpecificOptionIndexErrorModel,
+	kDemoSpecificOptionIndexMax,
+} DemoSpecificOptionIndex;
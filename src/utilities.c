@@ -20,11 +20,20 @@
  *	SOFTWARE.
  */
 
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <uxhw.h>
 #include "utilities.h"
+#include "thread-pool.h"
+
+/*
+ *	The relative deviations from the mean, in %, of the probabilities printed for the output.
+ */
+static const int	kCalibratedValuePercentages[kCalibratedValueConstantNumberOfPercentages] = {1, 5, 10, 15};
 
 void
 printUsage(void)
@@ -34,18 +43,66 @@ printUsage(void)
 	fprintf(stderr, "Usage: Valid command-line arguments are:\n");
 	fprintf(
 		stderr,
+		"\t[-i, --input <Path to input record file : str>] (Convert every record of a CSV or binary file of Vout/Vref readings.)\n"
+		"\t[-f, --input-format <csv|binary>] (Format of the input record file. By default, inferred from the file extension.)\n"
+		"\t[-A, --adc <resolution : int>,<reference voltage : double>] (Read the input file as raw `VoutCode,VrefCode` readings of an ADC with this resolution, in bits, and reference voltage, uncertain by +/-1/2 LSB, and convert each by looking up the exact output distribution of its codes in a precomputed table. Requires -i, and no -M.)\n"
+		"\t[-O, --overcurrent <threshold : double>,<level : double>] (Decide, for each record of the input file, whether P(output > threshold) is above the level, sampling each record only until the decision is settled at 99.9%% confidence, or -M times at most (by default, 65536). Writes an event whenever the decision changes. Requires -i.)\n"
+		"\t[-W, --window <readings : int>,<threshold : double>] (Track the records of the input file as a time series: for each record, write the mean, variance and P(output > threshold) of the current over the last `readings` records, updated in constant time per record. Each record is summarized exactly, or from -M samples, if given. Requires -i.)\n"
 		"\t[-o, --output <Path to output CSV file : str>] (Specify the output file.)\n"
 		"\t[-S, --select-output <output : int>] (Compute 0-indexed output, by default 0.)\n"
+		"\t[-d, --device <TMCS1123x1A ... TMCS1123x5A>] (Sensor variant whose sensitivity converts the readings: the 5 V TMCS1123 parts only. By default, TMCS1123x3A.)\n"
+		"\t[-e, --error-model <lowest temperature : double>,<highest temperature : double>] (Convert the default inputs under the extended datasheet error model: sensitivity error and drift, offset error and drift, and nonlinearity, as extra uniform inputs, at an ambient temperature uniform between the two, in °C.)\n"
 		"\t[-M, --multiple-executions <Number of executions : int (Default: 1)>] (Repeated execute kernel for benchmarking.)\n"
-		"\t[-T, --time] (Timing mode: Times and prints the timing of the kernel execution.)\n"
+		"\t[-u, --serve <Path to socket : str>] (Serve conversion requests on a Unix domain socket until interrupted, with the threads of -t and the kernels of -k.)\n"
+		"\t[-t, --threads <Number of threads : int>] (Run the Monte Carlo iterations on a pool of threads, each with its own random stream. Requires -M or -u.)\n"
+		"\t[-s, --seed <Seed : int (Default: 0x5EED0112)>] (Seed of the random streams used with -t and -O. Results are reproducible for a given seed and number of threads.)\n"
+		"\t[-r, --rng <xoshiro|philox>] (Pseudo-random generator used with -t: per-thread xoshiro256** streams, or the counter-based Philox4x32-10, whose samples do not depend on the number of threads. By default, xoshiro.)\n"
+		"\t[-m, --sampling <random|sobol|lhs>] (Sample the inputs used with -t pseudo-randomly, from a scrambled Sobol sequence, or by Latin hypercube sampling. By default, pseudo-randomly.)\n"
+		"\t[-k, --kernel <auto|scalar|avx2|avx512>] (Instruction set of the batched sampling and conversion kernels used with -t, -u and -O. By default, the widest one the CPU supports.)\n"
+		"\t[-w, --target-width <width : double>[,<probability width : double>]] (Stop the Monte Carlo iterations once the 95%% confidence intervals of the mean and of the -p quantiles are narrower than `width`, and those of the -q probabilities narrower than `probability width`, if given. -M is then the maximum number of iterations.)\n"
+		"\t[-n, --no-data-out] (Do not write the Monte Carlo samples to `data.out`. Without -j, the samples are summarized online and never stored.)\n"
+		"\t[-C, --cache <entries : int>[,<Path to cache file : str>]] (Reuse the summaries of evaluations of the same inputs, keeping the most recently used `entries`, and load them from and save them to the cache file, if given. Applies to -M with -n, -i with -M, and -u.)\n"
+		"\t[-B, --binary-data-out] (Write the Monte Carlo samples to the binary file `data.bin` instead of the text file `data.out`.)\n"
+		"\t[-a, --analytic] (Evaluate the exact, closed-form, output distribution of the default inputs instead of sampling it.)\n"
+		"\t[-q, --query-thresholds <x1,x2,... : double list>] (Print P(output <= x) and P(output > x) for each threshold. Requires -M without -n, or -a.)\n"
+		"\t[-p, --query-quantiles <p1,p2,... : double list>] (Print the output quantile at each probability. Requires -M without -n, or -a.)\n"
+		"\t[-Q, --query-file <Path to query file : str>] (Read queries, one `le <x>`, `gt <x>` or `quantile <p>` per line.)\n"
+		"\t[-T, --time] (Timing mode: Times and prints the timing of the kernel execution, with the wall-clock time of each phase, as JSON with -j.)\n"
 		"\t[-b, --benchmarking] (Benchmarking mode: Generate outputs in format for benchmarking.)\n"
 		"\t[-j, --json] (Print output in JSON format.)\n"
+		"\t[-J, --json-compact <histogram|quantiles|particles>[:<size : int (Default: 64)>]] (With -j and -M, print a fixed-size histogram, quantile set or set of weighted particles instead of every sample.)\n"
 		"\t[-h, --help] (Display this help message.)\n");
 	fprintf(stderr, "\n");
 
 	return;
 }
 
+/*
+ *	Parses a non-negative integer argument, in decimal or (with a `0x` prefix) hexadecimal.
+ */
+static CommonConstantReturnType
+parseUnsignedIntegerArgument(const char *  argument, uint64_t *  value)
+{
+	char *			end;
+	unsigned long long	parsedValue;
+
+	if ((argument == NULL) || (*argument == '\0') || (*argument == '-'))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	errno = 0;
+	parsedValue = strtoull(argument, &end, 0);
+	if ((*end != '\0') || (errno == ERANGE))
+	{
+		return kCommonConstantReturnTypeError;
+	}
+
+	*value = (uint64_t)parsedValue;
+
+	return kCommonConstantReturnTypeSuccess;
+}
+
 static void
 setDefaultCommandLineArguments(CommandLineArguments *  arguments)
 {
@@ -63,7 +120,34 @@ setDefaultCommandLineArguments(CommandLineArguments *  arguments)
 
 	*arguments = (CommandLineArguments)
 	{
-		.common = (CommonCommandLineArguments) {0}
+		.common = (CommonCommandLineArguments) {0},
+		.inputFormat = kRecordStreamFormatAutomatic,
+		.numberOfThreads = 0,
+		.seed = kDefaultMonteCarloSeed,
+		.conversionKernelIsa = kConversionKernelIsaAutomatic,
+		.isDataDotOutEnabled = true,
+		.isBinaryDataOutEnabled = false,
+		.isStreamingStatisticsMode = false,
+		.isAnalyticMode = false,
+		.queries = (SampleQueryList) {0},
+		.compactRepresentation = kCompactRepresentationNone,
+		.compactRepresentationSize = kCompactDistributionConstantDefaultSize,
+		.sensorVariant = &kSensorVariants[kSensorVariantIndexTMCS1123x3A],
+		.samplingMethod = kSamplingMethodPseudoRandom,
+		.randomGenerator = kRandomGeneratorXoshiro,
+		.isAdaptiveMode = false,
+		.convergenceTarget = (ConvergenceTarget) {0},
+		.serverSocketPath = NULL,
+		.resultCacheCapacity = 0,
+		.resultCachePath = NULL,
+		.adcResolution = 0,
+		.adcReferenceVoltage = 0.0,
+		.isOvercurrentDetectionMode = false,
+		.overcurrentDetector = (OvercurrentDetectorConfiguration) {0},
+		.slidingWindowSize = 0,
+		.slidingWindowThreshold = 0.0,
+		.isErrorModelEnabled = false,
+		.errorModel = (SensorErrorModel) {0},
 	};
 #pragma GCC diagnostic pop
 
@@ -76,7 +160,33 @@ getCommandLineArguments(
 	char *			argv[],
 	CommandLineArguments *	arguments)
 {
-	DemoOption		demoSpecificOptions = {0};
+	/*
+	 *	The extra, zero-initialized, entry terminates the option list for `parseArgs()`.
+	 */
+	DemoOption		demoSpecificOptions[kDemoSpecificOptionIndexMax + 1] =
+				{
+					[kDemoSpecificOptionIndexInputFormat]	= { .opt = "f", .optAlternative = "input-format", .hasArg = true },
+					[kDemoSpecificOptionIndexThreads]	= { .opt = "t", .optAlternative = "threads", .hasArg = true },
+					[kDemoSpecificOptionIndexSeed]		= { .opt = "s", .optAlternative = "seed", .hasArg = true },
+					[kDemoSpecificOptionIndexKernel]	= { .opt = "k", .optAlternative = "kernel", .hasArg = true },
+					[kDemoSpecificOptionIndexNoDataDotOut]	= { .opt = "n", .optAlternative = "no-data-out", .hasArg = false },
+					[kDemoSpecificOptionIndexAnalytic]	= { .opt = "a", .optAlternative = "analytic", .hasArg = false },
+					[kDemoSpecificOptionIndexQueryThresholds]	= { .opt = "q", .optAlternative = "query-thresholds", .hasArg = true },
+					[kDemoSpecificOptionIndexQueryQuantiles]	= { .opt = "p", .optAlternative = "query-quantiles", .hasArg = true },
+					[kDemoSpecificOptionIndexQueryFile]	= { .opt = "Q", .optAlternative = "query-file", .hasArg = true },
+					[kDemoSpecificOptionIndexBinaryDataOut]	= { .opt = "B", .optAlternative = "binary-data-out", .hasArg = false },
+					[kDemoSpecificOptionIndexJSONCompact]	= { .opt = "J", .optAlternative = "json-compact", .hasArg = true },
+					[kDemoSpecificOptionIndexDevice]	= { .opt = "d", .optAlternative = "device", .hasArg = true },
+					[kDemoSpecificOptionIndexSamplingMethod]	= { .opt = "m", .optAlternative = "sampling", .hasArg = true },
+					[kDemoSpecificOptionIndexTargetWidth]	= { .opt = "w", .optAlternative = "target-width", .hasArg = true },
+					[kDemoSpecificOptionIndexRandomGenerator]	= { .opt = "r", .optAlternative = "rng", .hasArg = true },
+					[kDemoSpecificOptionIndexServe]	= { .opt = "u", .optAlternative = "serve", .hasArg = true },
+					[kDemoSpecificOptionIndexResultCache]	= { .opt = "C", .optAlternative = "cache", .hasArg = true },
+					[kDemoSpecificOptionIndexAdc]		= { .opt = "A", .optAlternative = "adc", .hasArg = true },
+					[kDemoSpecificOptionIndexOvercurrent]	= { .opt = "O", .optAlternative = "overcurrent", .hasArg = true },
+					[kDemoSpecificOptionIndexSlidingWindow]	= { .opt = "W", .optAlternative = "window", .hasArg = true },
+					[kDemoSpecificOptionIndexErrorModel]	= { .opt = "e", .optAlternative = "error-model", .hasArg = true },
+				};
 
 	if (arguments == NULL)
 	{
@@ -86,10 +196,7 @@ getCommandLineArguments(
 
 	setDefaultCommandLineArguments(arguments);
 
-	/*
-	 *	This application example has no application specific arguments.
-	 */
-	if (parseArgs(argc, argv, &arguments->common, &demoSpecificOptions) != 0)
+	if (parseArgs(argc, argv, &arguments->common, demoSpecificOptions) != 0)
 	{
 		fprintf(stderr, "Parsing command line arguments failed\n");
 		printUsage();
@@ -107,17 +214,600 @@ getCommandLineArguments(
 		exit(EXIT_SUCCESS);
 	}
 
-	if (arguments->common.isInputFromFileEnabled)
+	if (demoSpecificOptions[kDemoSpecificOptionIndexInputFormat].foundOpt)
 	{
-		fprintf(stderr, "Reading inputs from CSV file is not currently supported\n");
+		const char *	format = demoSpecificOptions[kDemoSpecificOptionIndexInputFormat].foundArg;
 
-		return kCommonConstantReturnTypeError;
+		if (strcmp(format, "csv") == 0)
+		{
+			arguments->inputFormat = kRecordStreamFormatCSV;
+		}
+		else if (strcmp(format, "binary") == 0)
+		{
+			arguments->inputFormat = kRecordStreamFormatBinary;
+		}
+		else
+		{
+			fprintf(stderr, "Input format (-f option) should be one of `csv` or `binary`: Provided %s.\n", format);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Input format (-f option) requires an input file (-i option).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexDevice].foundOpt)
+	{
+		arguments->sensorVariant = findSensorVariant(demoSpecificOptions[kDemoSpecificOptionIndexDevice].foundArg);
+		if (arguments->sensorVariant == NULL)
+		{
+			fprintf(stderr, "Device (-d option) should be one of");
+			for (size_t i = 0; i < kSensorVariantIndexMax; i++)
+			{
+				fprintf(stderr, "%s `%s`", (i > 0) ? "," : "", kSensorVariants[i].name);
+			}
+			fprintf(stderr, ": Provided %s.\n", demoSpecificOptions[kDemoSpecificOptionIndexDevice].foundArg);
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexServe].foundOpt)
+	{
+		if (arguments->common.isMonteCarloMode ||
+			arguments->common.isInputFromFileEnabled ||
+			demoSpecificOptions[kDemoSpecificOptionIndexAnalytic].foundOpt ||
+			demoSpecificOptions[kDemoSpecificOptionIndexSeed].foundOpt ||
+			demoSpecificOptions[kDemoSpecificOptionIndexSamplingMethod].foundOpt ||
+			demoSpecificOptions[kDemoSpecificOptionIndexRandomGenerator].foundOpt)
+		{
+			fprintf(stderr, "The server mode (-u option) takes its inputs from the requests, and can only be combined with -t and -k.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->serverSocketPath = demoSpecificOptions[kDemoSpecificOptionIndexServe].foundArg;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexThreads].foundOpt)
+	{
+		uint64_t	numberOfThreads;
+
+		if ((parseUnsignedIntegerArgument(demoSpecificOptions[kDemoSpecificOptionIndexThreads].foundArg, &numberOfThreads) != kCommonConstantReturnTypeSuccess) ||
+			(numberOfThreads == 0) ||
+			(numberOfThreads > kThreadPoolConstantMaxThreads))
+		{
+			fprintf(
+				stderr,
+				"Number of threads (-t option) should be an integer in [1, %d]: Provided %s.\n",
+				kThreadPoolConstantMaxThreads,
+				demoSpecificOptions[kDemoSpecificOptionIndexThreads].foundArg);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((!arguments->common.isMonteCarloMode && (arguments->serverSocketPath == NULL)) || arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Number of threads (-t option) requires the Monte Carlo mode (-M option) or the server mode (-u option), and no input file.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->numberOfThreads = (size_t)numberOfThreads;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexSeed].foundOpt)
+	{
+		if (parseUnsignedIntegerArgument(demoSpecificOptions[kDemoSpecificOptionIndexSeed].foundArg, &arguments->seed) != kCommonConstantReturnTypeSuccess)
+		{
+			fprintf(
+				stderr,
+				"Seed (-s option) should be a non-negative integer: Provided %s.\n",
+				demoSpecificOptions[kDemoSpecificOptionIndexSeed].foundArg);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((arguments->numberOfThreads == 0) && !demoSpecificOptions[kDemoSpecificOptionIndexOvercurrent].foundOpt)
+		{
+			fprintf(stderr, "Seed (-s option) only applies to the parallel Monte Carlo engine (-t option) and the overcurrent detector (-O option).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexKernel].foundOpt)
+	{
+		const char *	kernel = demoSpecificOptions[kDemoSpecificOptionIndexKernel].foundArg;
+
+		if (strcmp(kernel, "auto") == 0)
+		{
+			arguments->conversionKernelIsa = kConversionKernelIsaAutomatic;
+		}
+		else if (strcmp(kernel, "scalar") == 0)
+		{
+			arguments->conversionKernelIsa = kConversionKernelIsaScalar;
+		}
+		else if (strcmp(kernel, "avx2") == 0)
+		{
+			arguments->conversionKernelIsa = kConversionKernelIsaAVX2;
+		}
+		else if (strcmp(kernel, "avx512") == 0)
+		{
+			arguments->conversionKernelIsa = kConversionKernelIsaAVX512;
+		}
+		else
+		{
+			fprintf(stderr, "Kernel (-k option) should be one of `auto`, `scalar`, `avx2` or `avx512`: Provided %s.\n", kernel);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((arguments->numberOfThreads == 0) && (arguments->serverSocketPath == NULL) && !demoSpecificOptions[kDemoSpecificOptionIndexOvercurrent].foundOpt)
+		{
+			fprintf(stderr, "Kernel (-k option) only applies to the parallel Monte Carlo engine (-t option), the server mode (-u option) and the overcurrent detector (-O option).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexSamplingMethod].foundOpt)
+	{
+		const char *	method = demoSpecificOptions[kDemoSpecificOptionIndexSamplingMethod].foundArg;
+
+		if (strcmp(method, "random") == 0)
+		{
+			arguments->samplingMethod = kSamplingMethodPseudoRandom;
+		}
+		else if (strcmp(method, "sobol") == 0)
+		{
+			arguments->samplingMethod = kSamplingMethodSobol;
+		}
+		else if (strcmp(method, "lhs") == 0)
+		{
+			arguments->samplingMethod = kSamplingMethodLatinHypercube;
+		}
+		else
+		{
+			fprintf(stderr, "Sampling method (-m option) should be one of `random`, `sobol` or `lhs`: Provided %s.\n", method);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (arguments->numberOfThreads == 0)
+		{
+			fprintf(stderr, "Sampling method (-m option) only applies to the parallel Monte Carlo engine (-t option).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexRandomGenerator].foundOpt)
+	{
+		const char *	generator = demoSpecificOptions[kDemoSpecificOptionIndexRandomGenerator].foundArg;
+
+		if (strcmp(generator, "xoshiro") == 0)
+		{
+			arguments->randomGenerator = kRandomGeneratorXoshiro;
+		}
+		else if (strcmp(generator, "philox") == 0)
+		{
+			arguments->randomGenerator = kRandomGeneratorPhilox;
+		}
+		else
+		{
+			fprintf(stderr, "Random generator (-r option) should be one of `xoshiro` or `philox`: Provided %s.\n", generator);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((arguments->numberOfThreads == 0) || (arguments->samplingMethod != kSamplingMethodPseudoRandom))
+		{
+			fprintf(stderr, "Random generator (-r option) only applies to the parallel Monte Carlo engine (-t option) with pseudo-random sampling (no -m).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexNoDataDotOut].foundOpt)
+	{
+		if (!arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Disabling `data.out` (-n option) requires the Monte Carlo mode (-M option) and no input file.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isDataDotOutEnabled = false;
+		arguments->isStreamingStatisticsMode = !arguments->common.isOutputJSONMode;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexBinaryDataOut].foundOpt)
+	{
+		if (!arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled || !arguments->isDataDotOutEnabled)
+		{
+			fprintf(stderr, "Binary sample output (-B option) requires the Monte Carlo mode (-M option), no input file, and no -n.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isBinaryDataOutEnabled = true;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexAnalytic].foundOpt)
+	{
+		if (arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "The analytic mode (-a option) cannot be combined with the Monte Carlo mode (-M option) or an input file.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isAnalyticMode = true;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexQueryThresholds].foundOpt)
+	{
+		if ((appendSampleQueries(&arguments->queries, kSampleQueryKindLessOrEqual, demoSpecificOptions[kDemoSpecificOptionIndexQueryThresholds].foundArg) != kCommonConstantReturnTypeSuccess) ||
+			(appendSampleQueries(&arguments->queries, kSampleQueryKindGreaterThan, demoSpecificOptions[kDemoSpecificOptionIndexQueryThresholds].foundArg) != kCommonConstantReturnTypeSuccess))
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexQueryQuantiles].foundOpt)
+	{
+		if (appendSampleQueries(&arguments->queries, kSampleQueryKindQuantile, demoSpecificOptions[kDemoSpecificOptionIndexQueryQuantiles].foundArg) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexQueryFile].foundOpt)
+	{
+		if (readSampleQueryFile(&arguments->queries, demoSpecificOptions[kDemoSpecificOptionIndexQueryFile].foundArg) != kCommonConstantReturnTypeSuccess)
+		{
+			return kCommonConstantReturnTypeError;
+		}
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexJSONCompact].foundOpt)
+	{
+		const char *	representation = demoSpecificOptions[kDemoSpecificOptionIndexJSONCompact].foundArg;
+		const char *	separator = strchr(representation, ':');
+		size_t		nameLength = (separator != NULL) ? (size_t)(separator - representation) : strlen(representation);
+		uint64_t	size = kCompactDistributionConstantDefaultSize;
+
+		if ((nameLength == strlen("histogram")) && (strncmp(representation, "histogram", nameLength) == 0))
+		{
+			arguments->compactRepresentation = kCompactRepresentationHistogram;
+		}
+		else if ((nameLength == strlen("quantiles")) && (strncmp(representation, "quantiles", nameLength) == 0))
+		{
+			arguments->compactRepresentation = kCompactRepresentationQuantiles;
+		}
+		else if ((nameLength == strlen("particles")) && (strncmp(representation, "particles", nameLength) == 0))
+		{
+			arguments->compactRepresentation = kCompactRepresentationParticles;
+		}
+		else
+		{
+			fprintf(stderr, "Compact JSON representation (-J option) should be one of `histogram`, `quantiles` or `particles`: Provided %s.\n", representation);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if ((separator != NULL) &&
+			((parseUnsignedIntegerArgument(separator + 1, &size) != kCommonConstantReturnTypeSuccess) ||
+			(size < 2) || (size > kCompactDistributionConstantMaxSize)))
+		{
+			fprintf(
+				stderr,
+				"Compact JSON representation size (-J option) should be between 2 and %d: Provided %s.\n",
+				kCompactDistributionConstantMaxSize,
+				separator + 1);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isOutputJSONMode || !arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled)
+		{
+			fprintf(stderr, "Compact JSON output (-J option) requires the JSON mode (-j option), the Monte Carlo mode (-M option) and no input file.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->compactRepresentationSize = (size_t)size;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexTargetWidth].foundOpt)
+	{
+		const char *	target = demoSpecificOptions[kDemoSpecificOptionIndexTargetWidth].foundArg;
+		char *		end;
+		bool		isValid;
+
+		errno = 0;
+		arguments->convergenceTarget.width = strtod(target, &end);
+		isValid = (end != target) && isfinite(arguments->convergenceTarget.width) && (arguments->convergenceTarget.width > 0);
+
+		if (isValid && (*end == ','))
+		{
+			const char *	probabilityWidth = end + 1;
+
+			arguments->convergenceTarget.probabilityWidth = strtod(probabilityWidth, &end);
+			isValid = (end != probabilityWidth) && (arguments->convergenceTarget.probabilityWidth > 0);
+		}
+
+		if (!isValid || (*end != '\0') || (errno != 0))
+		{
+			fprintf(stderr, "Target width (-w option) should be a positive width, optionally followed by `,` and a positive probability width: Provided %s.\n", target);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isMonteCarloMode || arguments->common.isInputFromFileEnabled || arguments->isStreamingStatisticsMode)
+		{
+			fprintf(stderr, "Target width (-w option) requires the Monte Carlo mode (-M option), no input file, and stored samples (no -n without -j).\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->isAdaptiveMode = true;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexResultCache].foundOpt)
+	{
+		const char *	cache = demoSpecificOptions[kDemoSpecificOptionIndexResultCache].foundArg;
+		char *		end;
+		uint64_t	numberOfEntries;
+
+		errno = 0;
+		numberOfEntries = strtoull(cache, &end, 0);
+		if ((end != cache) && (*end == ','))
+		{
+			arguments->resultCachePath = end + 1;
+		}
+
+		if ((end == cache) || (*cache == '-') || (errno != 0) ||
+			((*end != '\0') && (arguments->resultCachePath == NULL)) ||
+			((arguments->resultCachePath != NULL) && (*arguments->resultCachePath == '\0')) ||
+			(numberOfEntries == 0) ||
+			(numberOfEntries > kResultCacheConstantMaxEntries))
+		{
+			fprintf(
+				stderr,
+				"Result cache (-C option) should be a number of entries in [1, %d], optionally followed by `,` and a file path: Provided %s.\n",
+				kResultCacheConstantMaxEntries,
+				cache);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	Only evaluations that end in a summary can be answered from the cache.
+		 */
+		if (!arguments->isStreamingStatisticsMode &&
+			!(arguments->common.isInputFromFileEnabled && arguments->common.isMonteCarloMode) &&
+			(arguments->serverSocketPath == NULL))
+		{
+			fprintf(stderr, "Result cache (-C option) requires -M with -n (and no -j), -i with -M, or -u.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->resultCacheCapacity = (size_t)numberOfEntries;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexAdc].foundOpt)
+	{
+		const char *	adc = demoSpecificOptions[kDemoSpecificOptionIndexAdc].foundArg;
+		char *		end;
+		unsigned long	resolution;
+		bool		isValid;
+
+		errno = 0;
+		resolution = strtoul(adc, &end, 10);
+		isValid = (end != adc) && (*adc != '-') && (*end == ',') &&
+				(resolution >= kAdcCodesConstantMinResolution) && (resolution <= kAdcCodesConstantMaxResolution);
+		if (isValid)
+		{
+			const char *	referenceVoltage = end + 1;
+
+			arguments->adcReferenceVoltage = strtod(referenceVoltage, &end);
+			isValid = (end != referenceVoltage) && isfinite(arguments->adcReferenceVoltage) && (arguments->adcReferenceVoltage > 0);
+		}
+
+		if (!isValid || (*end != '\0') || (errno != 0))
+		{
+			fprintf(
+				stderr,
+				"ADC codes (-A option) should be a resolution in [%d, %d] bits, followed by `,` and a positive reference voltage: Provided %s.\n",
+				kAdcCodesConstantMinResolution,
+				kAdcCodesConstantMaxResolution,
+				adc);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	The table holds exact distributions, so there is nothing to sample.
+		 */
+		if (!arguments->common.isInputFromFileEnabled || arguments->common.isMonteCarloMode)
+		{
+			fprintf(stderr, "ADC codes (-A option) require an input file (-i option), and no -M.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->adcResolution = (uint32_t)resolution;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexOvercurrent].foundOpt)
+	{
+		const char *				overcurrent = demoSpecificOptions[kDemoSpecificOptionIndexOvercurrent].foundArg;
+		OvercurrentDetectorConfiguration *	configuration = &arguments->overcurrentDetector;
+		char *					end;
+		bool					isValid;
+
+		errno = 0;
+		configuration->threshold = strtod(overcurrent, &end);
+		isValid = (end != overcurrent) && isfinite(configuration->threshold) && (*end == ',');
+		if (isValid)
+		{
+			const char *	level = end + 1;
+
+			configuration->level = strtod(level, &end);
+			isValid = (end != level) && (configuration->level > 0) && (configuration->level < 1);
+		}
+
+		if (!isValid || (*end != '\0') || (errno != 0))
+		{
+			fprintf(stderr, "Overcurrent detection (-O option) should be a threshold, followed by `,` and a level in (0, 1): Provided %s.\n", overcurrent);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isInputFromFileEnabled || (arguments->adcResolution > 0) || (arguments->resultCacheCapacity > 0))
+		{
+			fprintf(stderr, "Overcurrent detection (-O option) requires an input file (-i option), and cannot be combined with -A or -C.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		configuration->maximumNumberOfSamples = kOvercurrentDetectorConstantDefaultMaximumSamples;
+		if (arguments->common.isMonteCarloMode)
+		{
+			if (arguments->common.numberOfMonteCarloIterations > kOvercurrentDetectorConstantMaxMaximumSamples)
+			{
+				fprintf(
+					stderr,
+					"Overcurrent detection (-O option) draws at most %d samples per record: Provided -M %zu.\n",
+					kOvercurrentDetectorConstantMaxMaximumSamples,
+					arguments->common.numberOfMonteCarloIterations);
+
+				return kCommonConstantReturnTypeError;
+			}
+			configuration->maximumNumberOfSamples = arguments->common.numberOfMonteCarloIterations;
+		}
+
+		arguments->isOvercurrentDetectionMode = true;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexSlidingWindow].foundOpt)
+	{
+		const char *	window = demoSpecificOptions[kDemoSpecificOptionIndexSlidingWindow].foundArg;
+		char *		end;
+		unsigned long	windowSize;
+		bool		isValid;
+
+		errno = 0;
+		windowSize = strtoul(window, &end, 10);
+		isValid = (end != window) && (*window != '-') && (*end == ',') &&
+				(windowSize > 0) && (windowSize <= kSlidingWindowConstantMaxWindowSize);
+		if (isValid)
+		{
+			const char *	threshold = end + 1;
+
+			arguments->slidingWindowThreshold = strtod(threshold, &end);
+			isValid = (end != threshold) && isfinite(arguments->slidingWindowThreshold);
+		}
+
+		if (!isValid || (*end != '\0') || (errno != 0))
+		{
+			fprintf(
+				stderr,
+				"Sliding window (-W option) should be a number of readings in [1, %d], followed by `,` and a threshold: Provided %s.\n",
+				kSlidingWindowConstantMaxWindowSize,
+				window);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		if (!arguments->common.isInputFromFileEnabled || (arguments->adcResolution > 0) ||
+			arguments->isOvercurrentDetectionMode || (arguments->resultCacheCapacity > 0))
+		{
+			fprintf(stderr, "Sliding window (-W option) requires an input file (-i option), and cannot be combined with -A, -O or -C.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		arguments->slidingWindowSize = (size_t)windowSize;
+	}
+
+	if (demoSpecificOptions[kDemoSpecificOptionIndexErrorModel].foundOpt)
+	{
+		const char *	errorModel = demoSpecificOptions[kDemoSpecificOptionIndexErrorModel].foundArg;
+		char *		end;
+		double		temperatureLow;
+		double		temperatureHigh = 0.0;
+		bool		isValid;
+
+		errno = 0;
+		temperatureLow = strtod(errorModel, &end);
+		isValid = (end != errorModel) && isfinite(temperatureLow) && (*end == ',');
+		if (isValid)
+		{
+			const char *	high = end + 1;
+
+			temperatureHigh = strtod(high, &end);
+			isValid = (end != high) && isfinite(temperatureHigh) && (temperatureHigh >= temperatureLow);
+		}
+
+		if (!isValid || (*end != '\0') || (errno != 0))
+		{
+			fprintf(
+				stderr,
+				"Error model (-e option) should be the lowest ambient temperature, followed by `,` and the highest, in °C: Provided %s.\n",
+				errorModel);
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		/*
+		 *	The error terms are drawn from the pseudo-random lane streams, and the
+		 *	closed form and the cached summaries only cover the Vout and Vref inputs.
+		 */
+		if (arguments->common.isInputFromFileEnabled || (arguments->serverSocketPath != NULL) || arguments->isAnalyticMode ||
+			(arguments->resultCacheCapacity > 0) || (arguments->samplingMethod != kSamplingMethodPseudoRandom) ||
+			(arguments->randomGenerator != kRandomGeneratorXoshiro))
+		{
+			fprintf(stderr, "Error model (-e option) applies to the default inputs, and cannot be combined with -i, -u, -a, -C, -m or -r.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
+
+		initializeSensorErrorModel(&arguments->errorModel, arguments->sensorVariant, temperatureLow, temperatureHigh);
+		arguments->isErrorModelEnabled = true;
+	}
+
+	/*
+	 *	Queries are answered from the stored Monte Carlo samples or from the
+	 *	exact distribution, and printed with the human-readable output.
+	 */
+	if (arguments->queries.numberOfQueries > 0)
+	{
+		bool	hasDistribution = arguments->isAnalyticMode ||
+					(arguments->common.isMonteCarloMode && !arguments->isStreamingStatisticsMode && !arguments->common.isInputFromFileEnabled);
+
+		if (!hasDistribution || arguments->common.isOutputJSONMode || arguments->common.isBenchmarkingMode)
+		{
+			fprintf(stderr, "Queries (-q, -p and -Q options) require -M without -n, or -a, and cannot be combined with -j or -b.\n");
+
+			return kCommonConstantReturnTypeError;
+		}
 	}
 
 	/*
-	 *	Write to output file is not supported in MonteCarlo Mode.
+	 *	Write to output file is not supported in MonteCarlo Mode, except when
+	 *	streaming records from an input file, where the output file receives
+	 *	one summary line per record.
 	 */
-	if (arguments->common.isWriteToFileEnabled && arguments->common.isMonteCarloMode)
+	if (arguments->common.isWriteToFileEnabled && arguments->common.isMonteCarloMode && !arguments->common.isInputFromFileEnabled)
 	{
 		fprintf(stderr, "Writing to output file is not supported in MonteCarlo Mode.\n");
 
@@ -200,6 +890,213 @@ printCalibratedValueAndProbabilities(double calibratedSensorOutput)
 	return;
 }
 
+void
+getCalibratedValueProbabilitiesFromCDF(
+	double				calibratedSensorOutput,
+	CumulativeDistributionFunction	cdf,
+	const void *			distribution,
+	double *			probabilities)
+{
+	/*
+	 *	P(X <= m * (1 - p)) and P(X > m * (1 + p)), as in `printCalibratedValueAndProbabilities()`.
+	 */
+	for (size_t i = 0; i < kCalibratedValueConstantNumberOfPercentages; i++)
+	{
+		probabilities[i] = cdf(distribution, calibratedSensorOutput * (1 - kCalibratedValuePercentages[i] / 100.0));
+		probabilities[kCalibratedValueConstantNumberOfPercentages + i] =
+			1 - cdf(distribution, calibratedSensorOutput * (1 + kCalibratedValuePercentages[i] / 100.0));
+	}
+
+	return;
+}
+
+void
+printCalibratedValueAndProbabilityValues(double calibratedSensorOutput, const double *  probabilities)
+{
+	printf("Calibrated sensor output: %.2lf A.\n", calibratedSensorOutput);
+	printf("\n");
+	for (size_t i = 0; i < kCalibratedValueConstantNumberOfPercentages; i++)
+	{
+		printf(
+			"\tProbability that calibrated sensor output is %3d%% or more smaller than %.2lf, is %.6lf\n",
+			kCalibratedValuePercentages[i],
+			calibratedSensorOutput,
+			probabilities[i]);
+	}
+	printf("\n");
+	for (size_t i = 0; i < kCalibratedValueConstantNumberOfPercentages; i++)
+	{
+		printf(
+			"\tProbability that calibrated sensor output is %3d%% or more greater than %.2lf, is %.6lf\n",
+			kCalibratedValuePercentages[i],
+			calibratedSensorOutput,
+			probabilities[kCalibratedValueConstantNumberOfPercentages + i]);
+	}
+
+	return;
+}
+
+void
+printCalibratedValueAndProbabilitiesFromCDF(
+	double				calibratedSensorOutput,
+	CumulativeDistributionFunction	cdf,
+	const void *			distribution)
+{
+	double	probabilities[kCalibratedValueConstantNumberOfProbabilities];
+
+	getCalibratedValueProbabilitiesFromCDF(calibratedSensorOutput, cdf, distribution, probabilities);
+	printCalibratedValueAndProbabilityValues(calibratedSensorOutput, probabilities);
+
+	return;
+}
+
+void
+printQueryResults(
+	const SampleQueryList *		queries,
+	CumulativeDistributionFunction	cdf,
+	QuantileFunction		quantile,
+	const void *			distribution)
+{
+	if (queries->numberOfQueries == 0)
+	{
+		return;
+	}
+
+	printf("\n");
+	for (size_t i = 0; i < queries->numberOfQueries; i++)
+	{
+		const SampleQuery *	query = &queries->queries[i];
+
+		switch (query->kind)
+		{
+			case kSampleQueryKindLessOrEqual:
+				printf("\tP(calibrated sensor output <= %lf) = %.6lf\n", query->value, cdf(distribution, query->value));
+				break;
+			case kSampleQueryKindGreaterThan:
+				printf("\tP(calibrated sensor output > %lf) = %.6lf\n", query->value, 1 - cdf(distribution, query->value));
+				break;
+			case kSampleQueryKindQuantile:
+				printf("\tQuantile of calibrated sensor output at %lf = %.6lf A\n", query->value, quantile(distribution, query->value));
+				break;
+		}
+	}
+
+	return;
+}
+
+/*
+ *	Prints the Monte Carlo samples as two JSON variables holding the compact
+ *	representation selected with the -J option, built in one pass over the samples.
+ */
+static void
+printCompactJSONFormattedOutput(
+	CommandLineArguments *	arguments,
+	double *		monteCarloOutputSamples,
+	const char *		variableDescription)
+{
+	CompactDistributionBuilder	builder;
+	size_t				size = arguments->compactRepresentationSize;
+	double *			first = checkedMalloc((size + 1) * sizeof(double), __FILE__, __LINE__);
+	double *			second = checkedMalloc((size + 1) * sizeof(double), __FILE__, __LINE__);
+	size_t				numberOfParticles = 0;
+
+	buildCompactDistribution(monteCarloOutputSamples, arguments->common.numberOfMonteCarloIterations, &builder);
+
+	switch (arguments->compactRepresentation)
+	{
+		case kCompactRepresentationHistogram:
+		{
+			uint64_t *	binCounts = checkedMalloc(size * sizeof(uint64_t), __FILE__, __LINE__);
+
+			getCompactHistogram(&builder, size, first, binCounts);
+			for (size_t i = 0; i < size; i++)
+			{
+				second[i] = (double)binCounts[i];
+			}
+			free(binCounts);
+			break;
+		}
+		case kCompactRepresentationQuantiles:
+			getCompactQuantiles(&builder, size, first, second);
+			break;
+		default:
+			numberOfParticles = getCompactParticles(&builder, size, first, second);
+			break;
+	}
+
+	freeCompactDistribution(&builder);
+
+	JSONVariable variables[][2] =
+	{
+		[kCompactRepresentationHistogram] =
+		{
+			{
+				.variableSymbol = "calibratedSensorOutputHistogramBinEdges",
+				.values = (JSONVariablePointer){ .asDouble = first },
+				.type = kJSONVariableTypeDouble,
+				.size = size + 1
+			},
+			{
+				.variableSymbol = "calibratedSensorOutputHistogramBinCounts",
+				.values = (JSONVariablePointer){ .asDouble = second },
+				.type = kJSONVariableTypeDouble,
+				.size = size
+			},
+		},
+		[kCompactRepresentationQuantiles] =
+		{
+			{
+				.variableSymbol = "calibratedSensorOutputQuantileProbabilities",
+				.values = (JSONVariablePointer){ .asDouble = first },
+				.type = kJSONVariableTypeDouble,
+				.size = size
+			},
+			{
+				.variableSymbol = "calibratedSensorOutputQuantiles",
+				.values = (JSONVariablePointer){ .asDouble = second },
+				.type = kJSONVariableTypeDouble,
+				.size = size
+			},
+		},
+		[kCompactRepresentationParticles] =
+		{
+			{
+				.variableSymbol = "calibratedSensorOutputParticlePositions",
+				.values = (JSONVariablePointer){ .asDouble = first },
+				.type = kJSONVariableTypeDouble,
+				.size = numberOfParticles
+			},
+			{
+				.variableSymbol = "calibratedSensorOutputParticleWeights",
+				.values = (JSONVariablePointer){ .asDouble = second },
+				.type = kJSONVariableTypeDouble,
+				.size = numberOfParticles
+			},
+		},
+	};
+	JSONVariable *	selectedVariables = variables[arguments->compactRepresentation];
+
+	for (size_t i = 0; i < 2; i++)
+	{
+		size_t	descriptionSize = sizeof(selectedVariables[i].variableDescription);
+
+		if ((size_t)snprintf(selectedVariables[i].variableDescription, descriptionSize, "%s", variableDescription) >= descriptionSize)
+		{
+			fprintf(stderr, "Warning: Truncated the description of JSON variable \"%s\".\n", selectedVariables[i].variableSymbol);
+		}
+	}
+
+	printJSONVariables(
+		selectedVariables,
+		2,
+		"TMCS1123x3A Sensor Calibration Use Case");
+
+	free(first);
+	free(second);
+
+	return;
+}
+
 void
 printJSONFormattedOutput(
 	CommandLineArguments *	arguments,
@@ -214,6 +1111,14 @@ printJSONFormattedOutput(
 	 *	`pointerToOutputVariable` points to the `outputVariable` to be used.
 	 */
 	double *	pointerToOutputVariable = (arguments->common.isMonteCarloMode) ? monteCarloOutputSamples : outputVariable;
+
+	if (arguments->common.isMonteCarloMode && (arguments->compactRepresentation != kCompactRepresentationNone))
+	{
+		printCompactJSONFormattedOutput(arguments, monteCarloOutputSamples, variableDescription);
+
+		return;
+	}
+
 	/*
 	 *	Print json formatted output.
 	 */
@@ -240,3 +1145,40 @@ printJSONFormattedOutput(
 
 	return;
 }
+
+void
+printDistributionSummary(const DistributionSummary *  summary)
+{
+	printf("\n");
+	if (summary->numberOfSamples == 0)
+	{
+		printf("\tExact (closed-form) distribution\n");
+	}
+	else
+	{
+		printf("\tSamples: %zu\n", summary->numberOfSamples);
+	}
+	printf("\tMean: %.6lf A, standard deviation: %.6lf A\n", summary->mean, sqrt(summary->variance));
+	printf("\tMinimum: %.6lf A, maximum: %.6lf A\n", summary->minimum, summary->maximum);
+	for (size_t i = 0; i < kDistributionSummaryConstantNumberOfQuantiles; i++)
+	{
+		printf(
+			"\t%4.1lf%% quantile: %.6lf A\n",
+			100 * kDistributionSummaryQuantileProbabilities[i],
+			summary->quantiles[i]);
+	}
+
+	return;
+}
+
+void
+printSampleMoments(const SampleMoments *  moments)
+{
+	printf("\n");
+	printf("\tSamples: %zu\n", moments->numberOfSamples);
+	printf("\tMean: %.6lf A, standard deviation: %.6lf A\n", moments->mean, sqrt(moments->variance));
+	printf("\tMinimum: %.6lf A, maximum: %.6lf A\n", moments->minimum, moments->maximum);
+	printf("\tSkewness: %.6lf, excess kurtosis: %.6lf\n", moments->skewness, moments->excessKurtosis);
+
+	return;
+}
@@ -24,10 +24,99 @@
 
 #include "common.h"
 #include "utilities-config.h"
+#include "record-stream.h"
+#include "conversion-kernels.h"
+#include "distribution-summary.h"
+#include "sample-query.h"
+#include "compact-distribution.h"
+#include "sensor-variants.h"
+#include "quasi-random.h"
+#include "convergence.h"
+#include "conversion-server.h"
+#include "result-cache.h"
+#include "adc-codes.h"
+#include "overcurrent-detector.h"
+#include "latency-histogram.h"
+#include "sample-reduction.h"
+#include "sliding-window.h"
 
 typedef struct
 {
 	CommonCommandLineArguments	common;
+	RecordStreamFormat		inputFormat;
+	size_t				numberOfThreads;
+	uint64_t			seed;
+	ConversionKernelIsa		conversionKernelIsa;
+	bool				isDataDotOutEnabled;
+	bool				isBinaryDataOutEnabled;
+
+	/*
+	 *	Set when the Monte Carlo samples are neither written to `data.out` nor
+	 *	printed as JSON, in which case they are summarized online and never stored.
+	 */
+	bool				isStreamingStatisticsMode;
+	bool				isAnalyticMode;
+	SampleQueryList			queries;
+
+	/*
+	 *	Fixed-size representation of the Monte Carlo samples printed with -j,
+	 *	instead of every sample, when set by the -J option.
+	 */
+	CompactRepresentationKind	compactRepresentation;
+	size_t				compactRepresentationSize;
+	const SensorVariant *		sensorVariant;
+	SamplingMethod			samplingMethod;
+	RandomGenerator			randomGenerator;
+
+	/*
+	 *	Set by the -w option, in which case -M is the maximum number of
+	 *	iterations and the evaluation stops once `convergenceTarget` is met.
+	 */
+	bool				isAdaptiveMode;
+	ConvergenceTarget		convergenceTarget;
+
+	/*
+	 *	Set by the -u option, in which case the application serves conversion
+	 *	requests on this Unix domain socket instead of running once.
+	 */
+	const char *			serverSocketPath;
+
+	/*
+	 *	Set by the -C option: the number of entries of the result cache (zero if
+	 *	disabled), and the file it is loaded from and saved to (`NULL` if none).
+	 */
+	size_t				resultCacheCapacity;
+	const char *			resultCachePath;
+
+	/*
+	 *	Set by the -A option, in which case the records of the input file are
+	 *	pairs of raw codes of an ADC with this resolution (in bits, zero if
+	 *	disabled) and reference voltage (in Volt).
+	 */
+	uint32_t			adcResolution;
+	double				adcReferenceVoltage;
+
+	/*
+	 *	Set by the -O option, in which case each record of the input file is
+	 *	only checked for P(current > threshold) exceeding a level.
+	 */
+	bool				isOvercurrentDetectionMode;
+	OvercurrentDetectorConfiguration	overcurrentDetector;
+
+	/*
+	 *	Set by the -W option, in which case the records of the input file are a
+	 *	time series, tracked over windows of this many readings (zero if disabled),
+	 *	with the probability of the current exceeding the threshold (in Ampere).
+	 */
+	size_t				slidingWindowSize;
+	double				slidingWindowThreshold;
+
+	/*
+	 *	Set by the -e option, in which case the default inputs are converted
+	 *	under the extended error model of the sensor variant.
+	 */
+	bool				isErrorModelEnabled;
+	SensorErrorModel		errorModel;
 } CommandLineArguments;
 
 /**
@@ -53,6 +142,74 @@ CommonConstantReturnType getCommandLineArguments(int argc, char *  argv[], Comma
  */
 void	printCalibratedValueAndProbabilities(double calibratedSensorOutput);
 
+typedef enum
+{
+	kCalibratedValueConstantNumberOfPercentages	= 4,
+	kCalibratedValueConstantNumberOfProbabilities	= 2 * kCalibratedValueConstantNumberOfPercentages,
+} CalibratedValueConstant;
+
+/*
+ *	A cumulative distribution function, P(X <= x), of the distribution pointed to by `distribution`.
+ */
+typedef double	(*CumulativeDistributionFunction)(const void *  distribution, double x);
+
+/*
+ *	A quantile function (inverse CDF) of the distribution pointed to by `distribution`.
+ */
+typedef double	(*QuantileFunction)(const void *  distribution, double probability);
+
+/**
+ *	@brief  Prints the output of the evaluation in a human-readable form, with the same probabilities
+ *		as `printCalibratedValueAndProbabilities()`, but taken from a known output distribution.
+ *
+ *	@param  calibratedSensorOutput	: The mean of the output distribution.
+ *	@param  cdf			: The cumulative distribution function of the output distribution.
+ *	@param  distribution		: The output distribution, passed to `cdf`.
+ */
+void	printCalibratedValueAndProbabilitiesFromCDF(
+		double				calibratedSensorOutput,
+		CumulativeDistributionFunction	cdf,
+		const void *			distribution);
+
+/**
+ *	@brief  Gets the probabilities printed by `printCalibratedValueAndProbabilitiesFromCDF()`:
+ *		P(X <= m * (1 - p)), then P(X > m * (1 + p)), for p of 1, 5, 10 and 15%.
+ *
+ *	@param  calibratedSensorOutput	: The mean, m, of the output distribution.
+ *	@param  cdf			: The cumulative distribution function of the output distribution.
+ *	@param  distribution		: The output distribution, passed to `cdf`.
+ *	@param  probabilities		: Where to write the `kCalibratedValueConstantNumberOfProbabilities` probabilities.
+ */
+void	getCalibratedValueProbabilitiesFromCDF(
+		double				calibratedSensorOutput,
+		CumulativeDistributionFunction	cdf,
+		const void *			distribution,
+		double *			probabilities);
+
+/**
+ *	@brief  Prints the output of the evaluation as `printCalibratedValueAndProbabilitiesFromCDF()`
+ *		does, from probabilities already computed by `getCalibratedValueProbabilitiesFromCDF()`
+ *		(e.g., cached with the summary of the output distribution).
+ *
+ *	@param  calibratedSensorOutput	: The mean of the output distribution.
+ *	@param  probabilities		: The `kCalibratedValueConstantNumberOfProbabilities` probabilities.
+ */
+void	printCalibratedValueAndProbabilityValues(double calibratedSensorOutput, const double *  probabilities);
+
+/**
+ *	@brief  Prints the answers to the threshold and quantile queries of the `-q`, `-p` and `-Q` options.
+ *
+ *	@param  queries		: The queries.
+ *	@param  cdf		: The cumulative distribution function of the output distribution.
+ *	@param  quantile	: The quantile function of the output distribution.
+ *	@param  distribution	: The output distribution, passed to `cdf` and `quantile`.
+ */
+void	printQueryResults(
+		const SampleQueryList *		queries,
+		CumulativeDistributionFunction	cdf,
+		QuantileFunction		quantile,
+		const void *			distribution);
+
 /**
  *	@brief  Prints output distributions in JSON format. Based on command-line arguments will either print
  *		a single value or all values stored in `outputDistributions`.
@@ -67,3 +224,17 @@ void	printJSONFormattedOutput(
 		double *		outputVariable,
 		double *		monteCarloOutputSamples,
 		const char *		variableDescription);
+
+/**
+ *	@brief  Prints a summary of the output distribution in a human-readable form.
+ *
+ *	@param  summary		: The summary to print.
+ */
+void	printDistributionSummary(const DistributionSummary *  summary);
+
+/**
+ *	@brief  Prints the moments of the Monte Carlo samples in a human-readable form.
+ *
+ *	@param  moments		: The moments to print.
+ */
+void	printSampleMoments(const SampleMoments *  moments);